@@ -0,0 +1,210 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Adaptive Rate Implementation
+ *
+ * Per channel, the reference is the value at the last detected change,
+ * not the previous frame, so a slow drift still counts once it adds up to
+ * delta_mv. Parameters are shared with the shell under a spinlock; the
+ * state machine itself only runs on the processing stage, which also
+ * re-applies the fast period after every reconfiguration.
+ */
+
+#include "adaptive_rate.h"
+#include "sample_sched.h"
+#include "threshold.h"
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/logging/log.h>
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE_PM)
+#include <zephyr/pm/policy.h>
+#endif
+
+LOG_MODULE_REGISTER(adaptive_rate, LOG_LEVEL_INF);
+
+static struct adaptive_rate_config config;
+static struct k_spinlock config_lock;
+
+/* Serialises adaptive_rate_configure() callers up to the period change */
+static K_MUTEX_DEFINE(configure_lock);
+
+/* Set by adaptive_rate_configure(), consumed by the processing stage */
+static bool restart;
+
+/* Processing-stage state */
+static bool fast;
+static bool primed;
+static uint32_t quiet_frames;
+static int32_t reference_mv[NUM_CH];
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE_PM)
+/* Low-power states whose exit latency the fast rate cannot afford */
+static const enum pm_state fast_locked_states[] = {
+    PM_STATE_SUSPEND_TO_IDLE,
+    PM_STATE_STANDBY,
+    PM_STATE_SUSPEND_TO_RAM,
+};
+static bool pm_locked;
+
+static void pm_lock_set(bool lock)
+{
+    if (lock == pm_locked) {
+        return;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(fast_locked_states); i++) {
+        if (lock) {
+            pm_policy_state_lock_get(fast_locked_states[i], PM_ALL_SUBSTATES);
+        } else {
+            pm_policy_state_lock_put(fast_locked_states[i], PM_ALL_SUBSTATES);
+        }
+    }
+    pm_locked = lock;
+}
+#else
+static inline void pm_lock_set(bool lock)
+{
+    ARG_UNUSED(lock);
+}
+#endif
+
+static void set_fast(const struct adaptive_rate_config *cfg, bool to_fast)
+{
+    int ret = sample_sched_set_period(to_fast ? cfg->fast_us : cfg->slow_us);
+
+    if (ret < 0) {
+        LOG_ERR("Period change failed: %d", ret);
+        return;
+    }
+
+    fast = to_fast;
+    quiet_frames = 0;
+    pm_lock_set(to_fast && cfg->enabled);
+}
+
+static bool config_valid(const struct adaptive_rate_config *cfg)
+{
+    return cfg->fast_us >= SAMPLE_SCHED_MIN_PERIOD_US &&
+           cfg->slow_us <= SAMPLE_SCHED_MAX_PERIOD_US && cfg->slow_us >= cfg->fast_us;
+}
+
+void adaptive_rate_init(void)
+{
+    struct adaptive_rate_config cfg = {
+        .enabled = true,
+        .fast_us = CONFIG_APP_SAMPLE_PERIOD_MS * USEC_PER_MSEC,
+        .slow_us = CONFIG_APP_ADAPTIVE_SLOW_PERIOD_MS * USEC_PER_MSEC,
+        .delta_mv = CONFIG_APP_ADAPTIVE_DELTA_MV,
+        .hold_frames = CONFIG_APP_ADAPTIVE_HOLD_FRAMES,
+    };
+
+    if (!config_valid(&cfg)) {
+        LOG_WRN("Slow period below the fast period; adaptive rate disabled");
+        cfg.enabled = false;
+        cfg.slow_us = cfg.fast_us;
+    }
+
+    /* The scheduler is not running yet; the first frame applies fast_us */
+    config = cfg;
+    restart = true;
+}
+
+int adaptive_rate_configure(const struct adaptive_rate_config *cfg)
+{
+    k_spinlock_key_t key;
+    int ret;
+
+    if (!config_valid(cfg)) {
+        return -EINVAL;
+    }
+
+    /*
+     * Two callers must not store in one order and set the period in the
+     * other. The processing stage may still switch with the old
+     * parameters in between; restart makes it re-apply fast_us.
+     */
+    k_mutex_lock(&configure_lock, K_FOREVER);
+
+    key = k_spin_lock(&config_lock);
+    config = *cfg;
+    restart = true;
+    k_spin_unlock(&config_lock, key);
+
+    /* Apply the fast period now rather than after a slow period */
+    ret = sample_sched_set_period(cfg->fast_us);
+
+    k_mutex_unlock(&configure_lock);
+
+    return ret;
+}
+
+void adaptive_rate_get(struct adaptive_rate_config *cfg)
+{
+    k_spinlock_key_t key = k_spin_lock(&config_lock);
+
+    *cfg = config;
+    k_spin_unlock(&config_lock, key);
+}
+
+bool adaptive_rate_is_fast(void)
+{
+    return fast;
+}
+
+/* True if any channel moved delta_mv away from its reference */
+static bool frame_changed(const struct adc_regs *frame, uint16_t delta_mv)
+{
+    bool changed = false;
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        int32_t mv = regs_raw_to_mv(ch, frame->raw[ch]);
+
+        if (!primed || abs(mv - reference_mv[ch]) >= delta_mv) {
+            reference_mv[ch] = mv;
+            changed = true;
+        }
+    }
+    primed = true;
+
+    return changed;
+}
+
+void adaptive_rate_update(const struct adc_regs *frame)
+{
+    struct adaptive_rate_config cfg;
+    k_spinlock_key_t key = k_spin_lock(&config_lock);
+    bool restarted = restart;
+    bool active;
+
+    cfg = config;
+    restart = false;
+    k_spin_unlock(&config_lock, key);
+
+    if (restarted) {
+        /* A slow switch may have raced adaptive_rate_configure() */
+        primed = false;
+        set_fast(&cfg, true);
+    }
+
+    if (!cfg.enabled) {
+        return;
+    }
+
+    active = frame_changed(frame, cfg.delta_mv);
+#if defined(CONFIG_APP_THRESHOLDS)
+    active = active || (threshold_alarms() != 0);
+#endif
+
+    if (active) {
+        if (!fast) {
+            LOG_DBG("Activity: fast rate (%u us)", cfg.fast_us);
+            set_fast(&cfg, true);
+        }
+        quiet_frames = 0;
+    } else if (fast && ++quiet_frames >= cfg.hold_frames) {
+        LOG_DBG("Steady: slow rate (%u us)", cfg.slow_us);
+        set_fast(&cfg, false);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Adaptive Rate - Slow sampling in steady state, fast during events
+ *
+ * Watches every published frame from the processing stage. While no
+ * channel has moved by delta_mv from its reference value and no threshold
+ * alarm is active for hold_frames frames, the scheduler runs at slow_us;
+ * any such activity switches it back to fast_us at once. With
+ * CONFIG_APP_ADAPTIVE_RATE_PM the fast rate also holds off the SoC's
+ * low-power states, so the idle thread only enters them at the slow rate.
+ */
+
+#ifndef ADAPTIVE_RATE_H_
+#define ADAPTIVE_RATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "regs.h"
+
+/**
+ * @brief Adaptive rate parameters
+ */
+struct adaptive_rate_config {
+    bool enabled;          /* false: the scheduler period is left alone */
+    uint32_t fast_us;      /* Period during activity */
+    uint32_t slow_us;      /* Period in steady state */
+    uint16_t delta_mv;     /* Change from the reference that counts as activity */
+    uint16_t hold_frames;  /* Quiet frames at the fast rate before backing off */
+};
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+
+/**
+ * @brief Load the Kconfig parameters and start at the fast rate
+ *
+ * Called from sample_proc_init(), before the processing and sampling
+ * threads start. The scheduler period is set from the first processed
+ * frame.
+ */
+void adaptive_rate_init(void);
+
+/**
+ * @brief Replace the parameters
+ *
+ * Callable from any thread; restarts at the fast rate. When disabling,
+ * the scheduler stays at fast_us.
+ *
+ * @param cfg New parameters
+ * @return 0 on success, -EINVAL if a period is out of the scheduler's
+ *         range or slow_us < fast_us
+ */
+int adaptive_rate_configure(const struct adaptive_rate_config *cfg);
+
+/**
+ * @brief Get the current parameters
+ *
+ * @param cfg Receives the parameters
+ */
+void adaptive_rate_get(struct adaptive_rate_config *cfg);
+
+/**
+ * @brief Check whether the fast rate is active
+ *
+ * @return true at the fast rate (or when disabled)
+ */
+bool adaptive_rate_is_fast(void);
+
+/**
+ * @brief Feed a published frame
+ *
+ * Processing stage only (sample_proc.h). Threshold evaluation of the
+ * frame has already happened in the sampling thread.
+ *
+ * @param frame Frame just published
+ */
+void adaptive_rate_update(const struct adc_regs *frame);
+
+#else
+
+static inline void adaptive_rate_init(void) {}
+static inline void adaptive_rate_update(const struct adc_regs *frame) {}
+
+#endif /* CONFIG_APP_ADAPTIVE_RATE */
+
+#endif /* ADAPTIVE_RATE_H_ */
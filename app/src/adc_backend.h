@@ -10,27 +10,118 @@
 #ifndef ADC_BACKEND_H_
 #define ADC_BACKEND_H_
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <zephyr/sys/util.h>
 #include "regs.h"  /* For NUM_CH */
 
+/** Channel mask selecting every channel */
+#define ADC_BACKEND_ALL_CHANNELS BIT_MASK(NUM_CH)
+
+/** Keep each channel's build-time setting in adc_backend_configure() */
+#define ADC_BACKEND_DEFAULT UINT8_MAX
+
 /**
  * @brief Initialize the ADC backend
  *
- * Must be called once during startup before any sampling.
+ * Must be called once during startup, after regs_init() and before any
+ * sampling.
  *
  * @return 0 on success, negative errno on failure
  */
 int adc_backend_init(void);
 
 /**
- * @brief Sample all ADC channels
+ * @brief Sample a subset of ADC channels
+ *
+ * Converts only the channels in @p ch_mask and writes their raw codes;
+ * the other entries of @p out_raw are left untouched, so a caller that
+ * keeps the array across frames holds each channel's last value. No unit
+ * conversion happens on the sampling path; the backend registers each
+ * channel's scale with regs_set_scale() during init.
+ *
+ * @param ch_mask Channels to sample, bit n for channel n
+ * @param out_raw Array of NUM_CH to receive raw codes
+ * @return 0 on success, negative errno on failure
+ */
+int adc_backend_sample(uint32_t ch_mask, uint16_t out_raw[NUM_CH]);
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/**
+ * @brief Get the conversion times of the latest adc_backend_sample()
+ *
+ * Taken with regs_clock_ns() around each adc_read(): exact to the call
+ * with one read per channel; in scan modes, where the driver reports only
+ * a scan's completion, interpolated by the channel's rank in the scan.
+ *
+ * @param start_ns  Frame start the offsets are relative to
+ * @param offset_ns Receives NUM_CH offsets from @p start_ns; 0 for
+ *                  channels not converted since then
+ */
+void adc_backend_channel_offsets(uint64_t start_ns, uint32_t offset_ns[NUM_CH]);
+#endif
+
+/**
+ * @brief Check sequence settings without applying them
+ *
+ * Callable from any thread.
+ *
+ * @param resolution   Bits for every channel, or ADC_BACKEND_DEFAULT
+ * @param oversampling log2 of the hardware oversampling ratio for every
+ *                     channel, or ADC_BACKEND_DEFAULT
+ * @return 0 if every converter supports them, -ENOTSUP otherwise
+ */
+int adc_backend_config_check(uint8_t resolution, uint8_t oversampling);
+
+/**
+ * @brief Override resolution and oversampling of every channel
+ *
+ * Rebuilds the precomputed sequences and re-registers each channel's
+ * scale with regs_set_scale(), once; frames after it reuse the result.
+ * Sampling thread only, between two adc_backend_sample() calls.
  *
- * Reads all configured channels and returns values in millivolts.
+ * @param resolution   Bits for every channel, or ADC_BACKEND_DEFAULT
+ * @param oversampling log2 oversampling ratio, or ADC_BACKEND_DEFAULT
+ * @return 0 on success, -ENOTSUP as adc_backend_config_check()
+ */
+int adc_backend_configure(uint8_t resolution, uint8_t oversampling);
+
+/**
+ * @brief Per-conversion callback of adc_backend_burst()
+ *
+ * May run in interrupt context.
+ *
+ * @param raw       Raw code just converted
+ * @param user_data Pointer given to adc_backend_burst()
+ * @return true to convert again, false to end the burst
+ */
+typedef bool (*adc_backend_burst_cb)(uint16_t raw, void *user_data);
+
+/**
+ * @brief Convert one channel back to back until the callback stops it
+ *
+ * Each conversion is restarted as soon as the previous one completes,
+ * at the channel's current resolution and oversampling. Blocks the
+ * caller for the whole burst; sampling thread only, between two
+ * adc_backend_sample() calls.
+ *
+ * @param ch        Channel number (0 to NUM_CH-1)
+ * @param cb        Called with every code
+ * @param user_data Passed to @p cb
+ * @return 0 when @p cb ended the burst, negative errno on failure
+ */
+int adc_backend_burst(unsigned int ch, adc_backend_burst_cb cb, void *user_data);
+
+/**
+ * @brief Sample all ADC channels
  *
- * @param out_mv Array of NUM_CH to receive millivolt values
+ * @param out_raw Array of NUM_CH to receive raw codes
  * @return 0 on success, negative errno on failure
  */
-int adc_backend_sample_all(int32_t out_mv[NUM_CH]);
+static inline int adc_backend_sample_all(uint16_t out_raw[NUM_CH])
+{
+    return adc_backend_sample(ADC_BACKEND_ALL_CHANNELS, out_raw);
+}
 
 #endif /* ADC_BACKEND_H_ */
 
@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Burst Capture Implementation
+ *
+ * The per-conversion callback may run in the ADC interrupt, so it only
+ * stores the code, advances the ring and compares against the trigger
+ * in millivolts (one multiply and shift). Configuration and the reader
+ * pin are shared with other threads under a spinlock; the state is an
+ * atomic so the shell can poll it while the burst runs.
+ */
+
+#include "capture.h"
+#include "adc_backend.h"
+#include "regs.h"
+#include "threshold.h"
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(capture, LOG_LEVEL_INF);
+
+#define CAPTURE_MAX_SAMPLES CONFIG_APP_CAPTURE_MAX_SAMPLES
+
+/* Plain .bss: the default RAM, i.e. AXI SRAM on the STM32H7 */
+static uint16_t capture_buf[CAPTURE_MAX_SAMPLES];
+
+static struct k_spinlock status_lock;
+static struct capture_config config;
+static uint32_t readers;
+static uint32_t interval_ns;
+
+static atomic_t state = ATOMIC_INIT(CAPTURE_IDLE);
+static atomic_t cancel;
+
+/* Burst state, touched only by the conversion callback while it runs */
+static uint32_t pos;          /* Ring slot the next code goes to */
+static uint32_t conversions;  /* Codes stored since the burst started */
+static uint32_t remaining;    /* Post-trigger codes still to store */
+static int32_t low_mv, high_mv;
+static int32_t prev_mv;
+
+static bool triggered(const struct capture_config *cfg, int32_t mv)
+{
+    bool fire;
+
+    switch (cfg->trigger) {
+    case CAPTURE_TRIG_RISING:
+        fire = prev_mv <= cfg->level_mv && mv > cfg->level_mv;
+        break;
+    case CAPTURE_TRIG_FALLING:
+        fire = prev_mv >= cfg->level_mv && mv < cfg->level_mv;
+        break;
+    case CAPTURE_TRIG_ALARM:
+        fire = mv > high_mv || mv < low_mv;
+        break;
+    default:
+        fire = true;
+        break;
+    }
+
+    prev_mv = mv;
+    return fire;
+}
+
+static bool capture_sample(uint16_t raw, void *user_data)
+{
+    const struct capture_config *cfg = user_data;
+    bool armed = (atomic_get(&state) == CAPTURE_ARMED);
+    bool window_full = (conversions >= cfg->pre_samples);
+
+    if (atomic_get(&cancel)) {
+        return false;
+    }
+
+    capture_buf[pos] = raw;
+    pos = (pos + 1 == cfg->samples) ? 0 : pos + 1;
+    conversions++;
+
+    if (armed) {
+        /* Edges need one reference sample, so evaluate even while filling */
+        int32_t mv = regs_raw_to_mv(cfg->ch, raw);
+
+        if (!triggered(cfg, mv) || !window_full) {
+            return true;
+        }
+        atomic_set(&state, CAPTURE_TRIGGERED);
+        remaining = cfg->samples - cfg->pre_samples - 1;
+    } else if (remaining > 0) {
+        remaining--;
+    }
+
+    return remaining > 0;
+}
+
+int capture_arm(const struct capture_config *cfg)
+{
+    int32_t low = INT32_MIN, high = INT32_MAX;
+    k_spinlock_key_t key;
+    int ret = 0;
+
+    if (cfg->ch >= NUM_CH || cfg->samples < 2 || cfg->samples > CAPTURE_MAX_SAMPLES ||
+        cfg->pre_samples >= cfg->samples || cfg->trigger > CAPTURE_TRIG_ALARM) {
+        return -EINVAL;
+    }
+
+    if (cfg->trigger == CAPTURE_TRIG_ALARM) {
+#if defined(CONFIG_APP_THRESHOLDS)
+        struct threshold_rule rule;
+
+        (void)threshold_get_rule(cfg->ch, &rule);
+        if (rule.flags & THRESHOLD_HIGH) {
+            high = rule.high_mv;
+        }
+        if (rule.flags & THRESHOLD_LOW) {
+            low = rule.low_mv;
+        }
+#endif
+        if (low == INT32_MIN && high == INT32_MAX) {
+            return -ENOTSUP;
+        }
+    }
+
+    key = k_spin_lock(&status_lock);
+    if (readers > 0 || atomic_get(&state) == CAPTURE_ARMED ||
+        atomic_get(&state) == CAPTURE_TRIGGERED) {
+        ret = -EBUSY;
+    } else {
+        config = *cfg;
+        low_mv = low;
+        high_mv = high;
+        interval_ns = 0;
+        conversions = 0;
+        atomic_clear(&cancel);
+        atomic_set(&state, CAPTURE_ARMED);
+    }
+    k_spin_unlock(&status_lock, key);
+
+    return ret;
+}
+
+void capture_cancel(void)
+{
+    atomic_set(&cancel, 1);
+}
+
+void capture_get_status(struct capture_status *st)
+{
+    k_spinlock_key_t key = k_spin_lock(&status_lock);
+
+    st->state = (enum capture_state)atomic_get(&state);
+    st->config = config;
+    st->conversions = conversions;
+    st->interval_ns = interval_ns;
+    k_spin_unlock(&status_lock, key);
+}
+
+bool capture_run(void)
+{
+    struct capture_config cfg;
+    uint64_t t_start, t_end;
+    k_spinlock_key_t key;
+    int ret;
+
+    if (atomic_get(&state) != CAPTURE_ARMED) {
+        return false;
+    }
+
+    key = k_spin_lock(&status_lock);
+    cfg = config;
+    k_spin_unlock(&status_lock, key);
+
+    pos = 0;
+    remaining = 0;
+    prev_mv = (cfg.trigger == CAPTURE_TRIG_RISING) ? INT32_MAX : INT32_MIN;
+
+    LOG_INF("Capture armed: ch[%u], %u samples, %u pre-trigger", cfg.ch, cfg.samples,
+            cfg.pre_samples);
+
+    t_start = regs_clock_ns();
+    ret = adc_backend_burst(cfg.ch, capture_sample, &cfg);
+    t_end = regs_clock_ns();
+
+    key = k_spin_lock(&status_lock);
+    if (ret < 0 || atomic_get(&cancel) || atomic_get(&state) != CAPTURE_TRIGGERED ||
+        remaining > 0) {
+        atomic_set(&state, CAPTURE_IDLE);
+    } else {
+        interval_ns = (uint32_t)MIN((t_end - t_start) / MAX(conversions, 1U), UINT32_MAX);
+        atomic_set(&state, CAPTURE_DONE);
+    }
+    k_spin_unlock(&status_lock, key);
+
+    if (ret < 0) {
+        LOG_ERR("Capture burst failed: %d", ret);
+    } else if (atomic_get(&state) == CAPTURE_DONE) {
+        LOG_INF("Capture done: %u conversions, %u ns apart", conversions, interval_ns);
+    } else {
+        LOG_INF("Capture cancelled");
+    }
+
+    return true;
+}
+
+int capture_lock(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&status_lock);
+    int ret = -ENODATA;
+
+    if (atomic_get(&state) == CAPTURE_DONE) {
+        readers++;
+        ret = 0;
+    }
+    k_spin_unlock(&status_lock, key);
+
+    return ret;
+}
+
+void capture_unlock(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&status_lock);
+
+    if (readers > 0) {
+        readers--;
+    }
+    k_spin_unlock(&status_lock, key);
+}
+
+size_t capture_read(uint32_t index, uint16_t *out, size_t max)
+{
+    /* After the freeze, the oldest code sits where the next one would go */
+    uint32_t slot;
+    size_t n = 0;
+
+    if (index >= config.samples) {
+        return 0;
+    }
+
+    slot = pos + index;
+    if (slot >= config.samples) {
+        slot -= config.samples;
+    }
+
+    while (n < max && index + n < config.samples) {
+        out[n++] = capture_buf[slot];
+        slot = (slot + 1 == config.samples) ? 0 : slot + 1;
+    }
+
+    return n;
+}
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Burst Capture - Oscilloscope-style triggered capture of one channel
+ *
+ * Next to the continuous frame path, a capture samples a single channel
+ * back to back (adc_backend_burst()) into a RAM ring of up to
+ * CONFIG_APP_CAPTURE_MAX_SAMPLES codes. Once the pre-trigger part of the
+ * ring is full, every conversion is checked against the trigger; after
+ * it fires, the capture freezes when the post-trigger part is full. The
+ * sampling thread runs the burst in place of its regular frames, so the
+ * register file and the sample ring pause while a capture is armed.
+ * Finished captures are downloaded in chunks over the binary stream
+ * (stream_send_capture()).
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief What starts the post-trigger window
+ */
+enum capture_trigger {
+    CAPTURE_TRIG_NOW,      /* First conversion after the pre-trigger window */
+    CAPTURE_TRIG_RISING,   /* Crossing above level_mv */
+    CAPTURE_TRIG_FALLING,  /* Crossing below level_mv */
+    CAPTURE_TRIG_ALARM,    /* Outside the channel's adcalarm high/low window */
+};
+
+/**
+ * @brief Capture states
+ */
+enum capture_state {
+    CAPTURE_IDLE,       /* Nothing captured, or cancelled */
+    CAPTURE_ARMED,      /* Filling the ring, waiting for the trigger */
+    CAPTURE_TRIGGERED,  /* Filling the post-trigger window */
+    CAPTURE_DONE,       /* Frozen, ready for download */
+};
+
+/**
+ * @brief Capture parameters
+ */
+struct capture_config {
+    uint8_t ch;                    /* Channel to capture */
+    enum capture_trigger trigger;
+    int32_t level_mv;              /* RISING/FALLING level */
+    uint32_t samples;              /* Capture length, 2 to CONFIG_APP_CAPTURE_MAX_SAMPLES */
+    uint32_t pre_samples;          /* Samples kept before the trigger, < samples */
+};
+
+/**
+ * @brief Capture status
+ */
+struct capture_status {
+    enum capture_state state;
+    struct capture_config config;
+    uint32_t conversions;          /* Conversions in the burst so far */
+    uint32_t interval_ns;          /* DONE: mean time between conversions */
+};
+
+#if defined(CONFIG_APP_CAPTURE)
+
+/**
+ * @brief Arm a capture
+ *
+ * Callable from any thread; the sampling thread starts the burst before
+ * its next frame. Discards a previous capture.
+ *
+ * @param cfg Parameters, copied
+ * @return 0 on success, -EINVAL on bad parameters, -ENOTSUP for an alarm
+ *         trigger on a channel without a high/low rule, -EBUSY while
+ *         a capture is running or being downloaded
+ */
+int capture_arm(const struct capture_config *cfg);
+
+/**
+ * @brief Cancel a running capture
+ *
+ * The burst ends at its next conversion and the state returns to
+ * CAPTURE_IDLE. No-op otherwise.
+ */
+void capture_cancel(void);
+
+/**
+ * @brief Get the capture status
+ *
+ * @param st Receives the status
+ */
+void capture_get_status(struct capture_status *st);
+
+/**
+ * @brief Run an armed capture to completion
+ *
+ * Sampling thread only, between frames. Blocks until the capture is
+ * done or cancelled.
+ *
+ * @return true if a burst ran
+ */
+bool capture_run(void);
+
+/**
+ * @brief Pin a finished capture for reading
+ *
+ * capture_arm() fails with -EBUSY until the matching capture_unlock().
+ *
+ * @return 0 on success, -ENODATA if no capture is done
+ */
+int capture_lock(void);
+
+/**
+ * @brief Release a capture pinned by capture_lock()
+ */
+void capture_unlock(void);
+
+/**
+ * @brief Copy samples of a pinned capture in time order
+ *
+ * Index capture_config::pre_samples is the trigger sample.
+ *
+ * @param index First sample
+ * @param out   Receives raw codes
+ * @param max   Capacity of @p out
+ * @return Samples copied (0 past the end)
+ */
+size_t capture_read(uint32_t index, uint16_t *out, size_t max);
+
+#else
+
+static inline bool capture_run(void) { return false; }
+
+#endif /* CONFIG_APP_CAPTURE */
+
+#endif /* CAPTURE_H_ */
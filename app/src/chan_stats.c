@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Channel Statistics Implementation
+ *
+ * A window holds min, max, sum and sum of squares per channel. With 16-bit
+ * codes the squares fit 32 bits, so 64-bit sums cannot overflow within
+ * the 32-bit sample count. Mean and RMS are only derived on read.
+ */
+
+#include "chan_stats.h"
+#include "mem_placement.h"
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+struct chan_acc {
+    uint32_t count;
+    uint16_t min;
+    uint16_t max;
+    uint64_t sum;
+    uint64_t sum_sq;
+};
+
+struct chan_window {
+    int64_t start_ms;
+    struct chan_acc ch[NUM_CH];
+};
+
+static struct chan_window windows[CHAN_STATS_WINDOW_COUNT] APP_FAST_BSS;
+static struct k_spinlock windows_lock;
+
+static void window_reset(struct chan_window *win, int64_t now_ms)
+{
+    win->start_ms = now_ms;
+    for (int i = 0; i < NUM_CH; i++) {
+        win->ch[i] = (struct chan_acc){ .min = UINT16_MAX };
+    }
+}
+
+/* Largest r with r * r <= v */
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t r = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)r;
+}
+
+void chan_stats_init(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&windows_lock);
+    int64_t now_ms = k_uptime_get();
+
+    for (int w = 0; w < CHAN_STATS_WINDOW_COUNT; w++) {
+        window_reset(&windows[w], now_ms);
+    }
+    k_spin_unlock(&windows_lock, key);
+}
+
+void chan_stats_update(const uint16_t raw[NUM_CH], uint32_t mask)
+{
+    k_spinlock_key_t key = k_spin_lock(&windows_lock);
+
+    for (int w = 0; w < CHAN_STATS_WINDOW_COUNT; w++) {
+        struct chan_acc *acc = windows[w].ch;
+
+        for (int i = 0; i < NUM_CH; i++) {
+            uint32_t v = raw[i];
+
+            if (!(mask & BIT(i))) {
+                continue;
+            }
+            acc[i].count++;
+            acc[i].min = MIN(acc[i].min, v);
+            acc[i].max = MAX(acc[i].max, v);
+            acc[i].sum += v;
+            acc[i].sum_sq += v * v;
+        }
+    }
+    k_spin_unlock(&windows_lock, key);
+}
+
+void chan_stats_read(enum chan_stats_window w, struct chan_stats_snapshot *out, bool reset)
+{
+    struct chan_window win;
+    k_spinlock_key_t key;
+    int64_t now_ms;
+
+    /* Copy under the lock; the divisions and square roots run outside it */
+    key = k_spin_lock(&windows_lock);
+    now_ms = k_uptime_get();
+    win = windows[w];
+    if (reset) {
+        window_reset(&windows[w], now_ms);
+    }
+    k_spin_unlock(&windows_lock, key);
+
+    out->duration_ms = (uint32_t)(now_ms - win.start_ms);
+    for (int i = 0; i < NUM_CH; i++) {
+        const struct chan_acc *acc = &win.ch[i];
+        struct chan_stats *st = &out->ch[i];
+
+        if (acc->count == 0) {
+            *st = (struct chan_stats){ 0 };
+            continue;
+        }
+        st->count = acc->count;
+        st->min = acc->min;
+        st->max = acc->max;
+        st->mean = (uint16_t)((acc->sum + acc->count / 2) / acc->count);
+        st->rms = (uint16_t)isqrt64(acc->sum_sq / acc->count);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Channel Statistics - Per-channel min/max/mean/RMS over reset-on-read
+ * windows
+ *
+ * The processing stage folds every published frame into one accumulator
+ * per channel and window: a compare for min/max, a sum and a sum of
+ * squares, so the cost per sample is constant however long a window
+ * runs. Each consumer owns a window; reading it returns the aggregates
+ * since its previous read and starts a new one. Values stay raw codes,
+ * like the register file; regs_raw_to_mv() converts them.
+ */
+
+#ifndef CHAN_STATS_H_
+#define CHAN_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "regs.h"  /* For NUM_CH */
+
+/**
+ * @brief Statistics windows, one per consumer
+ */
+enum chan_stats_window {
+    CHAN_STATS_SHELL,   /* 'adcsummary' */
+    CHAN_STATS_STREAM,  /* STATS packets on the binary stream */
+    CHAN_STATS_WINDOW_COUNT,
+};
+
+/**
+ * @brief Aggregates of one channel over a window (raw codes)
+ *
+ * All but @p count are 0 when @p count is 0.
+ */
+struct chan_stats {
+    uint32_t count;  /* Samples in the window */
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;   /* Rounded to nearest */
+    uint16_t rms;    /* Rounded down */
+};
+
+/**
+ * @brief Aggregates of all channels over a window
+ */
+struct chan_stats_snapshot {
+    uint32_t duration_ms;          /* Window length */
+    struct chan_stats ch[NUM_CH];
+};
+
+#if defined(CONFIG_APP_CHAN_STATS)
+
+/**
+ * @brief Start every window empty
+ */
+void chan_stats_init(void);
+
+/**
+ * @brief Add a published frame to every window
+ *
+ * Processing stage only (sample_proc.h). Channels not in @p mask (not
+ * sampled in this frame) are left out, so each channel counts only
+ * fresh samples.
+ *
+ * @param raw  NUM_CH raw codes
+ * @param mask Channels to add (bit n = channel n)
+ */
+void chan_stats_update(const uint16_t raw[NUM_CH], uint32_t mask);
+
+/**
+ * @brief Read a window and start a new one
+ *
+ * Callable from any thread.
+ *
+ * @param w     Window to read
+ * @param out   Receives the aggregates
+ * @param reset False to leave the window running (peek)
+ */
+void chan_stats_read(enum chan_stats_window w, struct chan_stats_snapshot *out, bool reset);
+
+#else
+
+static inline void chan_stats_init(void) {}
+static inline void chan_stats_update(const uint16_t raw[NUM_CH], uint32_t mask)
+{
+    ARG_UNUSED(raw);
+    ARG_UNUSED(mask);
+}
+
+#endif /* CONFIG_APP_CHAN_STATS */
+
+#endif /* CHAN_STATS_H_ */
@@ -0,0 +1,222 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcalarm - Configure threshold alarms and change events
+ */
+
+#include <zephyr/shell/shell.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "threshold.h"
+
+/* Default wait for 'adcalarm wait' */
+#define ALARM_WAIT_DEFAULT_MS 10000
+
+static int parse_channel(const struct shell *sh, const char *arg, unsigned int *ch)
+{
+    char *end;
+    unsigned long val = strtoul(arg, &end, 10);
+
+    if (end == arg || *end != '\0' || val >= NUM_CH) {
+        shell_error(sh, "Invalid channel %s (0-%d)", arg, NUM_CH - 1);
+        return -EINVAL;
+    }
+
+    *ch = (unsigned int)val;
+    return 0;
+}
+
+/* Whole decimal argument in [min, INT32_MAX] */
+static int parse_int(const struct shell *sh, const char *arg, const char *what,
+                     int32_t min, int32_t *out)
+{
+    char *end;
+    long val;
+
+    errno = 0;
+    val = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno != 0 || val < min || val > INT32_MAX) {
+        shell_error(sh, "Invalid %s %s", what, arg);
+        return -EINVAL;
+    }
+
+    *out = (int32_t)val;
+    return 0;
+}
+
+/* "-" leaves a threshold unset */
+static int parse_mv(const struct shell *sh, const char *arg, int32_t *mv, bool *set)
+{
+    if (strcmp(arg, "-") == 0) {
+        *set = false;
+        return 0;
+    }
+
+    if (parse_int(sh, arg, "millivolt value", INT32_MIN, mv) < 0) {
+        return -EINVAL;
+    }
+
+    *set = true;
+    return 0;
+}
+
+static int cmd_adcalarm_list(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t alarms = threshold_alarms();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "Threshold rules (alarms 0x%04x, events dropped %u):", alarms,
+                threshold_events_dropped());
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        struct threshold_rule r;
+
+        (void)threshold_get_rule(ch, &r);
+        if (r.flags == 0) {
+            continue;
+        }
+
+        shell_fprintf(sh, SHELL_NORMAL, "  ch[%d]:", ch);
+        if (r.flags & THRESHOLD_LOW) {
+            shell_fprintf(sh, SHELL_NORMAL, " low=%d", r.low_mv);
+        }
+        if (r.flags & THRESHOLD_HIGH) {
+            shell_fprintf(sh, SHELL_NORMAL, " high=%d", r.high_mv);
+        }
+        if (r.flags & (THRESHOLD_LOW | THRESHOLD_HIGH)) {
+            shell_fprintf(sh, SHELL_NORMAL, " hyst=%d", r.hysteresis_mv);
+        }
+        if (r.flags & THRESHOLD_CHANGE) {
+            shell_fprintf(sh, SHELL_NORMAL, " deadband=%d", r.deadband_mv);
+        }
+        shell_print(sh, " mV%s", (alarms & BIT(ch)) ? " [ALARM]" : "");
+    }
+
+    return 0;
+}
+
+static int cmd_adcalarm_set(const struct shell *sh, size_t argc, char **argv)
+{
+    struct threshold_rule r;
+    unsigned int ch;
+    bool has_low, has_high;
+    int ret;
+
+    ret = parse_channel(sh, argv[1], &ch);
+    if (ret < 0) {
+        return ret;
+    }
+
+    (void)threshold_get_rule(ch, &r);
+    r.flags &= ~(THRESHOLD_LOW | THRESHOLD_HIGH);
+    r.hysteresis_mv = 0;
+
+    if (parse_mv(sh, argv[2], &r.low_mv, &has_low) < 0 ||
+        parse_mv(sh, argv[3], &r.high_mv, &has_high) < 0) {
+        return -EINVAL;
+    }
+    if (argc > 4 && parse_int(sh, argv[4], "hysteresis", 0, &r.hysteresis_mv) < 0) {
+        return -EINVAL;
+    }
+
+    r.flags |= (has_low ? THRESHOLD_LOW : 0) | (has_high ? THRESHOLD_HIGH : 0);
+
+    ret = threshold_set_rule(ch, &r);
+    if (ret < 0) {
+        shell_error(sh, "Invalid rule (need low < high, hysteresis >= 0): %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "ch[%u] thresholds set", ch);
+    return 0;
+}
+
+static int cmd_adcalarm_change(const struct shell *sh, size_t argc, char **argv)
+{
+    struct threshold_rule r;
+    unsigned int ch;
+    int ret;
+
+    ARG_UNUSED(argc);
+
+    ret = parse_channel(sh, argv[1], &ch);
+    if (ret < 0) {
+        return ret;
+    }
+
+    (void)threshold_get_rule(ch, &r);
+    if (parse_int(sh, argv[2], "deadband", 0, &r.deadband_mv) < 0) {
+        return -EINVAL;
+    }
+    if (r.deadband_mv > 0) {
+        r.flags |= THRESHOLD_CHANGE;
+    } else {
+        r.flags &= ~THRESHOLD_CHANGE;
+    }
+
+    ret = threshold_set_rule(ch, &r);
+    if (ret < 0) {
+        shell_error(sh, "Invalid deadband: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "ch[%u] change events %s", ch, r.deadband_mv > 0 ? "on" : "off");
+    return 0;
+}
+
+static int cmd_adcalarm_off(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct threshold_rule none = {0};
+    unsigned int ch;
+    int ret;
+
+    ARG_UNUSED(argc);
+
+    ret = parse_channel(sh, argv[1], &ch);
+    if (ret < 0) {
+        return ret;
+    }
+
+    (void)threshold_set_rule(ch, &none);
+    shell_print(sh, "ch[%u] rules cleared", ch);
+    return 0;
+}
+
+static int cmd_adcalarm_wait(const struct shell *sh, size_t argc, char **argv)
+{
+    int32_t timeout_ms = ALARM_WAIT_DEFAULT_MS;
+    uint32_t alarms;
+
+    if (argc > 1 && parse_int(sh, argv[1], "timeout", 0, &timeout_ms) < 0) {
+        return -EINVAL;
+    }
+
+    alarms = threshold_wait(BIT_MASK(NUM_CH), K_MSEC(timeout_ms));
+    if (alarms == 0) {
+        shell_print(sh, "No alarm within %d ms", timeout_ms);
+        return -EAGAIN;
+    }
+
+    shell_print(sh, "Alarm: 0x%04x", alarms);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcalarm_cmds,
+    SHELL_CMD(list, NULL, "Show rules and active alarms", cmd_adcalarm_list),
+    SHELL_CMD_ARG(set, NULL,
+                  "Set thresholds: set <ch> <low_mv|-> <high_mv|-> [hyst_mv]",
+                  cmd_adcalarm_set, 4, 1),
+    SHELL_CMD_ARG(change, NULL,
+                  "Change events: change <ch> <deadband_mv> (0 = off)",
+                  cmd_adcalarm_change, 3, 0),
+    SHELL_CMD_ARG(off, NULL, "Clear all rules: off <ch>", cmd_adcalarm_off, 2, 0),
+    SHELL_CMD_ARG(wait, NULL, "Block until an alarm: wait [timeout_ms]",
+                  cmd_adcalarm_wait, 1, 1),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcalarm, &adcalarm_cmds, "Threshold alarms and change events",
+                   cmd_adcalarm_list);
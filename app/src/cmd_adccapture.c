@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adccapture - Triggered burst capture of one channel
+ */
+
+#include <zephyr/shell/shell.h>
+#include <string.h>
+#include "capture.h"
+#include "shell_parse.h"
+#include "stream.h"
+
+static const char *const state_names[] = {
+    [CAPTURE_IDLE] = "idle",
+    [CAPTURE_ARMED] = "armed",
+    [CAPTURE_TRIGGERED] = "triggered",
+    [CAPTURE_DONE] = "done",
+};
+
+static const char *const trigger_names[] = {
+    [CAPTURE_TRIG_NOW] = "now",
+    [CAPTURE_TRIG_RISING] = "rising",
+    [CAPTURE_TRIG_FALLING] = "falling",
+    [CAPTURE_TRIG_ALARM] = "alarm",
+};
+
+static int cmd_adccapture_status(const struct shell *sh, size_t argc, char **argv)
+{
+    struct capture_status st;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    capture_get_status(&st);
+
+    shell_print(sh, "Capture: %s", state_names[st.state]);
+    if (st.state == CAPTURE_IDLE) {
+        return 0;
+    }
+
+    shell_fprintf(sh, SHELL_NORMAL, "  ch[%u], %u samples (%u pre-trigger), trigger %s",
+                  st.config.ch, st.config.samples, st.config.pre_samples,
+                  trigger_names[st.config.trigger]);
+    if (st.config.trigger == CAPTURE_TRIG_RISING ||
+        st.config.trigger == CAPTURE_TRIG_FALLING) {
+        shell_fprintf(sh, SHELL_NORMAL, " %d mV", st.config.level_mv);
+    }
+    shell_print(sh, "");
+    shell_print(sh, "  conversions: %u", st.conversions);
+    if (st.state == CAPTURE_DONE) {
+        shell_print(sh, "  interval:    %u ns", st.interval_ns);
+    }
+
+    return 0;
+}
+
+/* arm <ch> <samples> <pre> [now | rising <mv> | falling <mv> | alarm] */
+static int cmd_adccapture_arm(const struct shell *sh, size_t argc, char **argv)
+{
+    struct capture_config cfg = { .trigger = CAPTURE_TRIG_NOW };
+    uint32_t val;
+    int ret;
+
+    if (shell_parse_u32(sh, argv[1], 10, CONFIG_APP_NUM_CH - 1, &val) < 0 ||
+        shell_parse_u32(sh, argv[2], 10, CONFIG_APP_CAPTURE_MAX_SAMPLES, &cfg.samples) < 0 ||
+        shell_parse_u32(sh, argv[3], 10, CONFIG_APP_CAPTURE_MAX_SAMPLES, &cfg.pre_samples) < 0) {
+        return -EINVAL;
+    }
+    cfg.ch = (uint8_t)val;
+
+    if (argc > 4) {
+        size_t t;
+
+        for (t = 0; t < ARRAY_SIZE(trigger_names); t++) {
+            if (strcmp(argv[4], trigger_names[t]) == 0) {
+                break;
+            }
+        }
+        if (t == ARRAY_SIZE(trigger_names)) {
+            shell_error(sh, "Unknown trigger %s", argv[4]);
+            return -EINVAL;
+        }
+        cfg.trigger = (enum capture_trigger)t;
+    }
+
+    if (cfg.trigger == CAPTURE_TRIG_RISING || cfg.trigger == CAPTURE_TRIG_FALLING) {
+        if (argc < 6 || shell_parse_u32(sh, argv[5], 10, INT32_MAX, &val) < 0) {
+            shell_error(sh, "%s needs a level in mV", argv[4]);
+            return -EINVAL;
+        }
+        cfg.level_mv = (int32_t)val;
+    }
+
+    ret = capture_arm(&cfg);
+    if (ret == -EBUSY) {
+        shell_error(sh, "Capture running or being downloaded");
+        return ret;
+    }
+    if (ret == -ENOTSUP) {
+        shell_error(sh, "ch[%u] has no high/low adcalarm rule", cfg.ch);
+        return ret;
+    }
+    if (ret < 0) {
+        shell_error(sh, "Need 2 <= samples <= %d and pre < samples",
+                    CONFIG_APP_CAPTURE_MAX_SAMPLES);
+        return ret;
+    }
+
+    shell_print(sh, "Capture armed on ch[%u]", cfg.ch);
+    return 0;
+}
+
+static int cmd_adccapture_stop(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    capture_cancel();
+    shell_print(sh, "Capture cancelled");
+    return 0;
+}
+
+#if defined(CONFIG_APP_STREAM)
+/* send [index] [count]: queue a download on the binary stream */
+static int cmd_adccapture_send(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t index = 0, count = UINT32_MAX;
+    int ret;
+
+    if ((argc > 1 && shell_parse_u32(sh, argv[1], 10, UINT32_MAX, &index) < 0) ||
+        (argc > 2 && shell_parse_u32(sh, argv[2], 10, UINT32_MAX, &count) < 0)) {
+        return -EINVAL;
+    }
+
+    ret = stream_send_capture(index, count);
+    if (ret == -ENODATA) {
+        shell_error(sh, "No finished capture");
+        return ret;
+    }
+    if (ret < 0) {
+        shell_error(sh, "Download failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Download queued on the stream UART");
+    return 0;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adccapture_cmds,
+    SHELL_CMD_ARG(arm, NULL,
+                  "Arm: arm <ch> <samples> <pre> [now|rising <mv>|falling <mv>|alarm]",
+                  cmd_adccapture_arm, 4, 2),
+    SHELL_CMD(stop, NULL, "Cancel a running capture", cmd_adccapture_stop),
+#if defined(CONFIG_APP_STREAM)
+    SHELL_CMD_ARG(send, NULL, "Download on the stream: send [index] [count]",
+                  cmd_adccapture_send, 1, 2),
+#endif
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adccapture, &adccapture_cmds, "Triggered burst capture",
+                   cmd_adccapture_status);
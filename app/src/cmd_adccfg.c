@@ -0,0 +1,183 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adccfg - Runtime sampling configuration
+ *
+ * Unlike 'adcrate period', which retunes the running scheduler only,
+ * these settings are the ones 'adccfg save' persists and boot restores.
+ */
+
+#include <zephyr/shell/shell.h>
+#include <string.h>
+#include "sampler_config.h"
+#include "sample_sched.h"
+#include "shell_parse.h"
+
+/* A number or "default" for the per-channel build-time setting */
+static int parse_setting(const struct shell *sh, const char *arg, uint8_t *val)
+{
+    uint32_t v;
+
+    if (strcmp(arg, "default") == 0) {
+        *val = ADC_BACKEND_DEFAULT;
+        return 0;
+    }
+
+    if (shell_parse_u32(sh, arg, 0, ADC_BACKEND_DEFAULT - 1, &v) < 0) {
+        return -EINVAL;
+    }
+
+    *val = (uint8_t)v;
+    return 0;
+}
+
+static int cmd_adccfg_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sampler_config cfg;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    sampler_config_get(&cfg);
+
+    shell_print(sh, "Period:       %u us", cfg.period_us);
+    shell_print(sh, "Channels:     0x%04x (%d of %d)", cfg.channel_mask,
+                __builtin_popcount(cfg.channel_mask), NUM_CH);
+    if (cfg.resolution == ADC_BACKEND_DEFAULT) {
+        shell_print(sh, "Resolution:   default");
+    } else {
+        shell_print(sh, "Resolution:   %u bits", cfg.resolution);
+    }
+    if (cfg.oversampling == ADC_BACKEND_DEFAULT) {
+        shell_print(sh, "Oversampling: default");
+    } else {
+        shell_print(sh, "Oversampling: %ux", 1U << cfg.oversampling);
+    }
+    shell_print(sh, "Persistence:  %s",
+                IS_ENABLED(CONFIG_APP_RUNTIME_CONFIG_SETTINGS) ? "settings" : "none");
+
+    return 0;
+}
+
+/* Hand a modified configuration to the sampling thread and show it */
+static int config_stage(const struct shell *sh, const struct sampler_config *cfg)
+{
+    int ret = sampler_config_set(cfg);
+
+    if (ret == -ENOTSUP) {
+        shell_error(sh, "Resolution/oversampling not supported by this backend");
+        return ret;
+    }
+    if (ret < 0) {
+        shell_error(sh, "Period must be %u-%u us and the mask within 0x%x",
+                    SAMPLE_SCHED_MIN_PERIOD_US, SAMPLE_SCHED_MAX_PERIOD_US,
+                    ADC_BACKEND_ALL_CHANNELS);
+        return ret;
+    }
+
+    return cmd_adccfg_show(sh, 1, NULL);
+}
+
+static int cmd_adccfg_period(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sampler_config cfg;
+
+    ARG_UNUSED(argc);
+
+    sampler_config_get(&cfg);
+    if (shell_parse_u32(sh, argv[1], 0, SAMPLE_SCHED_MAX_PERIOD_US, &cfg.period_us) < 0) {
+        return -EINVAL;
+    }
+
+    return config_stage(sh, &cfg);
+}
+
+static int cmd_adccfg_channels(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sampler_config cfg;
+
+    ARG_UNUSED(argc);
+
+    sampler_config_get(&cfg);
+    if (shell_parse_u32(sh, argv[1], 0, ADC_BACKEND_ALL_CHANNELS, &cfg.channel_mask) < 0) {
+        return -EINVAL;
+    }
+
+    return config_stage(sh, &cfg);
+}
+
+static int cmd_adccfg_resolution(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sampler_config cfg;
+
+    ARG_UNUSED(argc);
+
+    sampler_config_get(&cfg);
+    if (parse_setting(sh, argv[1], &cfg.resolution) < 0) {
+        return -EINVAL;
+    }
+
+    return config_stage(sh, &cfg);
+}
+
+static int cmd_adccfg_oversampling(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sampler_config cfg;
+
+    ARG_UNUSED(argc);
+
+    sampler_config_get(&cfg);
+    if (parse_setting(sh, argv[1], &cfg.oversampling) < 0) {
+        return -EINVAL;
+    }
+
+    return config_stage(sh, &cfg);
+}
+
+static int cmd_adccfg_save(const struct shell *sh, size_t argc, char **argv)
+{
+    int ret = sampler_config_save();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    if (ret < 0) {
+        shell_error(sh, "Save failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Configuration saved");
+    return 0;
+}
+
+static int cmd_adccfg_erase(const struct shell *sh, size_t argc, char **argv)
+{
+    int ret = sampler_config_erase();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    if (ret < 0) {
+        shell_error(sh, "Erase failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Saved configuration erased; defaults apply from the next boot");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adccfg_cmds,
+    SHELL_CMD_ARG(period, NULL, "Frame period: period <us>", cmd_adccfg_period, 2, 0),
+    SHELL_CMD_ARG(channels, NULL, "Active channels: channels <mask>, e.g. 0x7fff",
+                  cmd_adccfg_channels, 2, 0),
+    SHELL_CMD_ARG(resolution, NULL, "All channels: resolution <bits>|default",
+                  cmd_adccfg_resolution, 2, 0),
+    SHELL_CMD_ARG(oversampling, NULL, "All channels: oversampling <log2 ratio>|default",
+                  cmd_adccfg_oversampling, 2, 0),
+    SHELL_CMD(save, NULL, "Persist the configuration", cmd_adccfg_save),
+    SHELL_CMD(erase, NULL, "Delete the persisted configuration", cmd_adccfg_erase),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adccfg, &adccfg_cmds, "Show or change the sampling configuration",
+                   cmd_adccfg_show);
@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcrate - Show or change the sampling period
+ */
+
+#include <zephyr/shell/shell.h>
+#include "sample_sched.h"
+#include "adaptive_rate.h"
+#include "shell_parse.h"
+
+static int cmd_adcrate_show(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "Period: %u us", sample_sched_period_us());
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+    struct adaptive_rate_config cfg;
+
+    adaptive_rate_get(&cfg);
+    if (cfg.enabled) {
+        shell_print(sh, "Adaptive: %s, fast=%u us slow=%u us delta=%u mV hold=%u frames",
+                    adaptive_rate_is_fast() ? "fast" : "slow", cfg.fast_us, cfg.slow_us,
+                    cfg.delta_mv, cfg.hold_frames);
+    } else {
+        shell_print(sh, "Adaptive: off");
+    }
+#endif
+
+    return 0;
+}
+
+static int cmd_adcrate_period(const struct shell *sh, size_t argc, char **argv)
+{
+    uint32_t period_us;
+    int ret;
+
+    ARG_UNUSED(argc);
+
+    if (shell_parse_u32(sh, argv[1], 10, SAMPLE_SCHED_MAX_PERIOD_US, &period_us) < 0) {
+        return -EINVAL;
+    }
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+    /* A fixed period turns the adaptive rate off */
+    struct adaptive_rate_config cfg;
+
+    adaptive_rate_get(&cfg);
+    cfg.enabled = false;
+    cfg.fast_us = period_us;
+    cfg.slow_us = period_us;
+    ret = adaptive_rate_configure(&cfg);
+#else
+    ret = sample_sched_set_period(period_us);
+#endif
+    if (ret < 0) {
+        shell_error(sh, "Period must be %u-%u us", SAMPLE_SCHED_MIN_PERIOD_US,
+                    SAMPLE_SCHED_MAX_PERIOD_US);
+        return ret;
+    }
+
+    shell_print(sh, "Period: %u us", period_us);
+    return 0;
+}
+
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+static int cmd_adcrate_adaptive(const struct shell *sh, size_t argc, char **argv)
+{
+    struct adaptive_rate_config cfg;
+    uint32_t val;
+    int ret;
+
+    adaptive_rate_get(&cfg);
+    cfg.enabled = true;
+
+    if (shell_parse_u32(sh, argv[1], 10, SAMPLE_SCHED_MAX_PERIOD_US, &cfg.fast_us) < 0 ||
+        shell_parse_u32(sh, argv[2], 10, SAMPLE_SCHED_MAX_PERIOD_US, &cfg.slow_us) < 0) {
+        return -EINVAL;
+    }
+    if (argc > 3) {
+        if (shell_parse_u32(sh, argv[3], 10, UINT16_MAX, &val) < 0) {
+            return -EINVAL;
+        }
+        cfg.delta_mv = (uint16_t)val;
+    }
+    if (argc > 4) {
+        if (shell_parse_u32(sh, argv[4], 10, UINT16_MAX, &val) < 0) {
+            return -EINVAL;
+        }
+        cfg.hold_frames = (uint16_t)val;
+    }
+
+    ret = adaptive_rate_configure(&cfg);
+    if (ret < 0) {
+        shell_error(sh, "Need %u <= fast_us <= slow_us <= %u", SAMPLE_SCHED_MIN_PERIOD_US,
+                    SAMPLE_SCHED_MAX_PERIOD_US);
+        return ret;
+    }
+
+    return cmd_adcrate_show(sh, 1, argv);
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcrate_cmds,
+    SHELL_CMD_ARG(period, NULL, "Fixed period: period <us>", cmd_adcrate_period, 2, 0),
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+    SHELL_CMD_ARG(adaptive, NULL,
+                  "Adaptive: adaptive <fast_us> <slow_us> [delta_mv] [hold_frames]",
+                  cmd_adcrate_adaptive, 3, 2),
+#endif
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcrate, &adcrate_cmds, "Show or change the sampling period",
+                   cmd_adcrate_show);
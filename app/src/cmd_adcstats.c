@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcstats - Print sampling-loop latency and jitter
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include "sampler_stats.h"
+#include "sample_sched.h"
+#include "sample_proc.h"
+
+static const char *const stat_names[SAMPLER_STAT_COUNT] = {
+    [SAMPLER_STAT_SAMPLE] = "sample",
+    [SAMPLER_STAT_FILTER] = "filter",
+    [SAMPLER_STAT_UPDATE] = "update",
+    [SAMPLER_STAT_FRAME] = "frame",
+    [SAMPLER_STAT_JITTER] = "jitter",
+};
+
+static void print_stat(const struct shell *sh, enum sampler_stat_id id)
+{
+    struct sampler_stat st;
+
+    sampler_stats_get(id, &st);
+
+    if (st.count == 0) {
+        shell_print(sh, "  %-7s n=0", stat_names[id]);
+        return;
+    }
+
+    shell_print(sh, "  %-7s n=%u min=%d max=%d mean=%lld ns", stat_names[id],
+                st.count, st.min, st.max, st.sum / st.count);
+}
+
+static int cmd_adcstats(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sample_proc_status proc;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    sample_proc_get_status(&proc);
+
+    shell_print(sh, "Sampling Stats (period %u us, overruns %u):",
+                sample_sched_period_us(), sample_sched_overruns());
+    shell_print(sh, "  processed %u frames, %u skipped", proc.frames, proc.dropped);
+
+    for (int id = 0; id < SAMPLER_STAT_COUNT; id++) {
+        print_stat(sh, id);
+    }
+    shell_print(sh, "  %-7s n=%u (not in jitter)", "overrun", sampler_stats_overruns());
+
+    for (unsigned int ch = 0; ch < NUM_CH; ch++) {
+        struct sampler_ch_errors e;
+
+        sampler_stats_get_errors(ch, &e);
+        if (e.count != 0) {
+            shell_print(sh, "  ch[%u] errors=%u last_err=%d", ch, e.count, e.last_err);
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_adcstats_hist(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (int id = 0; id < SAMPLER_STAT_COUNT; id++) {
+        struct sampler_stat st;
+
+        sampler_stats_get(id, &st);
+        shell_print(sh, "%s (|ns|):", stat_names[id]);
+
+        for (int bin = 0; bin < SAMPLER_STATS_HIST_BINS; bin++) {
+            if (st.hist[bin] == 0) {
+                continue;
+            }
+            if (bin == 0) {
+                shell_print(sh, "  %10u            : %u", 0, st.hist[bin]);
+            } else {
+                shell_print(sh, "  %10u-%-10u : %u", (unsigned int)BIT(bin - 1),
+                            (unsigned int)(BIT(bin) - 1), st.hist[bin]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_adcstats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    sampler_stats_reset();
+    shell_print(sh, "Sampling stats reset");
+
+    return 0;
+}
+
+#if defined(CONFIG_APP_STACK_WATERMARKS)
+static void print_stack(const struct k_thread *thread, void *user_data)
+{
+    const struct shell *sh = user_data;
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    size_t size = thread->stack_info.size;
+    size_t unused;
+
+    if (k_thread_stack_space_get(thread, &unused) != 0) {
+        return;
+    }
+
+    shell_print(sh, "  %-16s %5zu / %5zu bytes (%zu%%)", (name != NULL) ? name : "?",
+                size - unused, size, (size != 0) ? (size - unused) * 100 / size : 0);
+}
+
+static int cmd_adcstats_stacks(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "Stack high-water marks (peak used / size):");
+    k_thread_foreach_unlocked(print_stack, (void *)sh);
+
+    return 0;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcstats_cmds,
+    SHELL_CMD(hist, NULL, "Print latency/jitter histograms", cmd_adcstats_hist),
+    SHELL_CMD(reset, NULL, "Clear all statistics and error counters", cmd_adcstats_reset),
+#if defined(CONFIG_APP_STACK_WATERMARKS)
+    SHELL_CMD(stacks, NULL, "Print each thread's peak stack usage", cmd_adcstats_stacks),
+#endif
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcstats, &adcstats_cmds,
+    "Print sampling-loop latency and jitter\n"
+    "Usage: adcstats [hist|reset|stacks]",
+    cmd_adcstats);
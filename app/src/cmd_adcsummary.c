@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcsummary - Per-channel statistics since the last read
+ */
+
+#include <zephyr/shell/shell.h>
+#include "chan_stats.h"
+
+static void print_summary(const struct shell *sh, bool reset)
+{
+    struct chan_stats_snapshot snap;
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, reset);
+
+    shell_print(sh, "Channel statistics over %u ms%s:", snap.duration_ms,
+                reset ? "" : " (still running)");
+    shell_print(sh, "  ch   samples      min      max     mean      rms  (mV)");
+
+    for (int i = 0; i < NUM_CH; i++) {
+        const struct chan_stats *st = &snap.ch[i];
+
+        if (st->count == 0) {
+            shell_print(sh, "  %2d %9u        -        -        -        -", i, 0);
+            continue;
+        }
+        shell_print(sh, "  %2d %9u %8d %8d %8d %8d", i, st->count,
+                    regs_raw_to_mv(i, st->min), regs_raw_to_mv(i, st->max),
+                    regs_raw_to_mv(i, st->mean), regs_raw_to_mv(i, st->rms));
+    }
+}
+
+static int cmd_adcsummary_read(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    print_summary(sh, true);
+    return 0;
+}
+
+static int cmd_adcsummary_peek(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    print_summary(sh, false);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcsummary_cmds,
+    SHELL_CMD(peek, NULL, "Show without starting a new window", cmd_adcsummary_peek),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcsummary, &adcsummary_cmds,
+                   "Min/max/mean/RMS per channel since the last read, then reset",
+                   cmd_adcsummary_read);
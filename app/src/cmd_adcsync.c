@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcsync - Multi-board sync status and pulse output
+ */
+
+#include <zephyr/shell/shell.h>
+#include "sync.h"
+#include "sample_sched.h"
+
+static int cmd_adcsync_status(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sync_status st;
+    uint32_t frame_us = sample_sched_period_us();
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    sync_get_status(&st);
+
+    shell_print(sh, "ADC Sync:");
+    shell_print(sh, "  locked:      %s", st.locked ? "yes" : "no");
+    shell_print(sh, "  output:      %s", st.output ? "driving" : "off");
+    shell_print(sh, "  period:      %u ms", st.period_ms);
+    shell_print(sh, "  train:       %u (edge %u, %u missed)", st.trains, st.edge, st.missed);
+    shell_print(sh, "  last edge:   %llu ns", st.last_edge_ns);
+    shell_print(sh, "  rate:        %d ppb", st.rate_ppb);
+    shell_print(sh, "  phase error: %d ns", st.phase_err_ns);
+
+    /* Ticks only land on common multiples if the frame period divides the sync period */
+    if ((st.period_ms * USEC_PER_MSEC) % frame_us != 0) {
+        shell_warn(sh, "Frame period %u us does not divide the sync period", frame_us);
+    }
+
+    return 0;
+}
+
+static int cmd_adcsync_start(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    if (sync_output_enable(true) < 0) {
+        shell_error(sh, "This board has no sync output (CONFIG_APP_SYNC_OUTPUT)");
+        return -ENOTSUP;
+    }
+
+    shell_print(sh, "Sync pulses started");
+    return 0;
+}
+
+static int cmd_adcsync_stop(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    if (sync_output_enable(false) < 0) {
+        shell_error(sh, "This board has no sync output (CONFIG_APP_SYNC_OUTPUT)");
+        return -ENOTSUP;
+    }
+
+    shell_print(sh, "Sync pulses stopped; a start after %u ms begins a new train",
+                CONFIG_APP_SYNC_PERIOD_MS * (CONFIG_APP_SYNC_MAX_MISSED_EDGES + 1));
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcsync_cmds,
+    SHELL_CMD(start, NULL, "Drive sync pulses (master only)", cmd_adcsync_start),
+    SHELL_CMD(stop, NULL, "Stop driving sync pulses", cmd_adcsync_stop),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcsync, &adcsync_cmds, "Multi-board sync status", cmd_adcsync_status);
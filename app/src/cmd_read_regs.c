@@ -19,10 +19,18 @@ static int cmd_adcregs(const struct shell *sh, size_t argc, char **argv)
     shell_print(sh, "ADC Register File:");
     shell_print(sh, "  seq:       %u", snapshot.seq);
     shell_print(sh, "  timestamp: %lld ms", snapshot.last_sample_uptime_ms);
+    shell_print(sh, "  start:     %llu ns", snapshot.timestamp_ns);
     shell_print(sh, "  channels:");
 
     for (int i = 0; i < NUM_CH; i++) {
-        shell_print(sh, "    ch[%d]: %d mV", i, snapshot.mv[i]);
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        shell_print(sh, "    ch[%d]: %d mV (raw %u) at +%u ns", i,
+                    regs_raw_to_mv(i, snapshot.raw[i]), snapshot.raw[i],
+                    snapshot.ch_offset_ns[i]);
+#else
+        shell_print(sh, "    ch[%d]: %d mV (raw %u)", i,
+                    regs_raw_to_mv(i, snapshot.raw[i]), snapshot.raw[i]);
+#endif
     }
 
     return 0;
@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcstream - Control the binary sample stream
+ */
+
+#include <zephyr/shell/shell.h>
+#include <string.h>
+#include "stream.h"
+
+static const char *const mode_names[] = {
+    [STREAM_MODE_FRAMES] = "frames",
+    [STREAM_MODE_STATS] = "stats",
+};
+
+/* start [frames|stats] */
+static int cmd_adcstream_start(const struct shell *sh, size_t argc, char **argv)
+{
+    enum stream_mode mode = STREAM_MODE_FRAMES;
+    int ret;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], mode_names[STREAM_MODE_STATS]) == 0) {
+            mode = STREAM_MODE_STATS;
+        } else if (strcmp(argv[1], mode_names[STREAM_MODE_FRAMES]) != 0) {
+            shell_error(sh, "Unknown mode %s", argv[1]);
+            return -EINVAL;
+        }
+    }
+
+    ret = stream_start(mode);
+    if (ret == -ENOTSUP) {
+        shell_error(sh, "STATS packets are disabled in this build");
+        return ret;
+    }
+    if (ret < 0) {
+        shell_error(sh, "Stream start failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Stream started (%s)", mode_names[mode]);
+    return 0;
+}
+
+static int cmd_adcstream_stop(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    stream_stop();
+    shell_print(sh, "Stream stopped");
+    return 0;
+}
+
+static int cmd_adcstream_status(const struct shell *sh, size_t argc, char **argv)
+{
+    struct stream_status st;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    stream_get_status(&st);
+
+    shell_print(sh, "ADC Stream:");
+    shell_print(sh, "  running:  %s", st.running ? "yes" : "no");
+    shell_print(sh, "  tx:       %s", st.async_tx ? "async" : "polled");
+    shell_print(sh, "  mode:     %s", mode_names[st.mode]);
+    shell_print(sh, "  frames:   %u (%u delta)", st.frames_sent, st.delta_sent);
+    shell_print(sh, "  bytes:    %u", st.bytes_sent);
+    shell_print(sh, "  dropped:  %u", st.dropped);
+    shell_print(sh, "  events:   %u", st.events_sent);
+    shell_print(sh, "  stats:    %u", st.stats_sent);
+    shell_print(sh, "  errors:   %u", st.tx_errors);
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcstream_cmds,
+    SHELL_CMD_ARG(start, NULL, "Start streaming: start [frames|stats]",
+                  cmd_adcstream_start, 1, 1),
+    SHELL_CMD(stop, NULL, "Stop streaming", cmd_adcstream_stop),
+    SHELL_CMD(status, NULL, "Show stream counters", cmd_adcstream_status),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcstream, &adcstream_cmds, "Binary sample stream control", NULL);
@@ -0,0 +1,267 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Filter Stage Implementation
+ *
+ * All channels advance together, one input per frame. Per channel, the
+ * FIR history is stored twice (hist[i] and hist[i + taps]) so the last
+ * `taps` samples are always one contiguous window and the inner product
+ * needs no wrap-around. The FIR is only evaluated on frames that are
+ * published, so decimation by D also divides its cost by D.
+ */
+
+#include "filter.h"
+#include "mem_placement.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/logging/log.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <cmsis_core.h>
+#define FILTER_USE_SMLAD 1
+#endif
+
+LOG_MODULE_REGISTER(filter, LOG_LEVEL_INF);
+
+#if defined(CONFIG_APP_FILTER_FIR)
+#define FILTER_DEFAULT_TYPE FILTER_FIR
+#elif defined(CONFIG_APP_FILTER_IIR)
+#define FILTER_DEFAULT_TYPE FILTER_IIR
+#else
+#define FILTER_DEFAULT_TYPE FILTER_BOXCAR
+#endif
+
+#ifdef CONFIG_APP_FILTER_DECIMATION
+#define FILTER_DEFAULT_DECIMATION CONFIG_APP_FILTER_DECIMATION
+#else
+#define FILTER_DEFAULT_DECIMATION 10
+#endif
+
+#ifdef CONFIG_APP_FILTER_FIR_TAPS
+#define FILTER_DEFAULT_FIR_TAPS CONFIG_APP_FILTER_FIR_TAPS
+#else
+#define FILTER_DEFAULT_FIR_TAPS 16
+#endif
+
+#ifdef CONFIG_APP_FILTER_IIR_SHIFT
+#define FILTER_DEFAULT_IIR_SHIFT CONFIG_APP_FILTER_IIR_SHIFT
+#else
+#define FILTER_DEFAULT_IIR_SHIFT 4
+#endif
+
+#define FILTER_MAX_DECIMATION 1000
+
+/* Fractional bits of the IIR state beyond Q15 */
+#define IIR_FRAC_BITS 8
+
+struct filter_channel {
+    int16_t hist[2 * FILTER_FIR_MAX_TAPS];  /* FIR history, stored twice */
+    int32_t acc;    /* Boxcar running sum, or IIR state in Q15.IIR_FRAC_BITS */
+    uint8_t shift;  /* Raw code -> Q15 left shift, 16 - resolution */
+};
+
+static struct filter_channel channels[NUM_CH] APP_FAST_BSS;
+static int16_t fir_taps[FILTER_FIR_MAX_TAPS] APP_FAST_BSS;
+
+static enum filter_type cur_type;
+static uint32_t cur_decimation;
+static uint32_t cur_param;    /* FIR taps or IIR shift */
+static uint32_t phase;        /* Inputs since the last published frame */
+static uint32_t fir_pos;      /* History slot the next input goes to */
+static bool primed;           /* State seeded from the first frame */
+
+static int16_t to_q15(uint16_t raw, uint8_t shift)
+{
+    int32_t x = ((int32_t)raw << shift) - 32768;
+
+    return (int16_t)CLAMP(x, INT16_MIN, INT16_MAX);
+}
+
+static uint16_t from_q15(int32_t y, uint8_t shift)
+{
+    uint32_t code;
+
+    y = CLAMP(y, INT16_MIN, INT16_MAX) + 32768;
+    code = ((uint32_t)y + (BIT(shift) >> 1)) >> shift;
+
+    return (uint16_t)MIN(code, 0xFFFFU >> shift);
+}
+
+/* Triangular window, normalized to unity DC gain in Q15 */
+static void fir_design(uint32_t taps)
+{
+    uint32_t half = taps / 2;
+    uint32_t weight_sum = half * (half + 1);
+    int32_t total = 0;
+
+    for (uint32_t k = 0; k < taps; k++) {
+        uint32_t w = MIN(k + 1, taps - k);
+
+        fir_taps[k] = (int16_t)((w << 15) / weight_sum);
+        total += fir_taps[k];
+    }
+
+    /* Put the rounding remainder on a centre tap */
+    fir_taps[half - 1] += (int16_t)(BIT(15) - total);
+}
+
+static int32_t fir_dot(const int16_t *x, const int16_t *h, uint32_t taps)
+{
+    int32_t acc = 0;
+
+#if defined(FILTER_USE_SMLAD)
+    /* Two 16x16 multiplies and a 32-bit accumulate per instruction */
+    for (uint32_t k = 0; k < taps; k += 2) {
+        uint32_t xx, hh;
+
+        memcpy(&xx, &x[k], sizeof(xx));
+        memcpy(&hh, &h[k], sizeof(hh));
+        acc = (int32_t)__SMLAD(xx, hh, (uint32_t)acc);
+    }
+#else
+    for (uint32_t k = 0; k < taps; k++) {
+        acc += (int32_t)x[k] * h[k];
+    }
+#endif
+
+    return acc;
+}
+
+/* Seed every filter with the first frame so there is no start-up ramp */
+static void filter_prime(const uint16_t in[NUM_CH])
+{
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        struct filter_channel *c = &channels[ch];
+        int16_t x = to_q15(in[ch], c->shift);
+
+        for (size_t k = 0; k < ARRAY_SIZE(c->hist); k++) {
+            c->hist[k] = x;
+        }
+        c->acc = (cur_type == FILTER_IIR) ? ((int32_t)x << IIR_FRAC_BITS) : 0;
+    }
+
+    primed = true;
+}
+
+int filter_configure(enum filter_type type, uint32_t decimation, uint32_t param)
+{
+    if (decimation == 0 || decimation > FILTER_MAX_DECIMATION) {
+        return -EINVAL;
+    }
+
+    switch (type) {
+    case FILTER_NONE:
+    case FILTER_BOXCAR:
+        break;
+    case FILTER_FIR:
+        if (param < 2 || param > FILTER_FIR_MAX_TAPS || (param & 1)) {
+            return -EINVAL;
+        }
+        fir_design(param);
+        break;
+    case FILTER_IIR:
+        if (param < 1 || param > 15) {
+            return -EINVAL;
+        }
+        break;
+    default:
+        return -EINVAL;
+    }
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        uint16_t ref_mv;
+        uint8_t resolution;
+
+        regs_get_scale(ch, &ref_mv, &resolution);
+        channels[ch].shift = 16 - resolution;
+    }
+
+    cur_type = type;
+    cur_decimation = decimation;
+    cur_param = param;
+    phase = 0;
+    fir_pos = 0;
+    primed = false;
+
+    return 0;
+}
+
+void filter_init(void)
+{
+    uint32_t param = (FILTER_DEFAULT_TYPE == FILTER_IIR) ? FILTER_DEFAULT_IIR_SHIFT
+                                                         : FILTER_DEFAULT_FIR_TAPS;
+    int ret = filter_configure(FILTER_DEFAULT_TYPE, FILTER_DEFAULT_DECIMATION, param);
+
+    if (ret < 0) {
+        LOG_ERR("Invalid filter configuration: %d", ret);
+        (void)filter_configure(FILTER_NONE, 1, 0);
+        return;
+    }
+
+    LOG_INF("Filter type %d, decimation %u (%s)", cur_type, cur_decimation,
+            IS_ENABLED(FILTER_USE_SMLAD) ? "SMLAD" : "scalar");
+}
+
+void filter_rescale(void)
+{
+    (void)filter_configure(cur_type, cur_decimation, cur_param);
+}
+
+bool filter_process(const uint16_t in[NUM_CH], uint16_t out[NUM_CH])
+{
+    bool publish = (++phase >= cur_decimation);
+    uint32_t next_pos = (fir_pos + 1 == cur_param) ? 0 : fir_pos + 1;
+
+    if (!primed) {
+        filter_prime(in);
+    }
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        struct filter_channel *c = &channels[ch];
+        int16_t x = to_q15(in[ch], c->shift);
+        int32_t y = x;
+
+        switch (cur_type) {
+        case FILTER_BOXCAR:
+            c->acc += x;
+            if (publish) {
+                y = c->acc / (int32_t)cur_decimation;
+                c->acc = 0;
+            }
+            break;
+        case FILTER_FIR:
+            c->hist[fir_pos] = x;
+            c->hist[fir_pos + cur_param] = x;
+            if (publish) {
+                /* Window of the last `taps` inputs starts after the newest */
+                y = (fir_dot(&c->hist[next_pos], fir_taps, cur_param) + BIT(14)) >> 15;
+            }
+            break;
+        case FILTER_IIR:
+            c->acc += (((int32_t)x << IIR_FRAC_BITS) - c->acc) >> cur_param;
+            y = (c->acc + BIT(IIR_FRAC_BITS - 1)) >> IIR_FRAC_BITS;
+            break;
+        default:
+            break;
+        }
+
+        if (publish) {
+            out[ch] = from_q15(y, c->shift);
+        }
+    }
+
+    if (cur_type == FILTER_FIR) {
+        fir_pos = next_pos;
+    }
+    if (publish) {
+        phase = 0;
+    }
+
+    return publish;
+}
+
+uint32_t filter_decimation(void)
+{
+    return cur_decimation;
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Filter Stage - Per-channel decimating filters on the sample path
+ *
+ * Sits between adc_backend_sample() and regs_update(). Every frame is
+ * filtered at the full sampling rate; only every FILTER_DECIMATION-th
+ * result is published, so the register file, sample ring and stream
+ * carry the decimated rate. Samples are processed as Q15 (offset-removed
+ * full scale of the channel's resolution). The FIR inner product uses the
+ * SMLAD dual multiply-accumulate when the core has the DSP extension
+ * (Cortex-M7 on nucleo_h723zg) and a scalar loop elsewhere.
+ */
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "regs.h"
+
+/* Maximum FIR length; taps are processed in pairs */
+#define FILTER_FIR_MAX_TAPS 64
+
+/**
+ * @brief Filter applied to every channel
+ */
+enum filter_type {
+    FILTER_NONE,    /* Pass through; decimation still applies */
+    FILTER_BOXCAR,  /* Mean of each block of `decimation` inputs */
+    FILTER_FIR,     /* Triangular-window low-pass */
+    FILTER_IIR,     /* One-pole low-pass, y += (x - y) >> shift */
+};
+
+#if defined(CONFIG_APP_FILTER)
+
+/**
+ * @brief Configure the filter stage from Kconfig and reset its state
+ *
+ * Must be called after adc_backend_init(), which sets the channel
+ * resolutions the Q15 conversion depends on.
+ */
+void filter_init(void);
+
+/**
+ * @brief Select a filter and decimation at runtime and reset state
+ *
+ * Not reentrant with filter_process(); call from the sampling thread or
+ * before it starts.
+ *
+ * @param type       Filter applied to every channel
+ * @param decimation Publish one frame per this many inputs (1-1000)
+ * @param param      FIR: number of taps (even, 2-FILTER_FIR_MAX_TAPS);
+ *                   IIR: shift (1-15); ignored otherwise
+ * @return 0 on success, -EINVAL on an out-of-range argument
+ */
+int filter_configure(enum filter_type type, uint32_t decimation, uint32_t param);
+
+/**
+ * @brief Pick up changed channel resolutions and reset state
+ *
+ * Keeps the current filter and decimation. Same threading rules as
+ * filter_configure().
+ */
+void filter_rescale(void);
+
+/**
+ * @brief Feed one frame through the filters
+ *
+ * @param in  Raw codes sampled this frame
+ * @param out Receives the filtered codes when a decimated frame is due
+ * @return true if @p out holds a frame to publish
+ */
+bool filter_process(const uint16_t in[NUM_CH], uint16_t out[NUM_CH]);
+
+/**
+ * @brief Get the current decimation factor
+ *
+ * @return Input frames per published frame
+ */
+uint32_t filter_decimation(void);
+
+#else
+
+static inline void filter_init(void) {}
+static inline void filter_rescale(void) {}
+static inline uint32_t filter_decimation(void) { return 1; }
+
+#endif /* CONFIG_APP_FILTER */
+
+#endif /* FILTER_H_ */
@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Frame Packing Implementation
+ */
+
+#include "frame_pack.h"
+#include <errno.h>
+
+static inline uint16_t clamp12(uint16_t v)
+{
+    return (v > FRAME_PACK12_MAX) ? FRAME_PACK12_MAX : v;
+}
+
+void frame_pack(const uint16_t *raw, size_t n, bool pack12, uint8_t *out)
+{
+    if (!pack12) {
+        for (size_t i = 0; i < n; i++) {
+            *out++ = raw[i] & 0xFF;
+            *out++ = raw[i] >> 8;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i += 2) {
+        uint16_t a = clamp12(raw[i]);
+
+        *out++ = a & 0xFF;
+        if (i + 1 < n) {
+            uint16_t b = clamp12(raw[i + 1]);
+
+            *out++ = (a >> 8) | ((b & 0x0F) << 4);
+            *out++ = b >> 4;
+        } else {
+            *out++ = a >> 8;
+        }
+    }
+}
+
+void frame_unpack(const uint8_t *in, size_t n, bool pack12, uint16_t *raw)
+{
+    if (!pack12) {
+        for (size_t i = 0; i < n; i++, in += 2) {
+            raw[i] = in[0] | (in[1] << 8);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < n; i += 2, in += 3) {
+        raw[i] = in[0] | ((in[1] & 0x0F) << 8);
+        if (i + 1 < n) {
+            raw[i + 1] = (in[1] >> 4) | (in[2] << 4);
+        }
+    }
+}
+
+size_t frame_varint_put(uint64_t v, uint8_t *out)
+{
+    size_t len = 0;
+
+    while (v >= 0x80) {
+        out[len++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    out[len++] = (uint8_t)v;
+
+    return len;
+}
+
+int frame_varint_get(const uint8_t *in, size_t len, uint64_t *v)
+{
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < len && i < FRAME_VARINT_MAX_SIZE; i++) {
+        value |= (uint64_t)(in[i] & 0x7F) << (7 * i);
+        if ((in[i] & 0x80) == 0) {
+            *v = value;
+            return (int)(i + 1);
+        }
+    }
+
+    return -EINVAL;
+}
+
+size_t frame_delta_encode(const uint16_t *raw, const uint16_t *prev, size_t n,
+                          uint8_t *out, size_t max)
+{
+    uint8_t tmp[FRAME_VARINT_MAX_SIZE];
+    size_t len = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t w = frame_varint_put(frame_zigzag((int32_t)raw[i] - prev[i]), tmp);
+
+        if (len + w > max) {
+            return 0;
+        }
+        for (size_t j = 0; j < w; j++) {
+            out[len++] = tmp[j];
+        }
+    }
+
+    return len;
+}
+
+int frame_delta_decode(const uint8_t *in, size_t len, const uint16_t *prev, size_t n,
+                       uint16_t *raw)
+{
+    size_t pos = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t u;
+        int64_t value;
+        int w = frame_varint_get(&in[pos], len - pos, &u);
+
+        if (w < 0) {
+            return w;
+        }
+        pos += w;
+
+        value = prev[i] + frame_unzigzag(u);
+        if (value < 0 || value > UINT16_MAX) {
+            return -EINVAL;
+        }
+        raw[i] = (uint16_t)value;
+    }
+
+    return (int)pos;
+}
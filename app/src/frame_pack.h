@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Frame Packing - Compact encodings of one frame's raw codes
+ *
+ * Two encodings, shared by the sample ring (sample_ring.h) and the
+ * stream (stream_proto.h):
+ *
+ * - Packed: 12-bit codes two per 3 bytes (v0[7:0], v0[11:8] | v1[3:0] << 4,
+ *   v1[11:4]), an odd trailing code in 2 bytes; or with pack12 false,
+ *   2 bytes little-endian per code. Fixed size, random access.
+ * - Delta: per channel, the difference from the previous frame's code,
+ *   zigzag-mapped to unsigned (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...) and
+ *   written as a LEB128 varint (7 bits per byte, low bits first, bit 7
+ *   set on all but the last byte). A channel that moved by less than
+ *   64 codes takes one byte. Needs the previous frame to decode.
+ *
+ * Plain C with no kernel dependencies, so host tools can build it as is;
+ * the stream decoder in tools/adc_stream.py is the Python counterpart.
+ */
+
+#ifndef FRAME_PACK_H_
+#define FRAME_PACK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Widest code the 12-bit packing holds; larger codes are clamped */
+#define FRAME_PACK12_BITS 12
+#define FRAME_PACK12_MAX  0xFFF
+
+/** Bytes taken by @p n packed codes */
+#define FRAME_PACKED_SIZE(n, pack12) ((pack12) ? ((n) * 3 + 1) / 2 : (n) * 2)
+
+/** Longest varint of a 64-bit value */
+#define FRAME_VARINT_MAX_SIZE 10
+
+/** Longest delta encoding of @p n 16-bit codes (zigzag of +-65535 is 17 bits) */
+#define FRAME_DELTA_MAX_SIZE(n) ((n) * 3)
+
+/**
+ * @brief Map a signed value to unsigned, small magnitudes to small values
+ */
+static inline uint64_t frame_zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+/**
+ * @brief Inverse of frame_zigzag()
+ */
+static inline int64_t frame_unzigzag(uint64_t u)
+{
+    return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+}
+
+/**
+ * @brief Pack raw codes
+ *
+ * @param raw    Codes to pack
+ * @param n      Number of codes
+ * @param pack12 True for 12-bit packing (codes above FRAME_PACK12_MAX
+ *               are clamped), false for 2 bytes per code
+ * @param out    Receives FRAME_PACKED_SIZE(n, pack12) bytes
+ */
+void frame_pack(const uint16_t *raw, size_t n, bool pack12, uint8_t *out);
+
+/**
+ * @brief Unpack codes written by frame_pack()
+ *
+ * @param in     FRAME_PACKED_SIZE(n, pack12) bytes
+ * @param n      Number of codes
+ * @param pack12 Packing used by frame_pack()
+ * @param raw    Receives @p n codes
+ */
+void frame_unpack(const uint8_t *in, size_t n, bool pack12, uint16_t *raw);
+
+/**
+ * @brief Write a varint
+ *
+ * @param v   Value
+ * @param out Receives up to FRAME_VARINT_MAX_SIZE bytes
+ * @return Bytes written
+ */
+size_t frame_varint_put(uint64_t v, uint8_t *out);
+
+/**
+ * @brief Read a varint
+ *
+ * @param in  Input bytes
+ * @param len Bytes available at @p in
+ * @param v   Receives the value
+ * @return Bytes read, or -EINVAL if the varint is truncated or longer
+ *         than FRAME_VARINT_MAX_SIZE
+ */
+int frame_varint_get(const uint8_t *in, size_t len, uint64_t *v);
+
+/**
+ * @brief Delta-encode raw codes against the previous frame's
+ *
+ * @param raw  Codes to encode
+ * @param prev Previous frame's codes
+ * @param n    Number of codes
+ * @param out  Output buffer
+ * @param max  Size of @p out
+ * @return Bytes written, or 0 if the encoding does not fit in @p max
+ *         (callers pass the packed size to fall back to packing)
+ */
+size_t frame_delta_encode(const uint16_t *raw, const uint16_t *prev, size_t n,
+                          uint8_t *out, size_t max);
+
+/**
+ * @brief Decode codes written by frame_delta_encode()
+ *
+ * @param in   Input bytes
+ * @param len  Bytes available at @p in
+ * @param prev Previous frame's codes
+ * @param n    Number of codes
+ * @param raw  Receives @p n codes; may be the same array as @p prev
+ * @return Bytes read, or -EINVAL if the input is truncated or malformed
+ */
+int frame_delta_decode(const uint8_t *in, size_t len, const uint16_t *prev, size_t n,
+                       uint16_t *raw);
+
+#endif /* FRAME_PACK_H_ */
@@ -8,12 +8,44 @@
 #include <zephyr/logging/log.h>
 #include "regs.h"
 #include "adc_backend.h"
+#include "sample_sched.h"
+#include "sampler_stats.h"
+#include "filter.h"
+#include "threshold.h"
+#include "sampler_config.h"
+#include "capture.h"
+#include "chan_stats.h"
+#include "sync.h"
+#include "stream.h"
+#include "sample_proc.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
-/* Sampling thread configuration */
-#define SAMPLE_THREAD_STACK_SIZE 1024
-#define SAMPLE_THREAD_PRIORITY   5
+/*
+ * Sampling (acquisition) thread priority. Cooperative priorities are
+ * counted below the meta-IRQ ones so the two classes never overlap.
+ */
+#if defined(CONFIG_APP_SAMPLE_THREAD_META_IRQ)
+#define SAMPLE_THREAD_PRIORITY (K_HIGHEST_THREAD_PRIO + CONFIG_APP_SAMPLE_THREAD_PRIORITY)
+BUILD_ASSERT(CONFIG_APP_SAMPLE_THREAD_PRIORITY < CONFIG_NUM_METAIRQ_PRIORITIES,
+             "Sampling thread priority beyond the meta-IRQ priorities");
+#elif defined(CONFIG_APP_SAMPLE_THREAD_COOP)
+#define SAMPLE_THREAD_PRIORITY \
+    K_PRIO_COOP(CONFIG_NUM_METAIRQ_PRIORITIES + CONFIG_APP_SAMPLE_THREAD_PRIORITY)
+BUILD_ASSERT(CONFIG_NUM_METAIRQ_PRIORITIES + CONFIG_APP_SAMPLE_THREAD_PRIORITY <
+             CONFIG_NUM_COOP_PRIORITIES,
+             "Sampling thread priority beyond the cooperative priorities");
+#else
+#define SAMPLE_THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_APP_SAMPLE_THREAD_PRIORITY)
+BUILD_ASSERT(CONFIG_APP_SAMPLE_THREAD_PRIORITY < CONFIG_NUM_PREEMPT_PRIORITIES,
+             "Sampling thread priority beyond the preemptible priorities");
+#endif
+
+#if defined(CONFIG_APP_SAMPLE_PROC_THREAD)
+/* Consumer load must never delay a conversion */
+BUILD_ASSERT(CONFIG_APP_SAMPLE_PROC_THREAD_PRIORITY > SAMPLE_THREAD_PRIORITY,
+             "Processing thread must have a lower priority than the sampling thread");
+#endif
 
 #ifdef CONFIG_APP_SAMPLE_PERIOD_MS
 #define SAMPLE_PERIOD_MS CONFIG_APP_SAMPLE_PERIOD_MS
@@ -22,13 +54,18 @@ LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 #endif
 
 /* Sampling thread stack and data */
-K_THREAD_STACK_DEFINE(sample_thread_stack, SAMPLE_THREAD_STACK_SIZE);
+K_THREAD_STACK_DEFINE(sample_thread_stack, CONFIG_APP_SAMPLE_THREAD_STACK_SIZE);
 static struct k_thread sample_thread_data;
 
 /**
  * @brief Sampling thread entry point
  *
- * Periodically samples all ADC channels and updates the register file.
+ * Samples the active ADC channels due on each scheduler tick (see rate
+ * groups in sample_sched.h) and updates the register file. Channels not
+ * due or not active keep their previous value in the frame. Only the
+ * work that shapes or watches each frame as it is taken runs here;
+ * statistics and rate control follow in the processing stage
+ * (sample_proc.h).
  */
 static void sample_thread_entry(void *p1, void *p2, void *p3)
 {
@@ -36,20 +73,102 @@ static void sample_thread_entry(void *p1, void *p2, void *p3)
     ARG_UNUSED(p2);
     ARG_UNUSED(p3);
 
-    int32_t samples[NUM_CH];
+    uint16_t samples[NUM_CH] = {0};
+#if defined(CONFIG_APP_FILTER)
+    uint16_t filtered[NUM_CH];
+#endif
+    const uint16_t *frame;
+#if defined(CONFIG_APP_THRESHOLDS)
+    struct regs_borrow published;
+#endif
+    uint64_t t_wake, t_sample, t_filter, t_update, t_done;
+    uint64_t t_frame;
+    struct regs_stamp stamp;
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    uint32_t ch_offset_ns[NUM_CH];
+#endif
+    uint32_t sampled;
+    uint32_t ticks;
+    bool publish;
     int ret;
 
+    ret = sample_sched_start(SAMPLE_PERIOD_MS * USEC_PER_MSEC);
+    if (ret != 0) {
+        LOG_ERR("Sampling scheduler start failed: %d", ret);
+        return;
+    }
+
     LOG_INF("Sampling thread started (period=%d ms)", SAMPLE_PERIOD_MS);
 
+    sampler_stats_init();
+    t_wake = sampler_stats_now();
+
     while (1) {
-        ret = adc_backend_sample_all(samples);
-        if (ret == 0) {
-            regs_update(samples);
-        } else {
+        /* Runtime configuration changes land between frames */
+        sampler_config_apply();
+
+        /* An armed burst capture owns the converter until it completes */
+        if (capture_run()) {
+            t_wake = sampler_stats_now();
+        }
+
+        sampled = sample_sched_due() & sampler_config_channels();
+        t_frame = regs_clock_ns();
+        t_sample = sampler_stats_now();
+        ret = adc_backend_sample(sampled, samples);
+        t_filter = sampler_stats_now();
+        publish = (ret == 0);
+        frame = samples;
+#if defined(CONFIG_APP_FILTER)
+        /* Only decimated frames reach the register file */
+        if (publish) {
+            publish = filter_process(samples, filtered);
+            frame = filtered;
+        }
+#endif
+        t_update = sampler_stats_now();
+        if (publish) {
+            /* A filtered frame is stamped with its newest input frame */
+            stamp.timestamp_ns = sync_time_ns(t_frame, &stamp.synced);
+            /* A filtered frame carries a fresh value for every active channel */
+            stamp.sampled = IS_ENABLED(CONFIG_APP_FILTER) ? sampler_config_channels() : sampled;
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+            adc_backend_channel_offsets(t_frame, ch_offset_ns);
+            stamp.ch_offset_ns = ch_offset_ns;
+#else
+            stamp.ch_offset_ns = NULL;
+#endif
+            regs_update_at(frame, &stamp);
+#if defined(CONFIG_APP_THRESHOLDS)
+            /*
+             * Alarms stay with the conversion: the analog watchdog's
+             * tripped flags cover exactly the frames taken since the
+             * previous evaluation. This thread is the only writer, so
+             * the borrow cannot be lapped.
+             */
+            regs_acquire(&published);
+            threshold_evaluate(published.frame);
+            (void)regs_release(&published);
+#endif
+            sample_proc_notify();
+        } else if (ret != 0) {
             LOG_ERR("ADC sample failed: %d", ret);
         }
+        t_done = sampler_stats_now();
+
+        sampler_stats_record(SAMPLER_STAT_SAMPLE, t_sample, t_filter);
+        if (IS_ENABLED(CONFIG_APP_FILTER)) {
+            sampler_stats_record(SAMPLER_STAT_FILTER, t_filter, t_update);
+        }
+        if (publish) {
+            sampler_stats_record(SAMPLER_STAT_UPDATE, t_update, t_done);
+        }
+        sampler_stats_record(SAMPLER_STAT_FRAME, t_wake, t_done);
+
+        ticks = sample_sched_wait();
 
-        k_msleep(SAMPLE_PERIOD_MS);
+        t_wake = sampler_stats_now();
+        sampler_stats_wakeup(t_wake, sample_sched_period_us(), ticks);
     }
 }
 
@@ -69,6 +188,37 @@ int main(void)
         return ret;
     }
 
+    /* Filter state depends on the channel resolutions set by the backend */
+    filter_init();
+
+#if defined(CONFIG_APP_THRESHOLDS)
+    threshold_init();
+#endif
+
+    chan_stats_init();
+
+    /* Frames are fed to statistics and rate control from here on */
+    sample_proc_init();
+
+#if defined(CONFIG_APP_SYNC)
+    /* Without the sync line frames keep local timestamps */
+    ret = sync_init();
+    if (ret != 0) {
+        LOG_ERR("Sync init failed: %d", ret);
+    }
+#endif
+
+    /* Saved parameters are applied by the sampling thread's first frame */
+    (void)sampler_config_init();
+
+#if defined(CONFIG_APP_STREAM)
+    /* Binary stream is optional; keep sampling if its UART is missing */
+    ret = stream_init();
+    if (ret != 0) {
+        LOG_ERR("Stream init failed: %d", ret);
+    }
+#endif
+
     /* Start sampling thread */
     k_thread_create(&sample_thread_data, sample_thread_stack,
                     K_THREAD_STACK_SIZEOF(sample_thread_stack),
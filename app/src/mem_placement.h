@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Memory Placement - Section attributes for hot-path state and DMA buffers
+ *
+ * APP_FAST_BSS puts CPU-only state touched every frame (register file,
+ * sample ring, filter state) in DTCM: zero wait states and never cached,
+ * so access time does not depend on cache contents. DTCM is not
+ * reachable by DMA1/DMA2, so DMA targets use APP_DMA_BSS instead, which
+ * places them in a non-cacheable region the DMA can reach. Both expand
+ * to nothing on targets without those regions (qemu_x86, unit tests).
+ */
+
+#ifndef MEM_PLACEMENT_H_
+#define MEM_PLACEMENT_H_
+
+#include <zephyr/devicetree.h>
+#include <zephyr/linker/section_tags.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+#if defined(CONFIG_APP_FAST_DATA_DTCM)
+#define APP_FAST_BSS __dtcm_bss_section
+#else
+#define APP_FAST_BSS
+#endif
+
+/* Cache line size of the Cortex-M7 L1 D-cache */
+#define APP_DMA_ALIGN 32
+
+#if defined(CONFIG_APP_DMA_BUFFER_SRAM1)
+#include <zephyr/linker/devicetree_regions.h>
+/*
+ * D2 SRAM1, marked non-cacheable by its zephyr,memory-attr in the board
+ * overlay. The region is not zeroed at boot; DMA overwrites it anyway.
+ */
+#define APP_DMA_BSS                                                       \
+    Z_GENERIC_SECTION(LINKER_DT_NODE_REGION_NAME(DT_NODELABEL(sram1)))   \
+    __aligned(APP_DMA_ALIGN)
+#elif defined(CONFIG_NOCACHE_MEMORY)
+/* Zephyr's .nocache section, mapped non-cacheable by the MPU */
+#define APP_DMA_BSS __nocache __aligned(APP_DMA_ALIGN)
+#else
+#define APP_DMA_BSS
+#endif
+
+#endif /* MEM_PLACEMENT_H_ */
@@ -2,47 +2,199 @@
  * SPDX-License-Identifier: Apache-2.0
  *
  * ADC Register File Implementation
+ *
+ * Lock-free single-writer register file built as a seqcount latch: two
+ * copies of struct adc_regs and a sequence counter. The writer bumps the
+ * counter before rewriting each copy, so at any instant one copy is
+ * stable and readers pick it by the counter's low bit. The writer never
+ * blocks and a reader only retries if the writer completes a step while
+ * it is copying, never because the writer was preempted mid-update.
  */
 
 #include "regs.h"
+#include "sample_ring.h"
+#include "mem_placement.h"
 #include <string.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+
+/* Latch sequence: odd while copy 0 is being written, even otherwise */
+static atomic_t regs_latch APP_FAST_BSS;
+
+/* The two copies of the register file instance */
+static struct adc_regs regs[2] APP_FAST_BSS;
+
+/* Writer-side shadow of the latest state (only touched by the writer) */
+static struct adc_regs regs_next APP_FAST_BSS;
+
+/* Per-channel scale, written at init only */
+struct channel_scale {
+    uint32_t mv_q16;     /* Millivolts per code, Q16 fixed point */
+    uint16_t ref_mv;
+    uint8_t resolution;
+};
+
+static struct channel_scale scales[NUM_CH];
+
+static void regs_publish(const struct adc_regs *src)
+{
+    /* Steer readers to copy 1 while copy 0 is rewritten... */
+    atomic_inc(&regs_latch);
+    memcpy(&regs[0], src, sizeof(regs[0]));
+
+    /* ...then back to copy 0 while copy 1 catches up */
+    atomic_inc(&regs_latch);
+    memcpy(&regs[1], src, sizeof(regs[1]));
+}
 
-/* Mutex protecting the register file */
-static K_MUTEX_DEFINE(regs_mutex);
+void regs_set_scale(unsigned int ch, uint16_t ref_mv, uint8_t resolution)
+{
+    uint32_t full_scale;
 
-/* The register file instance */
-static struct adc_regs regs;
+    if (ch >= NUM_CH || resolution == 0 || resolution > 16) {
+        return;
+    }
+    full_scale = BIT(resolution) - 1;
+
+    scales[ch].mv_q16 = (((uint32_t)ref_mv << 16) + full_scale / 2) / full_scale;
+    scales[ch].ref_mv = ref_mv;
+    scales[ch].resolution = resolution;
+}
+
+void regs_get_scale(unsigned int ch, uint16_t *ref_mv, uint8_t *resolution)
+{
+    if (ch >= NUM_CH) {
+        ch = 0;
+    }
+
+    *ref_mv = scales[ch].ref_mv;
+    *resolution = scales[ch].resolution;
+}
+
+int32_t regs_raw_to_mv(unsigned int ch, uint16_t raw)
+{
+    if (ch >= NUM_CH) {
+        return 0;
+    }
+
+    return (int32_t)(((uint32_t)raw * scales[ch].mv_q16 + BIT(15)) >> 16);
+}
 
 void regs_init(void)
 {
-    k_mutex_lock(&regs_mutex, K_FOREVER);
+    for (unsigned int ch = 0; ch < NUM_CH; ch++) {
+        regs_set_scale(ch, REGS_DEFAULT_REF_MV, REGS_DEFAULT_RESOLUTION);
+    }
 
-    memset(&regs, 0, sizeof(regs));
-    regs.seq = 0;
-    regs.last_sample_uptime_ms = 0;
+    memset(&regs_next, 0, sizeof(regs_next));
+    regs_next.seq = 0;
+    regs_next.last_sample_uptime_ms = 0;
 
-    k_mutex_unlock(&regs_mutex);
+    regs_publish(&regs_next);
+    sample_ring_init();
 }
 
-void regs_update(const int32_t mv[NUM_CH])
+void regs_update(const uint16_t raw[NUM_CH])
 {
-    k_mutex_lock(&regs_mutex, K_FOREVER);
+    struct regs_stamp stamp = {
+        .timestamp_ns = regs_clock_ns(),
+        .synced = false,
+        .sampled = BIT_MASK(NUM_CH),
+        .ch_offset_ns = NULL,
+    };
+
+    regs_update_at(raw, &stamp);
+}
 
+void regs_update_at(const uint16_t raw[NUM_CH], const struct regs_stamp *stamp)
+{
+    for (int i = 0; i < NUM_CH; i++) {
+        regs_next.raw[i] = raw[i];
+    }
+    regs_next.seq++;
+    regs_next.last_sample_uptime_ms = k_uptime_get();
+    regs_next.timestamp_ns = stamp->timestamp_ns;
+    regs_next.synced = stamp->synced;
+    regs_next.sampled = stamp->sampled;
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
     for (int i = 0; i < NUM_CH; i++) {
-        regs.mv[i] = mv[i];
+        regs_next.ch_offset_ns[i] = (stamp->ch_offset_ns != NULL) ? stamp->ch_offset_ns[i] : 0;
     }
-    regs.seq++;
-    regs.last_sample_uptime_ms = k_uptime_get();
+#endif
 
-    k_mutex_unlock(&regs_mutex);
+    regs_publish(&regs_next);
+    sample_ring_push(&regs_next);
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+void regs_channel_offsets(const uint64_t conv_ns[NUM_CH], uint64_t start_ns,
+                          uint32_t offset_ns[NUM_CH])
+{
+    for (int i = 0; i < NUM_CH; i++) {
+        offset_ns[i] = (conv_ns[i] > start_ns) ?
+                       (uint32_t)MIN(conv_ns[i] - start_ns, UINT32_MAX) : 0;
+    }
 }
+#endif
 
 void regs_read(struct adc_regs *out)
 {
-    k_mutex_lock(&regs_mutex, K_FOREVER);
+    atomic_val_t start;
+
+    do {
+        start = atomic_get(&regs_latch);
+        memcpy(out, &regs[start & 1], sizeof(*out));
+        barrier_dmem_fence_full();
+    } while (atomic_get(&regs_latch) != start);
+}
 
-    memcpy(out, &regs, sizeof(regs));
+size_t regs_read_batch(uint32_t since_seq, struct adc_regs *out, size_t max)
+{
+    struct sample_ring_reader rd = {
+        .next_seq = since_seq + 1,
+        .dropped = 0,
+    };
 
-    k_mutex_unlock(&regs_mutex);
+    return sample_ring_read(&rd, out, max);
 }
 
+const struct adc_regs *regs_acquire(struct regs_borrow *b)
+{
+    /* The copy regs_read() would take; the next regs_publish() rewrites both */
+    b->latch = (uint32_t)atomic_get(&regs_latch);
+    b->frame = &regs[b->latch & 1];
+    b->seq = b->frame->seq;
+
+    return b->frame;
+}
+
+bool regs_release(const struct regs_borrow *b)
+{
+    barrier_dmem_fence_full();
+
+    return (uint32_t)atomic_get(&regs_latch) == b->latch;
+}
+
+uint16_t regs_get_raw(unsigned int ch, uint32_t *seq)
+{
+    atomic_val_t start;
+    uint16_t raw;
+    uint32_t frame_seq;
+
+    if (ch >= NUM_CH) {
+        return 0;
+    }
+
+    do {
+        start = atomic_get(&regs_latch);
+        raw = regs[start & 1].raw[ch];
+        frame_seq = regs[start & 1].seq;
+        barrier_dmem_fence_full();
+    } while (atomic_get(&regs_latch) != start);
+
+    if (seq != NULL) {
+        *seq = frame_seq;
+    }
+
+    return raw;
+}
@@ -1,13 +1,14 @@
 /*
  * SPDX-License-Identifier: Apache-2.0
  *
- * ADC Register File - Thread-safe storage for ADC samples
+ * ADC Register File - Lock-free storage for ADC samples
  */
 
 #ifndef REGS_H_
 #define REGS_H_
 
 #include <zephyr/kernel.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef CONFIG_APP_NUM_CH
@@ -16,42 +17,210 @@
 #define NUM_CH 4
 #endif
 
+/* Default channel scale until the backend calls regs_set_scale() */
+#define REGS_DEFAULT_REF_MV     3300
+#define REGS_DEFAULT_RESOLUTION 12
+
 /**
  * @brief ADC register file structure
  *
- * Stores the latest ADC sample values and metadata.
- * Access must be protected by the regs API functions.
+ * Stores the latest raw ADC codes and metadata. Codes are converted to
+ * millivolts only when read, with regs_raw_to_mv().
+ * Access must go through the regs API functions.
  */
 struct adc_regs {
-    int32_t mv[NUM_CH];             /* Latest mV per channel */
+    uint16_t raw[NUM_CH];           /* Latest raw ADC code per channel */
+    uint16_t sampled;               /* Channels converted for this frame (bit n = ch n) */
     uint32_t seq;                   /* Sequence number, increments each update */
     int64_t last_sample_uptime_ms;  /* Timestamp of last update (k_uptime_get()) */
+    uint64_t timestamp_ns;          /* Frame start (regs_clock_ns(), or sync time) */
+    bool synced;                    /* timestamp_ns is in the sync timebase (sync.h) */
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    uint32_t ch_offset_ns[NUM_CH];  /* Each channel's conversion after timestamp_ns */
+#endif
 };
 
 /**
  * @brief Initialize the register file
  *
- * Must be called before any other regs_* functions.
+ * Must be called before any other regs_* functions. Also empties the
+ * sample ring and resets every channel to the default scale.
  */
 void regs_init(void);
 
+/**
+ * @brief Set the code-to-millivolt scale of a channel
+ *
+ * Called by the ADC backend during init. Precomputes a Q16 fixed-point
+ * factor so conversion is one multiply and shift.
+ *
+ * @param ch         Channel number (0 to NUM_CH-1)
+ * @param ref_mv     Full-scale reference voltage in mV
+ * @param resolution Conversion resolution in bits (1-16)
+ */
+void regs_set_scale(unsigned int ch, uint16_t ref_mv, uint8_t resolution);
+
+/**
+ * @brief Get the scale of a channel
+ *
+ * @param ch         Channel number (0 to NUM_CH-1)
+ * @param ref_mv     Receives the full-scale reference voltage in mV
+ * @param resolution Receives the conversion resolution in bits
+ */
+void regs_get_scale(unsigned int ch, uint16_t *ref_mv, uint8_t *resolution);
+
+/**
+ * @brief Convert a raw code of a channel to millivolts
+ *
+ * @param ch  Channel number (0 to NUM_CH-1)
+ * @param raw Raw ADC code
+ * @return Value in millivolts, rounded to nearest
+ */
+int32_t regs_raw_to_mv(unsigned int ch, uint16_t raw);
+
+/**
+ * @brief Read the frame clock
+ *
+ * Nanoseconds since boot from k_cycle_get_64() where the system timer
+ * has a 64-bit cycle counter (HPET on qemu_x86, SysTick on the STM32H7
+ * at one CPU cycle). Elsewhere it falls back to the tick counter.
+ * Monotonic and does not wrap in practice.
+ *
+ * @return Nanoseconds since boot
+ */
+static inline uint64_t regs_clock_ns(void)
+{
+#if defined(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)
+    return k_cyc_to_ns_floor64(k_cycle_get_64());
+#else
+    return k_ticks_to_ns_floor64(k_uptime_ticks());
+#endif
+}
+
+/**
+ * @brief When a frame was sampled, for regs_update_at()
+ */
+struct regs_stamp {
+    uint64_t timestamp_ns;         /* Frame start, from regs_clock_ns() or sync_time_ns() */
+    bool synced;                   /* timestamp_ns is sync time */
+    uint16_t sampled;              /* Channels with a fresh value; the rest are held */
+    const uint32_t *ch_offset_ns;  /* NUM_CH conversion times after timestamp_ns,
+                                    * or NULL for 0; ignored without
+                                    * CONFIG_APP_CHANNEL_TIMESTAMPS */
+};
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/**
+ * @brief Turn conversion times into a frame's per-channel offsets
+ *
+ * Shared by the backends' adc_backend_channel_offsets(), which keep one
+ * conversion time per channel but time the conversions differently.
+ *
+ * @param conv_ns   Conversion start of each channel in its latest frame,
+ *                  from regs_clock_ns()
+ * @param start_ns  Frame start the offsets are relative to
+ * @param offset_ns Receives NUM_CH offsets from @p start_ns, saturated
+ *                  at UINT32_MAX; 0 for channels not converted since then
+ */
+void regs_channel_offsets(const uint64_t conv_ns[NUM_CH], uint64_t start_ns,
+                          uint32_t offset_ns[NUM_CH]);
+#endif
+
 /**
  * @brief Update the register file with new samples
  *
- * Thread-safe. Updates all channel values atomically.
+ * Same as regs_update_at() with the frame clock read now, not synced,
+ * every channel fresh and no per-channel offsets.
+ *
+ * @param raw Array of NUM_CH raw ADC codes
+ */
+void regs_update(const uint16_t raw[NUM_CH]);
+
+/**
+ * @brief Update the register file with new samples taken at a given time
+ *
+ * The new frame is also appended to the sample ring (sample_ring.h).
+ * Lock-free and non-blocking; safe to call from an ISR or DMA-complete
+ * callback. Readers see all channel values change atomically. There must
+ * be a single writer.
  *
- * @param mv Array of NUM_CH millivolt values
+ * @param raw   Array of NUM_CH raw ADC codes
+ * @param stamp Frame timestamps
  */
-void regs_update(const int32_t mv[NUM_CH]);
+void regs_update_at(const uint16_t raw[NUM_CH], const struct regs_stamp *stamp);
 
 /**
  * @brief Read the current register file state
  *
- * Thread-safe. Copies the current state to the provided structure.
+ * Thread-safe and never blocks the writer. Copies a consistent snapshot
+ * to the provided structure, retrying if an update lands mid-copy.
  *
  * @param out Pointer to structure to receive the current state
  */
 void regs_read(struct adc_regs *out);
 
+/**
+ * @brief Borrowed, read-only view of the newest frame
+ *
+ * Filled by regs_acquire(); the caller keeps it until regs_release().
+ */
+struct regs_borrow {
+    const struct adc_regs *frame;  /* Frame in place, do not write */
+    uint32_t seq;                  /* Sequence number of @p frame */
+    uint32_t latch;                /* Latch sequence at the borrow */
+};
+
+/**
+ * @brief Borrow the newest frame without copying it
+ *
+ * Returns a pointer to the register file copy regs_read() would take.
+ * The writer never waits for borrowers: the next update rewrites the
+ * copy, and regs_release() reports whether that happened. The writer's
+ * own thread can treat the frame as stable until its next update;
+ * others must discard their result when regs_release() returns false.
+ * (The sample ring keeps frames packed, so longer-lived borrows go
+ * through sample_ring_peek() instead.)
+ *
+ * @param b Receives the borrowed frame
+ * @return b->frame
+ */
+const struct adc_regs *regs_acquire(struct regs_borrow *b);
+
+/**
+ * @brief End a borrow started by regs_acquire()
+ *
+ * @param b Borrow to end
+ * @return true if the frame stayed intact for the whole borrow
+ */
+bool regs_release(const struct regs_borrow *b);
+
+/**
+ * @brief Read the latest raw code of one channel
+ *
+ * Cheaper than regs_read() for single-channel consumers: copies two
+ * bytes instead of the whole frame, with the same consistency.
+ *
+ * @param ch  Channel number (0 to NUM_CH-1)
+ * @param seq If not NULL, receives the sequence number of the frame
+ * @return Raw code, 0 for an invalid channel
+ */
+uint16_t regs_get_raw(unsigned int ch, uint32_t *seq);
+
+/**
+ * @brief Read every frame newer than a given sequence number
+ *
+ * Stateless counterpart of sample_ring_read(): the caller keeps only the
+ * last seq it processed and passes it back. Frames are unpacked
+ * straight from the sample ring into @p out, oldest first, without
+ * blocking the writer. Frames older than the ring's history are skipped;
+ * the gap shows as out[0].seq != since_seq + 1.
+ *
+ * @param since_seq Last sequence number already seen (0 for all history)
+ * @param out       Array receiving up to @p max frames
+ * @param max       Capacity of @p out
+ * @return Number of frames copied (0 if nothing newer than @p since_seq)
+ */
+size_t regs_read_batch(uint32_t since_seq, struct adc_regs *out, size_t max);
+
 #endif /* REGS_H_ */
 
@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Processing Stage Implementation
+ *
+ * Frames are copied out of the ring in small batches rather than
+ * borrowed: a lapped borrow can only be detected after its frame has
+ * been folded into the statistics, and that cannot be undone.
+ */
+
+#include "sample_proc.h"
+#include "sample_ring.h"
+#include "chan_stats.h"
+#include "adaptive_rate.h"
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sample_proc, LOG_LEVEL_INF);
+
+/* Frames copied out of the ring per read */
+#define PROC_BATCH 4
+
+static struct sample_ring_reader proc_rd;
+static struct adc_regs proc_batch[PROC_BATCH];
+/* Written by the processing stage; the lock keeps a reader's copy whole */
+static struct sample_proc_status status;
+static struct k_spinlock status_lock;
+
+static void proc_drain(void)
+{
+    k_spinlock_key_t key;
+    uint32_t dropped;
+    size_t n;
+
+    while ((n = sample_ring_read(&proc_rd, proc_batch, PROC_BATCH)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            chan_stats_update(proc_batch[i].raw, proc_batch[i].sampled);
+            adaptive_rate_update(&proc_batch[i]);
+        }
+        key = k_spin_lock(&status_lock);
+        status.frames += n;
+        k_spin_unlock(&status_lock, key);
+    }
+
+    /* Only this thread writes status, so it may read it unlocked */
+    dropped = status.dropped;
+    if (proc_rd.dropped != dropped) {
+        LOG_WRN("Processing fell behind: %u frames skipped", proc_rd.dropped - dropped);
+        key = k_spin_lock(&status_lock);
+        status.dropped = proc_rd.dropped;
+        k_spin_unlock(&status_lock, key);
+    }
+}
+
+#if defined(CONFIG_APP_SAMPLE_PROC_THREAD)
+
+K_THREAD_STACK_DEFINE(proc_thread_stack, CONFIG_APP_SAMPLE_PROC_THREAD_STACK_SIZE);
+static struct k_thread proc_thread_data;
+static K_SEM_DEFINE(proc_wake_sem, 0, 1);
+
+static void proc_thread_entry(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (1) {
+        k_sem_take(&proc_wake_sem, K_FOREVER);
+        proc_drain();
+    }
+}
+
+#endif /* CONFIG_APP_SAMPLE_PROC_THREAD */
+
+void sample_proc_init(void)
+{
+    sample_ring_reader_init(&proc_rd);
+    status = (struct sample_proc_status){ 0 };
+    adaptive_rate_init();
+
+#if defined(CONFIG_APP_SAMPLE_PROC_THREAD)
+    k_thread_create(&proc_thread_data, proc_thread_stack,
+                    K_THREAD_STACK_SIZEOF(proc_thread_stack),
+                    proc_thread_entry,
+                    NULL, NULL, NULL,
+                    CONFIG_APP_SAMPLE_PROC_THREAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&proc_thread_data, "adc_proc");
+#endif
+}
+
+void sample_proc_notify(void)
+{
+#if defined(CONFIG_APP_SAMPLE_PROC_THREAD)
+    k_sem_give(&proc_wake_sem);
+#else
+    proc_drain();
+#endif
+}
+
+void sample_proc_get_status(struct sample_proc_status *st)
+{
+    k_spinlock_key_t key = k_spin_lock(&status_lock);
+
+    *st = status;
+    k_spin_unlock(&status_lock, key);
+}
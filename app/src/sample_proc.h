@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Processing Stage - Per-frame work behind the acquisition thread
+ *
+ * The acquisition thread only converts, filters, publishes and checks
+ * threshold rules, then wakes this stage. The stage drains the sample
+ * ring with its own reader and feeds each frame to the channel
+ * statistics and the adaptive rate controller. With
+ * CONFIG_APP_SAMPLE_PROC_THREAD it runs in its own lower-priority thread,
+ * so consumer load never delays a conversion: if it falls more than the
+ * ring depth behind, it skips frames and counts them instead. Without it
+ * the same work runs inline in the acquisition thread.
+ */
+
+#ifndef SAMPLE_PROC_H_
+#define SAMPLE_PROC_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Processing stage counters
+ */
+struct sample_proc_status {
+    uint32_t frames;   /* Frames processed */
+    uint32_t dropped;  /* Frames overwritten in the ring before processing */
+};
+
+/**
+ * @brief Start the processing stage at the newest frame
+ *
+ * Called once from main() after the modules it feeds are initialized
+ * and before the acquisition thread starts. Initializes the adaptive
+ * rate controller, whose state only the processing stage touches.
+ */
+void sample_proc_init(void);
+
+/**
+ * @brief Signal that a frame was published
+ *
+ * Acquisition thread only, after each regs_update_at(). Only wakes the
+ * processing thread; without CONFIG_APP_SAMPLE_PROC_THREAD, processes
+ * the frame before returning.
+ */
+void sample_proc_notify(void);
+
+/**
+ * @brief Get the processing stage counters
+ *
+ * Callable from any thread.
+ *
+ * @param st Receives the counters
+ */
+void sample_proc_get_status(struct sample_proc_status *st);
+
+#endif /* SAMPLE_PROC_H_ */
@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sample Ring Implementation
+ *
+ * Frame seq s lives in slot (s % SAMPLE_RING_DEPTH). The producer writes
+ * slot (head + 1) before publishing the new head, so the slot of frame s
+ * is being overwritten once head reaches s + DEPTH - 1. A reader copies
+ * a slot and then re-checks head to discard copies that may be torn,
+ * which leaves DEPTH - 1 frames of usable history. Copying readers
+ * unpack only the validated copy, never the live slot.
+ */
+
+#include "sample_ring.h"
+#include "mem_placement.h"
+#include <string.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/util.h>
+
+BUILD_ASSERT(IS_POWER_OF_TWO(SAMPLE_RING_DEPTH),
+             "SAMPLE_RING_DEPTH must be a power of two");
+BUILD_ASSERT(SAMPLE_RING_DEPTH >= 4, "SAMPLE_RING_DEPTH too small");
+
+#define RING_MASK (SAMPLE_RING_DEPTH - 1)
+
+/* Oldest frame (relative to head) that a reader can copy without tearing */
+#define RING_SAFE_SPAN (SAMPLE_RING_DEPTH - 2)
+
+static struct sample_ring_slot ring[SAMPLE_RING_DEPTH] APP_FAST_BSS;
+
+/* Sequence number of the newest published frame */
+static atomic_t ring_head APP_FAST_BSS;
+
+void sample_ring_init(void)
+{
+    memset(ring, 0, sizeof(ring));
+    atomic_set(&ring_head, 0);
+}
+
+static bool sample_ring_intact(uint32_t seq)
+{
+    barrier_dmem_fence_full();
+
+    return sample_ring_head() - seq <= RING_SAFE_SPAN;
+}
+
+void sample_ring_pack(const struct adc_regs *frame, struct sample_ring_slot *slot)
+{
+    slot->timestamp_ns = frame->timestamp_ns;
+    slot->seq = frame->seq;
+    slot->uptime_ms = (uint32_t)frame->last_sample_uptime_ms;
+    slot->sampled = frame->sampled;
+    slot->synced = frame->synced;
+    frame_pack(frame->raw, NUM_CH, SAMPLE_RING_PACK12, slot->codes);
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    memcpy(slot->ch_offset_ns, frame->ch_offset_ns, sizeof(slot->ch_offset_ns));
+#endif
+}
+
+void sample_ring_unpack(const struct sample_ring_slot *slot, struct adc_regs *frame)
+{
+    int64_t now_ms = k_uptime_get();
+
+    frame_unpack(slot->codes, NUM_CH, SAMPLE_RING_PACK12, frame->raw);
+    frame->sampled = slot->sampled;
+    frame->seq = slot->seq;
+    frame->last_sample_uptime_ms = now_ms - (uint32_t)((uint32_t)now_ms - slot->uptime_ms);
+    frame->timestamp_ns = slot->timestamp_ns;
+    frame->synced = slot->synced;
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    memcpy(frame->ch_offset_ns, slot->ch_offset_ns, sizeof(frame->ch_offset_ns));
+#endif
+}
+
+void sample_ring_push(const struct adc_regs *frame)
+{
+    sample_ring_pack(frame, &ring[frame->seq & RING_MASK]);
+
+    /* Publish only after the slot is fully written */
+    atomic_set(&ring_head, (atomic_val_t)frame->seq);
+}
+
+uint32_t sample_ring_head(void)
+{
+    return (uint32_t)atomic_get(&ring_head);
+}
+
+void sample_ring_reader_init(struct sample_ring_reader *rd)
+{
+    rd->next_seq = sample_ring_head() + 1;
+    rd->dropped = 0;
+}
+
+size_t sample_ring_read(struct sample_ring_reader *rd, struct adc_regs *out, size_t max)
+{
+    struct sample_ring_slot copy;
+    size_t n = 0;
+
+    while (n < max) {
+        uint32_t head = sample_ring_head();
+        uint32_t oldest = head - RING_SAFE_SPAN;
+
+        if ((int32_t)(head - rd->next_seq) < 0) {
+            break;  /* Caught up */
+        }
+
+        if ((int32_t)(rd->next_seq - oldest) < 0) {
+            rd->dropped += oldest - rd->next_seq;
+            rd->next_seq = oldest;
+        }
+
+        memcpy(&copy, &ring[rd->next_seq & RING_MASK], sizeof(copy));
+
+        /* Producer lapped this slot during the copy: skip ahead and retry */
+        if (!sample_ring_intact(rd->next_seq)) {
+            continue;
+        }
+
+        sample_ring_unpack(&copy, &out[n]);
+        rd->next_seq++;
+        n++;
+    }
+
+    return n;
+}
+
+const struct sample_ring_slot *sample_ring_peek(struct sample_ring_reader *rd)
+{
+    uint32_t head = sample_ring_head();
+    uint32_t oldest = head - RING_SAFE_SPAN;
+
+    if ((int32_t)(head - rd->next_seq) < 0) {
+        return NULL;  /* Caught up */
+    }
+
+    if ((int32_t)(rd->next_seq - oldest) < 0) {
+        rd->dropped += oldest - rd->next_seq;
+        rd->next_seq = oldest;
+    }
+
+    return &ring[rd->next_seq & RING_MASK];
+}
+
+bool sample_ring_consume(struct sample_ring_reader *rd)
+{
+    if (!sample_ring_intact(rd->next_seq)) {
+        return false;
+    }
+
+    rd->next_seq++;
+    return true;
+}
@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sample Ring - History of timestamped frames behind the register file
+ *
+ * Single producer (regs_update()), any number of consumers. Each consumer
+ * owns a struct sample_ring_reader cursor and drains frames at its own
+ * pace. The producer never blocks or waits for consumers; a consumer that
+ * falls more than the ring depth behind loses the oldest frames and is
+ * told how many through its cursor.
+ *
+ * Slots hold frames in packed form (struct sample_ring_slot): raw codes
+ * through frame_pack.h, 12 bits each with CONFIG_APP_FRAME_PACK12. The
+ * copying readers unpack them into struct adc_regs; the in-place
+ * peek/consume pair hands out the packed slot itself.
+ */
+
+#ifndef SAMPLE_RING_H_
+#define SAMPLE_RING_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "regs.h"
+#include "frame_pack.h"
+
+#ifdef CONFIG_APP_SAMPLE_RING_DEPTH
+#define SAMPLE_RING_DEPTH CONFIG_APP_SAMPLE_RING_DEPTH
+#else
+#define SAMPLE_RING_DEPTH 64
+#endif
+
+#if defined(CONFIG_APP_FRAME_PACK12)
+#define SAMPLE_RING_PACK12 true
+#else
+#define SAMPLE_RING_PACK12 false
+#endif
+
+/**
+ * @brief One frame as stored in the ring
+ *
+ * The fields of struct adc_regs, with the raw codes packed and the
+ * uptime cut to 32 bits (frames in the ring are never 49 days old).
+ */
+struct sample_ring_slot {
+    uint64_t timestamp_ns;
+    uint32_t seq;
+    uint32_t uptime_ms;  /* Low 32 bits of last_sample_uptime_ms */
+    uint16_t sampled;
+    bool synced;
+    uint8_t codes[FRAME_PACKED_SIZE(NUM_CH, SAMPLE_RING_PACK12)];
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    uint32_t ch_offset_ns[NUM_CH];
+#endif
+};
+
+/**
+ * @brief Per-consumer ring cursor
+ *
+ * Owned by one consumer; initialize with sample_ring_reader_init().
+ */
+struct sample_ring_reader {
+    uint32_t next_seq;  /* Sequence number of the next frame to return */
+    uint32_t dropped;   /* Frames overwritten before this reader saw them */
+};
+
+/**
+ * @brief Reset the ring to empty
+ *
+ * Called by regs_init(). Existing readers should be re-initialized.
+ */
+void sample_ring_init(void);
+
+/**
+ * @brief Append a frame
+ *
+ * Producer only. Lock-free and non-blocking; safe from ISR context.
+ * frame->seq must be one greater than the previous frame's.
+ *
+ * @param frame Frame to copy into the ring
+ */
+void sample_ring_push(const struct adc_regs *frame);
+
+/**
+ * @brief Get the sequence number of the newest frame in the ring
+ *
+ * @return Newest sequence number, 0 if nothing has been pushed yet
+ */
+uint32_t sample_ring_head(void);
+
+/**
+ * @brief Initialize a reader positioned after the newest frame
+ *
+ * The first sample_ring_read() returns frames pushed after this call.
+ *
+ * @param rd Reader cursor to initialize
+ */
+void sample_ring_reader_init(struct sample_ring_reader *rd);
+
+/**
+ * @brief Copy out frames this reader has not seen yet, oldest first
+ *
+ * Never blocks the producer. If the reader fell behind, the frames it
+ * missed are skipped and added to rd->dropped; the sequence gap is also
+ * visible in the returned frames' seq fields.
+ *
+ * @param rd  Reader cursor, advanced past the returned frames
+ * @param out Array receiving up to @p max frames
+ * @param max Capacity of @p out
+ * @return Number of frames copied (0 if none are pending)
+ */
+size_t sample_ring_read(struct sample_ring_reader *rd, struct adc_regs *out, size_t max);
+
+/**
+ * @brief Borrow the next frame this reader has not seen, in place
+ *
+ * Zero-copy counterpart of sample_ring_read(): returns the packed slot
+ * instead of copying and unpacking it. The producer does not wait for the
+ * borrower, so the frame is only known to be intact once
+ * sample_ring_consume() says so; anything derived from it before then
+ * must be discarded if it returns false. Drop accounting is the same as
+ * for sample_ring_read().
+ *
+ * @param rd Reader cursor (not advanced)
+ * @return Frame, or NULL if none is pending
+ */
+const struct sample_ring_slot *sample_ring_peek(struct sample_ring_reader *rd);
+
+/**
+ * @brief Finish with the frame returned by sample_ring_peek()
+ *
+ * @param rd Reader cursor, advanced past the frame if it was intact
+ * @return true if the frame was not overwritten while borrowed; false if
+ *         the producer lapped it (the next peek skips ahead and counts
+ *         the loss in rd->dropped)
+ */
+bool sample_ring_consume(struct sample_ring_reader *rd);
+
+/**
+ * @brief Pack a frame into the slot format
+ *
+ * @param frame Frame to pack
+ * @param slot  Receives the packed frame
+ */
+void sample_ring_pack(const struct adc_regs *frame, struct sample_ring_slot *slot);
+
+/**
+ * @brief Unpack a slot
+ *
+ * The uptime is widened against the current k_uptime_get().
+ *
+ * @param slot  Packed frame
+ * @param frame Receives the frame
+ */
+void sample_ring_unpack(const struct sample_ring_slot *slot, struct adc_regs *frame);
+
+#endif /* SAMPLE_RING_H_ */
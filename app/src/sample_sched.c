@@ -0,0 +1,319 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampling Scheduler Implementation
+ */
+
+#include "sample_sched.h"
+#include "regs.h"
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#if defined(CONFIG_APP_SAMPLE_SCHED_COUNTER)
+#include <zephyr/device.h>
+#include <zephyr/drivers/counter.h>
+#endif
+
+LOG_MODULE_REGISTER(sample_sched, LOG_LEVEL_INF);
+
+static atomic_t sched_period_us;
+static uint32_t sched_overruns;
+
+/* Serializes period changes from the shell and the adaptive rate */
+static K_MUTEX_DEFINE(sched_period_lock);
+
+/* Orders timer restarts from threads against the sync edge ISR */
+static struct k_spinlock sched_restart_lock;
+static bool sched_started;
+
+/* Local clock rate error from the sync driver, applied to the period */
+static int32_t sched_rate_ppb;
+
+#if defined(CONFIG_APP_SYNC)
+/* Frame clock at the last tick, for sample_sched_sync() */
+static uint64_t sched_last_tick_ns;
+#endif
+
+/* Ticks since sample_sched_start(), including skipped ones */
+static uint32_t sched_tick;
+
+#ifdef CONFIG_APP_RATE_GROUP_SLOW_CHANNELS
+#define RATE_GROUP_SLOW_CHANNELS CONFIG_APP_RATE_GROUP_SLOW_CHANNELS
+#define RATE_GROUP_SLOW_DIVIDER  CONFIG_APP_RATE_GROUP_SLOW_DIVIDER
+#else
+#define RATE_GROUP_SLOW_CHANNELS 0
+#define RATE_GROUP_SLOW_DIVIDER  1
+#endif
+
+/* Channels outside every rate group are due on every tick */
+struct rate_group {
+    uint32_t channels;   /* Channel mask */
+    uint32_t divider;    /* Due every this many ticks */
+    uint32_t next_tick;  /* sched_tick at which the group is next due */
+};
+
+static struct rate_group rate_groups[] = {
+    {
+        .channels = RATE_GROUP_SLOW_CHANNELS & BIT_MASK(NUM_CH),
+        .divider = RATE_GROUP_SLOW_DIVIDER,
+    },
+};
+
+/* Called in the tick's interrupt context */
+static inline void sched_tick_stamp(void)
+{
+#if defined(CONFIG_APP_SYNC)
+    sched_last_tick_ns = regs_clock_ns();
+#endif
+}
+
+/* Stretch a period by a clock rate error */
+static inline uint64_t sched_trim(uint64_t period, int32_t rate_ppb)
+{
+    return (uint64_t)((int64_t)period + (int64_t)period * rate_ppb / 1000000000LL);
+}
+
+#if defined(CONFIG_APP_SAMPLE_SCHED_KTIMER)
+
+static void sched_timer_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+    sched_tick_stamp();
+}
+
+/*
+ * k_timer expiries are computed from the previous deadline, not from
+ * when the thread woke, so the period stays exact in tick units.
+ */
+static K_TIMER_DEFINE(sched_timer, sched_timer_expiry, NULL);
+
+static int sched_backend_restart(uint32_t period_us, int32_t rate_ppb, bool tick_now)
+{
+    k_timeout_t period = K_NSEC(sched_trim((uint64_t)period_us * NSEC_PER_USEC, rate_ppb));
+
+    k_timer_start(&sched_timer, tick_now ? K_NO_WAIT : period, period);
+    return 0;
+}
+
+static int sched_backend_start(uint32_t period_us)
+{
+    return sched_backend_restart(period_us, 0, false);
+}
+
+static uint32_t sched_backend_wait(void)
+{
+    return k_timer_status_sync(&sched_timer);
+}
+
+#elif defined(CONFIG_APP_SAMPLE_SCHED_COUNTER)
+
+#define SAMPLE_TIMER_NODE DT_NODELABEL(sample_timer)
+
+static const struct device *const sched_counter = DEVICE_DT_GET(SAMPLE_TIMER_NODE);
+static K_SEM_DEFINE(sched_tick_sem, 0, 1);
+static atomic_t sched_pending;
+
+static void sched_counter_top(const struct device *dev, void *user_data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    sched_tick_stamp();
+    atomic_inc(&sched_pending);
+    k_sem_give(&sched_tick_sem);
+}
+
+static int sched_backend_restart(uint32_t period_us, int32_t rate_ppb, bool tick_now)
+{
+    struct counter_top_cfg top_cfg = {
+        .ticks = (uint32_t)sched_trim(counter_us_to_ticks(sched_counter, period_us),
+                                      rate_ppb),
+        .callback = sched_counter_top,
+        .user_data = NULL,
+        .flags = 0,
+    };
+    int ret;
+
+    /* Resets the count, so the new period starts now */
+    ret = counter_set_top_value(sched_counter, &top_cfg);
+    if (ret < 0) {
+        LOG_ERR("Failed to set sample timer period: %d", ret);
+        return ret;
+    }
+
+    if (tick_now) {
+        sched_counter_top(sched_counter, NULL);
+    }
+
+    return 0;
+}
+
+static int sched_backend_start(uint32_t period_us)
+{
+    int ret;
+
+    if (!device_is_ready(sched_counter)) {
+        LOG_ERR("Sample timer not ready");
+        return -ENODEV;
+    }
+
+    ret = sched_backend_restart(period_us, 0, false);
+    if (ret < 0) {
+        return ret;
+    }
+
+    return counter_start(sched_counter);
+}
+
+static uint32_t sched_backend_wait(void)
+{
+    atomic_val_t ticks;
+
+    do {
+        k_sem_take(&sched_tick_sem, K_FOREVER);
+        ticks = atomic_set(&sched_pending, 0);
+    } while (ticks == 0);
+
+    return (uint32_t)ticks;
+}
+
+#else /* CONFIG_APP_SAMPLE_SCHED_SLEEP */
+
+static int sched_backend_start(uint32_t period_us)
+{
+    ARG_UNUSED(period_us);
+    return 0;
+}
+
+static int sched_backend_restart(uint32_t period_us, int32_t rate_ppb, bool tick_now)
+{
+    ARG_UNUSED(period_us);
+    ARG_UNUSED(rate_ppb);
+    ARG_UNUSED(tick_now);
+    return 0;
+}
+
+static uint32_t sched_backend_wait(void)
+{
+    /* Period is measured from the end of the frame, so it drifts */
+    k_usleep((int32_t)atomic_get(&sched_period_us));
+    return 1;
+}
+
+#endif
+
+int sample_sched_start(uint32_t period_us)
+{
+    k_spinlock_key_t key;
+    int ret;
+
+    atomic_set(&sched_period_us, (atomic_val_t)period_us);
+    sched_overruns = 0;
+    sched_tick = 0;
+
+    /* Every group is due on the first frame */
+    for (size_t g = 0; g < ARRAY_SIZE(rate_groups); g++) {
+        rate_groups[g].next_tick = 0;
+        if (rate_groups[g].channels != 0) {
+            LOG_INF("Rate group %u: mask 0x%04x every %u frames", (unsigned int)g,
+                    rate_groups[g].channels, rate_groups[g].divider);
+        }
+    }
+
+    ret = sched_backend_start(period_us);
+
+    key = k_spin_lock(&sched_restart_lock);
+    sched_started = (ret == 0);
+    sched_rate_ppb = 0;
+    k_spin_unlock(&sched_restart_lock, key);
+
+    return ret;
+}
+
+uint32_t sample_sched_wait(void)
+{
+    uint32_t ticks = sched_backend_wait();
+
+    if (ticks > 1) {
+        sched_overruns += ticks - 1;
+    }
+    sched_tick += ticks;
+
+    return ticks;
+}
+
+uint32_t sample_sched_due(void)
+{
+    uint32_t due = BIT_MASK(NUM_CH);
+
+    for (size_t g = 0; g < ARRAY_SIZE(rate_groups); g++) {
+        struct rate_group *grp = &rate_groups[g];
+
+        if ((int32_t)(sched_tick - grp->next_tick) >= 0) {
+            grp->next_tick = sched_tick + grp->divider;
+        } else {
+            due &= ~grp->channels;
+        }
+    }
+
+    return due;
+}
+
+uint32_t sample_sched_period_us(void)
+{
+    return (uint32_t)atomic_get(&sched_period_us);
+}
+
+int sample_sched_set_period(uint32_t period_us)
+{
+    int ret;
+
+    if (period_us < SAMPLE_SCHED_MIN_PERIOD_US || period_us > SAMPLE_SCHED_MAX_PERIOD_US) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&sched_period_lock, K_FOREVER);
+
+    ret = 0;
+    if (period_us != sample_sched_period_us()) {
+        k_spinlock_key_t key = k_spin_lock(&sched_restart_lock);
+
+        ret = sched_backend_restart(period_us, sched_rate_ppb, false);
+        if (ret == 0) {
+            atomic_set(&sched_period_us, (atomic_val_t)period_us);
+        }
+        k_spin_unlock(&sched_restart_lock, key);
+    }
+
+    k_mutex_unlock(&sched_period_lock);
+
+    return ret;
+}
+
+#if defined(CONFIG_APP_SYNC)
+void sample_sched_sync(uint64_t edge_ns, int32_t rate_ppb)
+{
+    k_spinlock_key_t key = k_spin_lock(&sched_restart_lock);
+    uint32_t period_us = sample_sched_period_us();
+    bool tick_now;
+
+    if (sched_started) {
+        /*
+         * A tick that fired just before the edge was the edge's tick; one
+         * still pending (local clock slow) is released now rather than
+         * lost to the restart.
+         */
+        tick_now = (edge_ns - sched_last_tick_ns) > (uint64_t)period_us * NSEC_PER_USEC / 2;
+        sched_rate_ppb = rate_ppb;
+        (void)sched_backend_restart(period_us, rate_ppb, tick_now);
+    }
+    k_spin_unlock(&sched_restart_lock, key);
+}
+#endif
+
+uint32_t sample_sched_overruns(void)
+{
+    return sched_overruns;
+}
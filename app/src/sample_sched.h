@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampling Scheduler - Paces the sampling thread
+ *
+ * The scheduler is selected at build time (CONFIG_APP_SAMPLE_SCHED_*):
+ * a plain sleep after each frame, a periodic k_timer, or a hardware
+ * counter. The timer-based schedulers tick at absolute instants, so the
+ * frame rate does not drift with sampling time or scheduling latency.
+ * With CONFIG_APP_SYNC they are also re-phased on every sync edge, so
+ * boards sharing a sync line tick together.
+ *
+ * The scheduler also owns the rate groups: channels in the slow group
+ * (CONFIG_APP_RATE_GROUP_SLOW_CHANNELS) are only due every
+ * CONFIG_APP_RATE_GROUP_SLOW_DIVIDER ticks, the rest on every tick.
+ */
+
+#ifndef SAMPLE_SCHED_H_
+#define SAMPLE_SCHED_H_
+
+#include <stdint.h>
+#include <zephyr/sys_clock.h>
+
+/* Range accepted by sample_sched_set_period() */
+#define SAMPLE_SCHED_MIN_PERIOD_US 100
+#define SAMPLE_SCHED_MAX_PERIOD_US (10 * USEC_PER_SEC)
+
+/**
+ * @brief Start the scheduler
+ *
+ * Must be called once from the sampling thread before the first
+ * sample_sched_wait().
+ *
+ * @param period_us Frame period in microseconds
+ * @return 0 on success, negative errno on failure
+ */
+int sample_sched_start(uint32_t period_us);
+
+/**
+ * @brief Block until the next frame is due
+ *
+ * Called by the sampling thread at the end of each frame.
+ *
+ * @return Number of scheduler ticks since the previous call. Values
+ *         greater than 1 mean the frame overran its period and ticks
+ *         were skipped. The sleep scheduler always returns 1.
+ */
+uint32_t sample_sched_wait(void);
+
+/**
+ * @brief Get the channels due in the current frame
+ *
+ * Called by the sampling thread once per frame, before sampling. A rate
+ * group whose tick was skipped by an overrun is due on the next frame.
+ *
+ * @return Channel mask, bit n for channel n
+ */
+uint32_t sample_sched_due(void);
+
+/**
+ * @brief Get the current frame period
+ *
+ * @return Period in microseconds
+ */
+uint32_t sample_sched_period_us(void);
+
+/**
+ * @brief Change the frame period at runtime
+ *
+ * Callable from any thread once the scheduler has started. The timer
+ * schedulers restart their period from now, so the frame already
+ * waiting is released one new period later; the sleep scheduler applies
+ * it from the next sleep.
+ *
+ * @param period_us New period, SAMPLE_SCHED_MIN_PERIOD_US to
+ *                  SAMPLE_SCHED_MAX_PERIOD_US
+ * @return 0 on success, -EINVAL if out of range, or a counter error
+ */
+int sample_sched_set_period(uint32_t period_us);
+
+/**
+ * @brief Re-phase the tick train to a sync edge
+ *
+ * Called by the sync driver (sync.h) from its edge interrupt. The next
+ * tick comes one period after the edge, and a tick due at the edge that
+ * has not fired yet is released now. Until the next call the period is
+ * stretched by @p rate_ppb so the local timer keeps pace with the pulse
+ * train. No effect with the sleep scheduler or before
+ * sample_sched_start().
+ *
+ * @param edge_ns  Frame clock at the edge (regs_clock_ns())
+ * @param rate_ppb Local clock rate error, positive when fast
+ */
+void sample_sched_sync(uint64_t edge_ns, int32_t rate_ppb);
+
+/**
+ * @brief Get the number of ticks skipped because a frame overran
+ *
+ * @return Total skipped ticks since sample_sched_start()
+ */
+uint32_t sample_sched_overruns(void);
+
+#endif /* SAMPLE_SCHED_H_ */
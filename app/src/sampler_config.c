@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampler Configuration Implementation
+ *
+ * The staged configuration is shared with the shell under a spinlock;
+ * a set flag tells the sampling thread to pick it up. Only the fields
+ * that differ from the applied configuration (for the period, from the
+ * one running) are acted on, so a period change does not rebuild the
+ * backend's sequences and a mask change touches neither the backend nor
+ * the scheduler.
+ */
+
+#include "sampler_config.h"
+#include "frame_pack.h"
+#include "sample_sched.h"
+#include "adaptive_rate.h"
+#include "filter.h"
+#include "threshold.h"
+#include <stddef.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+#if defined(CONFIG_APP_RUNTIME_CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+
+LOG_MODULE_REGISTER(sampler_config, LOG_LEVEL_INF);
+
+#define SETTINGS_ROOT "sampler"
+
+static const struct sampler_config defaults = {
+    .period_us = CONFIG_APP_SAMPLE_PERIOD_MS * USEC_PER_MSEC,
+    .channel_mask = ADC_BACKEND_ALL_CHANNELS,
+    .resolution = ADC_BACKEND_DEFAULT,
+    .oversampling = ADC_BACKEND_DEFAULT,
+};
+
+static struct sampler_config staged;
+static struct k_spinlock config_lock;
+
+/* Set when staged differs from what the sampling thread applied */
+static atomic_t pending;
+
+/* Sampling-thread state */
+static struct sampler_config applied;
+static atomic_t active_channels = ATOMIC_INIT(ADC_BACKEND_ALL_CHANNELS);
+
+static int config_check(const struct sampler_config *cfg)
+{
+    if (cfg->period_us < SAMPLE_SCHED_MIN_PERIOD_US ||
+        cfg->period_us > SAMPLE_SCHED_MAX_PERIOD_US) {
+        return -EINVAL;
+    }
+
+    if (cfg->channel_mask == 0 || (cfg->channel_mask & ~ADC_BACKEND_ALL_CHANNELS)) {
+        return -EINVAL;
+    }
+
+    /* 12-bit packed frames would clamp wider codes */
+    if (IS_ENABLED(CONFIG_APP_FRAME_PACK12) && cfg->resolution != ADC_BACKEND_DEFAULT &&
+        cfg->resolution > FRAME_PACK12_BITS) {
+        return -ENOTSUP;
+    }
+
+    return adc_backend_config_check(cfg->resolution, cfg->oversampling);
+}
+
+#if defined(CONFIG_APP_RUNTIME_CONFIG_SETTINGS)
+/* One settings key per field, so a saved configuration survives new fields */
+struct config_field {
+    const char *name;
+    size_t offset;
+    size_t size;
+};
+
+#define CONFIG_FIELD(f)                                                         \
+    { #f, offsetof(struct sampler_config, f), SIZEOF_FIELD(struct sampler_config, f) }
+
+static const struct config_field config_fields[] = {
+    CONFIG_FIELD(period_us),
+    CONFIG_FIELD(channel_mask),
+    CONFIG_FIELD(resolution),
+    CONFIG_FIELD(oversampling),
+};
+
+/* Only runs from settings_load_subtree() in sampler_config_init() */
+static int config_settings_set(const char *key, size_t len, settings_read_cb read_cb,
+                               void *cb_arg)
+{
+    const char *next;
+    ssize_t ret;
+
+    for (size_t i = 0; i < ARRAY_SIZE(config_fields); i++) {
+        const struct config_field *f = &config_fields[i];
+
+        if (!settings_name_steq(key, f->name, &next) || next != NULL) {
+            continue;
+        }
+        if (len != f->size) {
+            return -EINVAL;
+        }
+
+        ret = read_cb(cb_arg, (uint8_t *)&staged + f->offset, f->size);
+        return (ret < 0) ? (int)ret : 0;
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(sampler, SETTINGS_ROOT, NULL, config_settings_set, NULL,
+                               NULL);
+
+static int config_load(void)
+{
+    int ret = settings_subsys_init();
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    return settings_load_subtree(SETTINGS_ROOT);
+}
+#else
+static inline int config_load(void)
+{
+    return 0;
+}
+#endif /* CONFIG_APP_RUNTIME_CONFIG_SETTINGS */
+
+int sampler_config_init(void)
+{
+    int ret;
+
+    staged = defaults;
+    applied = defaults;
+
+    ret = config_load();
+    if (ret < 0) {
+        LOG_ERR("Loading saved configuration failed: %d", ret);
+        staged = defaults;
+    } else if (config_check(&staged) != 0) {
+        LOG_WRN("Saved configuration not supported; using defaults");
+        staged = defaults;
+    }
+
+    atomic_set(&pending, 1);
+
+    return ret;
+}
+
+int sampler_config_set(const struct sampler_config *cfg)
+{
+    k_spinlock_key_t key;
+    int ret = config_check(cfg);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    key = k_spin_lock(&config_lock);
+    staged = *cfg;
+    atomic_set(&pending, 1);
+    k_spin_unlock(&config_lock, key);
+
+    return 0;
+}
+
+uint32_t sampler_config_channels(void)
+{
+    return (uint32_t)atomic_get(&active_channels);
+}
+
+/* The period running now; adcrate changes it without going through here */
+static uint32_t period_get(void)
+{
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+    struct adaptive_rate_config rate;
+
+    adaptive_rate_get(&rate);
+    return rate.fast_us;
+#else
+    return sample_sched_period_us();
+#endif
+}
+
+static int period_set(uint32_t period_us)
+{
+#if defined(CONFIG_APP_ADAPTIVE_RATE)
+    /* The configured period is the fast rate; keep the slow one at or above it */
+    struct adaptive_rate_config rate;
+
+    adaptive_rate_get(&rate);
+    rate.fast_us = period_us;
+    rate.slow_us = MAX(rate.slow_us, period_us);
+    return adaptive_rate_configure(&rate);
+#else
+    return sample_sched_set_period(period_us);
+#endif
+}
+
+void sampler_config_get(struct sampler_config *cfg)
+{
+    k_spinlock_key_t key = k_spin_lock(&config_lock);
+
+    *cfg = staged;
+    k_spin_unlock(&config_lock, key);
+
+    /* Unless a new one is staged, report the period adcrate may have set */
+    if (!atomic_get(&pending)) {
+        cfg->period_us = period_get();
+    }
+}
+
+void sampler_config_apply(void)
+{
+    struct sampler_config cfg;
+    k_spinlock_key_t key;
+    int ret;
+
+    if (!atomic_cas(&pending, 1, 0)) {
+        return;
+    }
+
+    key = k_spin_lock(&config_lock);
+    cfg = staged;
+    k_spin_unlock(&config_lock, key);
+
+    if (cfg.resolution != applied.resolution || cfg.oversampling != applied.oversampling) {
+        ret = adc_backend_configure(cfg.resolution, cfg.oversampling);
+        if (ret < 0) {
+            LOG_ERR("Backend reconfiguration failed: %d", ret);
+            cfg.resolution = applied.resolution;
+            cfg.oversampling = applied.oversampling;
+        } else {
+            /* Both hold state derived from the channel resolutions */
+            filter_rescale();
+#if defined(CONFIG_APP_THRESHOLDS)
+            threshold_rescale();
+#endif
+        }
+    }
+
+    /* Against the live period, which adcrate may have moved off applied */
+    if (cfg.period_us != period_get()) {
+        ret = period_set(cfg.period_us);
+        if (ret < 0) {
+            LOG_ERR("Period change failed: %d", ret);
+            cfg.period_us = period_get();
+        }
+    }
+
+    atomic_set(&active_channels, cfg.channel_mask);
+    applied = cfg;
+}
+
+int sampler_config_save(void)
+{
+#if defined(CONFIG_APP_RUNTIME_CONFIG_SETTINGS)
+    struct sampler_config cfg;
+    char key[32];
+    int ret;
+
+    sampler_config_get(&cfg);
+
+    for (size_t i = 0; i < ARRAY_SIZE(config_fields); i++) {
+        const struct config_field *f = &config_fields[i];
+
+        snprintk(key, sizeof(key), SETTINGS_ROOT "/%s", f->name);
+        ret = settings_save_one(key, (const uint8_t *)&cfg + f->offset, f->size);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
+
+int sampler_config_erase(void)
+{
+#if defined(CONFIG_APP_RUNTIME_CONFIG_SETTINGS)
+    char key[32];
+    int ret;
+
+    for (size_t i = 0; i < ARRAY_SIZE(config_fields); i++) {
+        snprintk(key, sizeof(key), SETTINGS_ROOT "/%s", config_fields[i].name);
+        ret = settings_delete(key);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    return 0;
+#else
+    return -ENOTSUP;
+#endif
+}
@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampler Configuration - Runtime sampling parameters with persistence
+ *
+ * Holds the sampling period, the active channel mask and the resolution
+ * and oversampling override. The shell stages a new configuration from
+ * any thread; the sampling thread applies it between two frames, so the
+ * backend rebuilds its sequences once per change and never mid-frame.
+ * With CONFIG_APP_RUNTIME_CONFIG_SETTINGS the configuration is saved
+ * under the "sampler/" settings subtree and loaded at boot.
+ */
+
+#ifndef SAMPLER_CONFIG_H_
+#define SAMPLER_CONFIG_H_
+
+#include <stdint.h>
+#include "adc_backend.h"
+
+/**
+ * @brief Sampling parameters
+ */
+struct sampler_config {
+    uint32_t period_us;     /* Frame period (the fast rate with adaptive rate) */
+    uint32_t channel_mask;  /* Channels converted, bit n for channel n */
+    uint8_t resolution;     /* Bits for every channel, or ADC_BACKEND_DEFAULT */
+    uint8_t oversampling;   /* log2 ratio for every channel, or ADC_BACKEND_DEFAULT */
+};
+
+#if defined(CONFIG_APP_RUNTIME_CONFIG)
+
+/**
+ * @brief Start from the build-time defaults and load saved settings
+ *
+ * Called once from main() after adc_backend_init() and before the
+ * sampling thread starts. A saved configuration the backend rejects is
+ * ignored. The result is applied by the first sampler_config_apply().
+ *
+ * @return 0 on success, negative errno if the settings storage failed
+ *         (the defaults are used)
+ */
+int sampler_config_init(void);
+
+/**
+ * @brief Stage a new configuration
+ *
+ * Callable from any thread; takes effect before the next frame.
+ *
+ * @param cfg New configuration, copied
+ * @return 0 on success, -EINVAL for a period outside the scheduler's
+ *         range or an empty or out-of-range channel mask, -ENOTSUP for
+ *         a resolution or oversampling the backend cannot do, or a
+ *         resolution above 12 bits with CONFIG_APP_FRAME_PACK12
+ */
+int sampler_config_set(const struct sampler_config *cfg);
+
+/**
+ * @brief Get the latest staged configuration
+ *
+ * With nothing staged, the period is the one running, which adcrate
+ * may have changed since the last sampler_config_apply().
+ *
+ * @param cfg Receives a copy
+ */
+void sampler_config_get(struct sampler_config *cfg);
+
+/**
+ * @brief Apply a staged configuration, if there is one
+ *
+ * Sampling thread only, before sample_sched_due() of the next frame.
+ * Costs one flag test when nothing changed.
+ */
+void sampler_config_apply(void);
+
+/**
+ * @brief Get the channels currently being converted
+ *
+ * @return Channel mask, bit n for channel n
+ */
+uint32_t sampler_config_channels(void);
+
+/**
+ * @brief Persist the latest staged configuration
+ *
+ * @return 0 on success, -ENOTSUP without settings support, or a
+ *         settings error
+ */
+int sampler_config_save(void);
+
+/**
+ * @brief Delete the persisted configuration
+ *
+ * The running configuration is kept; the next boot uses the defaults.
+ *
+ * @return 0 on success, -ENOTSUP without settings support, or a
+ *         settings error
+ */
+int sampler_config_erase(void);
+
+#else
+
+static inline int sampler_config_init(void) { return 0; }
+static inline void sampler_config_apply(void) {}
+static inline uint32_t sampler_config_channels(void) { return ADC_BACKEND_ALL_CHANNELS; }
+
+#endif /* CONFIG_APP_RUNTIME_CONFIG */
+
+#endif /* SAMPLER_CONFIG_H_ */
@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampler Statistics Implementation
+ */
+
+#include "sampler_stats.h"
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/util.h>
+
+static struct sampler_ch_errors ch_errors[NUM_CH];
+static struct k_spinlock stats_lock;
+
+#if defined(CONFIG_APP_SAMPLER_STATS)
+#include <zephyr/timing/timing.h>
+
+static struct sampler_stat stats[SAMPLER_STAT_COUNT];
+
+/* Previous wakeup, 0 until the first one after a reset */
+static uint64_t last_wakeup;
+
+/* Wakeups after an overrun, kept out of SAMPLER_STAT_JITTER */
+static uint32_t overruns;
+
+static void stat_add(struct sampler_stat *st, int32_t value_ns)
+{
+    uint32_t mag = (value_ns < 0) ? (uint32_t)-(int64_t)value_ns : (uint32_t)value_ns;
+    unsigned int bin = MIN(find_msb_set(mag), SAMPLER_STATS_HIST_BINS - 1);
+
+    if (st->count == 0 || value_ns < st->min) {
+        st->min = value_ns;
+    }
+    if (st->count == 0 || value_ns > st->max) {
+        st->max = value_ns;
+    }
+    st->sum += value_ns;
+    st->count++;
+    st->hist[bin]++;
+}
+
+static int32_t cycles_to_ns(uint64_t start, uint64_t end)
+{
+    timing_t t0 = (timing_t)start;
+    timing_t t1 = (timing_t)end;
+    uint64_t ns = timing_cycles_to_ns(timing_cycles_get(&t0, &t1));
+
+    return (int32_t)MIN(ns, INT32_MAX);
+}
+
+void sampler_stats_init(void)
+{
+    timing_init();
+    timing_start();
+    sampler_stats_reset();
+}
+
+void sampler_stats_reset(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    memset(stats, 0, sizeof(stats));
+    memset(ch_errors, 0, sizeof(ch_errors));
+    last_wakeup = 0;
+    overruns = 0;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+uint64_t sampler_stats_now(void)
+{
+    return (uint64_t)timing_counter_get();
+}
+
+void sampler_stats_record(enum sampler_stat_id id, uint64_t start, uint64_t end)
+{
+    int32_t ns = cycles_to_ns(start, end);
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    stat_add(&stats[id], ns);
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+void sampler_stats_wakeup(uint64_t now, uint32_t period_us, uint32_t ticks)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    if (ticks > 1) {
+        overruns++;
+    } else if (last_wakeup != 0) {
+        int64_t jitter = (int64_t)cycles_to_ns(last_wakeup, now) -
+                         (int64_t)period_us * NSEC_PER_USEC;
+
+        stat_add(&stats[SAMPLER_STAT_JITTER],
+                 (int32_t)CLAMP(jitter, INT32_MIN, INT32_MAX));
+    }
+    last_wakeup = now;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+uint32_t sampler_stats_overruns(void)
+{
+    return overruns;
+}
+
+void sampler_stats_get(enum sampler_stat_id id, struct sampler_stat *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    *out = stats[id];
+
+    k_spin_unlock(&stats_lock, key);
+}
+#endif /* CONFIG_APP_SAMPLER_STATS */
+
+bool sampler_stats_channel_error(unsigned int ch, int err, uint32_t *missed)
+{
+    int64_t now = k_uptime_get();
+    struct sampler_ch_errors *e;
+    k_spinlock_key_t key;
+    bool log_due;
+
+    *missed = 0;
+    if (ch >= NUM_CH) {
+        return false;
+    }
+
+    key = k_spin_lock(&stats_lock);
+    e = &ch_errors[ch];
+
+    e->count++;
+    e->last_err = err;
+
+    log_due = (e->reported == 0) ||
+              (now - e->reported_ms >= CONFIG_APP_ERROR_LOG_INTERVAL_MS);
+    if (log_due) {
+        /* Failures between the previous line and this one */
+        *missed = e->count - e->reported - 1;
+        e->reported = e->count;
+        e->reported_ms = now;
+    }
+
+    k_spin_unlock(&stats_lock, key);
+
+    return log_due;
+}
+
+bool sampler_stats_channels_failed(uint32_t ch_mask, int err, uint32_t *missed)
+{
+    bool log_due = false;
+
+    *missed = 0;
+    for (unsigned int i = 0; i < NUM_CH; i++) {
+        uint32_t n;
+
+        if ((ch_mask & BIT(i)) && sampler_stats_channel_error(i, err, &n)) {
+            log_due = true;
+            *missed = MAX(*missed, n);
+        }
+    }
+
+    return log_due;
+}
+
+void sampler_stats_get_errors(unsigned int ch, struct sampler_ch_errors *out)
+{
+    k_spinlock_key_t key;
+
+    if (ch >= NUM_CH) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    key = k_spin_lock(&stats_lock);
+    *out = ch_errors[ch];
+    k_spin_unlock(&stats_lock, key);
+}
@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sampler Statistics - Latency and jitter instrumentation for the
+ * sampling loop
+ *
+ * Timestamps come from the Zephyr timing API (DWT CYCCNT on Cortex-M7,
+ * TSC on x86), so the cost per frame is a few counter reads. The
+ * 'adcstats' shell command prints the results.
+ *
+ * Sampling failures are aggregated per channel here as well, so the
+ * backends log a rate-limited summary instead of a line per failure.
+ */
+
+#ifndef SAMPLER_STATS_H_
+#define SAMPLER_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "regs.h"  /* For NUM_CH */
+
+/* Histogram bins: bin 0 counts 0 ns, bin b counts [2^(b-1), 2^b) ns */
+#define SAMPLER_STATS_HIST_BINS 32
+
+/**
+ * @brief What a statistics accumulator measures
+ */
+enum sampler_stat_id {
+    SAMPLER_STAT_SAMPLE,   /* adc_backend_sample() duration */
+    SAMPLER_STAT_FILTER,   /* filter_process() duration (CONFIG_APP_FILTER) */
+    SAMPLER_STAT_UPDATE,   /* regs_update() duration */
+    SAMPLER_STAT_FRAME,    /* Wakeup to end of frame processing */
+    SAMPLER_STAT_JITTER,   /* Wakeup-to-wakeup period minus nominal period */
+    SAMPLER_STAT_COUNT,
+};
+
+/**
+ * @brief One accumulator snapshot (all values in nanoseconds)
+ */
+struct sampler_stat {
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint32_t hist[SAMPLER_STATS_HIST_BINS];  /* By magnitude */
+};
+
+/**
+ * @brief Per-channel sampling failure counters
+ */
+struct sampler_ch_errors {
+    uint32_t count;      /* Failures since reset */
+    int32_t last_err;    /* Negative errno of the latest failure */
+    uint32_t reported;   /* count at the last log line */
+    int64_t reported_ms; /* Uptime of the last log line */
+};
+
+/*
+ * Failure counting is always built, so the backends' logging stays rate
+ * limited without CONFIG_APP_SAMPLER_STATS; only 'adcstats' lists the
+ * counters.
+ */
+
+/**
+ * @brief Count a sampling failure on a channel
+ *
+ * Cheap enough for the sampling path: no formatting or output. Tells the
+ * caller when a log line is due, which is on the first failure after a
+ * reset and then at most once per CONFIG_APP_ERROR_LOG_INTERVAL_MS.
+ *
+ * @param ch     Channel number (0 to NUM_CH-1)
+ * @param err    Negative errno
+ * @param missed Receives the failures not logged since the previous line
+ * @return true if the caller should log this failure
+ */
+bool sampler_stats_channel_error(unsigned int ch, int err, uint32_t *missed);
+
+/**
+ * @brief Count a failed conversion on every channel in @p ch_mask
+ *
+ * For a scan that fails as a whole: one log line covers the channels,
+ * due when any of them is due.
+ *
+ * @param ch_mask Channels whose conversion failed
+ * @param err     Negative errno
+ * @param missed  Receives the most failures not logged on any of them
+ * @return true if the caller should log
+ */
+bool sampler_stats_channels_failed(uint32_t ch_mask, int err, uint32_t *missed);
+
+/**
+ * @brief Copy out one channel's failure counters
+ *
+ * @param ch  Channel number (0 to NUM_CH-1)
+ * @param out Structure receiving the counters
+ */
+void sampler_stats_get_errors(unsigned int ch, struct sampler_ch_errors *out);
+
+#if defined(CONFIG_APP_SAMPLER_STATS)
+
+/**
+ * @brief Start the timing counter and clear all accumulators
+ */
+void sampler_stats_init(void);
+
+/**
+ * @brief Clear all accumulators and failure counters
+ */
+void sampler_stats_reset(void);
+
+/**
+ * @brief Read the free-running timing counter
+ *
+ * @return Counter value in timing-counter cycles
+ */
+uint64_t sampler_stats_now(void);
+
+/**
+ * @brief Record the duration between two counter values
+ *
+ * @param id    Accumulator to update
+ * @param start Counter value at start
+ * @param end   Counter value at end
+ */
+void sampler_stats_record(enum sampler_stat_id id, uint64_t start, uint64_t end);
+
+/**
+ * @brief Record a sampling-thread wakeup
+ *
+ * Updates SAMPLER_STAT_JITTER with the distance from the previous
+ * wakeup minus @p period_us. A wakeup after an overrun (@p ticks above 1)
+ * is counted in sampler_stats_overruns() instead: its interval spans
+ * several periods and says nothing about timing jitter.
+ *
+ * @param now       Counter value at wakeup
+ * @param period_us Nominal period in microseconds
+ * @param ticks     Scheduler ticks since the previous wakeup
+ *                  (sample_sched_wait())
+ */
+void sampler_stats_wakeup(uint64_t now, uint32_t period_us, uint32_t ticks);
+
+/**
+ * @brief Get the number of overrun wakeups left out of the jitter stats
+ *
+ * @return Wakeups with more than one tick since the last reset
+ */
+uint32_t sampler_stats_overruns(void);
+
+/**
+ * @brief Copy out one accumulator
+ *
+ * @param id  Accumulator to read
+ * @param out Structure receiving a consistent snapshot
+ */
+void sampler_stats_get(enum sampler_stat_id id, struct sampler_stat *out);
+
+#else
+
+static inline void sampler_stats_init(void) {}
+static inline void sampler_stats_reset(void) {}
+static inline uint64_t sampler_stats_now(void) { return 0; }
+static inline void sampler_stats_record(enum sampler_stat_id id, uint64_t start,
+                                        uint64_t end) {}
+static inline void sampler_stats_wakeup(uint64_t now, uint32_t period_us, uint32_t ticks) {}
+static inline uint32_t sampler_stats_overruns(void) { return 0; }
+
+#endif /* CONFIG_APP_SAMPLER_STATS */
+
+#endif /* SAMPLER_STATS_H_ */
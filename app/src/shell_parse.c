@@ -0,0 +1,27 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell argument parsing shared by the adc* commands
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include "shell_parse.h"
+
+int shell_parse_u32(const struct shell *sh, const char *arg, int base, uint32_t max,
+                    uint32_t *val)
+{
+    char *end;
+    unsigned long v;
+
+    /* strtoul() would negate "-1" into a valid value */
+    errno = 0;
+    v = strtoul(arg, &end, base);
+    if (arg[0] == '-' || end == arg || *end != '\0' || errno != 0 || v > max) {
+        shell_error(sh, "Invalid value %s (0-%u)", arg, max);
+        return -EINVAL;
+    }
+
+    *val = (uint32_t)v;
+    return 0;
+}
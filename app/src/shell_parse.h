@@ -0,0 +1,29 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell argument parsing shared by the adc* commands
+ */
+
+#ifndef SHELL_PARSE_H_
+#define SHELL_PARSE_H_
+
+#include <stdint.h>
+#include <zephyr/shell/shell.h>
+
+/**
+ * @brief Parse an unsigned shell argument
+ *
+ * Rejects an empty or negative argument, trailing characters and values
+ * above @p max, printing the accepted range.
+ *
+ * @param sh   Shell to report errors on
+ * @param arg  Argument text
+ * @param base strtoul() base: 10, or 0 to also take 0x and 0 prefixes
+ * @param max  Largest accepted value
+ * @param val  Receives the value on success
+ * @return 0 on success, -EINVAL on invalid input
+ */
+int shell_parse_u32(const struct shell *sh, const char *arg, int base, uint32_t max,
+                    uint32_t *val);
+
+#endif /* SHELL_PARSE_H_ */
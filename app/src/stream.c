@@ -0,0 +1,518 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sample Stream Implementation
+ */
+
+#include "stream.h"
+#include "stream_proto.h"
+#include "sample_ring.h"
+#include "sample_sched.h"
+#include "filter.h"
+#include "mem_placement.h"
+#include "threshold.h"
+#include "capture.h"
+#include "chan_stats.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(stream, LOG_LEVEL_INF);
+
+#define STREAM_UART_NODE DT_CHOSEN(app_stream_uart)
+
+/* Frames encoded from the ring per pass */
+#define STREAM_BATCH 8
+
+#if defined(CONFIG_APP_CHAN_STATS_STREAM_INTERVAL_MS) && \
+    CONFIG_APP_CHAN_STATS_STREAM_INTERVAL_MS > 0
+#define STREAM_STATS_INTERVAL_MS CONFIG_APP_CHAN_STATS_STREAM_INTERVAL_MS
+#else
+#define STREAM_STATS_INTERVAL_MS 0
+#endif
+
+#if defined(CONFIG_APP_STREAM_DELTA)
+/* Last frame sent, for DELTA coding; stream thread only */
+static struct stream_delta_ref delta_ref;
+#endif
+
+BUILD_ASSERT(CONFIG_APP_STREAM_TX_BUF_SIZE >= STREAM_MAX_PKT_SIZE,
+             "CONFIG_APP_STREAM_TX_BUF_SIZE is smaller than one packet");
+
+static const struct device *const stream_dev = DEVICE_DT_GET(STREAM_UART_NODE);
+
+K_THREAD_STACK_DEFINE(stream_thread_stack, CONFIG_APP_STREAM_THREAD_STACK_SIZE);
+static struct k_thread stream_thread_data;
+
+/* Double-buffered TX: one buffer is filled while DMA sends the other */
+static uint8_t tx_buf[2][CONFIG_APP_STREAM_TX_BUF_SIZE] APP_DMA_BSS;
+static K_SEM_DEFINE(tx_done_sem, 1, 1);
+
+/* Given on stream_start() and on a capture download request */
+static K_SEM_DEFINE(stream_wake_sem, 0, 1);
+static atomic_t stream_running;
+static atomic_t stream_mode;
+static bool stream_async;
+
+/* Counters, written by the stream thread and read by the shell */
+static struct k_spinlock status_lock;
+static struct stream_status status;
+
+/* Packets waiting in one TX buffer, added to the status once it is sent */
+struct tx_count {
+    uint32_t frames;
+    uint32_t delta;
+    uint32_t events;
+    uint32_t stats;
+};
+
+static struct tx_count tx_pending[2];
+
+static void stream_uart_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    switch (evt->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        k_sem_give(&tx_done_sem);
+        break;
+    default:
+        break;
+    }
+}
+
+static int stream_send(const uint8_t *buf, size_t len)
+{
+    int ret = 0;
+    k_spinlock_key_t key;
+
+    if (stream_async) {
+        /* Wait for the previous buffer; this one stays untouched until done */
+        k_sem_take(&tx_done_sem, K_FOREVER);
+        ret = uart_tx(stream_dev, buf, len, SYS_FOREVER_US);
+        if (ret < 0) {
+            k_sem_give(&tx_done_sem);
+            return ret;
+        }
+    } else {
+        for (size_t i = 0; i < len; i++) {
+            uart_poll_out(stream_dev, buf[i]);
+        }
+    }
+
+    key = k_spin_lock(&status_lock);
+    status.bytes_sent += len;
+    k_spin_unlock(&status_lock, key);
+    return ret;
+}
+
+/* Send the next frame whole */
+static void stream_ref_reset(void)
+{
+#if defined(CONFIG_APP_STREAM_DELTA)
+    delta_ref.valid = false;
+#endif
+}
+
+/* Send TX buffer *cur, then switch to the other one */
+static int stream_flush(int *cur, size_t used)
+{
+    struct tx_count *n = &tx_pending[*cur];
+    int ret = stream_send(tx_buf[*cur], used);
+    k_spinlock_key_t key;
+
+    if (ret < 0) {
+        key = k_spin_lock(&status_lock);
+        status.tx_errors++;
+        k_spin_unlock(&status_lock, key);
+        /* The lost frames may include the DELTA reference */
+        if (n->frames > 0) {
+            stream_ref_reset();
+        }
+    } else {
+        /* Only packets the UART accepted count as sent */
+        key = k_spin_lock(&status_lock);
+        status.frames_sent += n->frames;
+        status.delta_sent += n->delta;
+        status.events_sent += n->events;
+        status.stats_sent += n->stats;
+        k_spin_unlock(&status_lock, key);
+    }
+
+    *n = (struct tx_count){ 0 };
+    *cur ^= 1;
+    return ret;
+}
+
+static void stream_send_info(int *cur)
+{
+    struct stream_info info = {
+        .period_us = sample_sched_period_us() * filter_decimation(),
+    };
+    int len;
+
+    regs_get_scale(0, &info.ref_mv, &info.resolution);
+    len = stream_encode_info(&info, tx_buf[*cur], CONFIG_APP_STREAM_TX_BUF_SIZE);
+
+    if (len > 0) {
+        (void)stream_flush(cur, len);
+    }
+}
+
+#if defined(CONFIG_APP_THRESHOLDS)
+/* Queued threshold events go first in a batch, using at most half of it */
+static size_t stream_put_events(int cur)
+{
+    struct threshold_event ev;
+    uint8_t *buf = tx_buf[cur];
+    size_t used = 0;
+
+    while (used + STREAM_EVENT_PKT_SIZE <= CONFIG_APP_STREAM_TX_BUF_SIZE / 2 &&
+           threshold_get_event(&ev, K_NO_WAIT) == 0) {
+        used += stream_encode_event(ev.seq, ev.ch, ev.type, ev.raw, &buf[used],
+                                    CONFIG_APP_STREAM_TX_BUF_SIZE - used);
+        tx_pending[cur].events++;
+    }
+
+    return used;
+}
+#endif
+
+#if STREAM_STATS_INTERVAL_MS > 0
+/* Close the stream's statistics window once per interval, flushing if full */
+static size_t stream_put_stats(int *cur, size_t used, int64_t *next_ms)
+{
+    struct chan_stats_snapshot snap;
+    int64_t now_ms = k_uptime_get();
+    int len;
+
+    if (now_ms < *next_ms) {
+        return used;
+    }
+    /* Skip intervals missed while blocked rather than sending a burst */
+    *next_ms = MAX(*next_ms + STREAM_STATS_INTERVAL_MS, now_ms);
+
+    chan_stats_read(CHAN_STATS_STREAM, &snap, true);
+    len = stream_encode_stats(&snap, &tx_buf[*cur][used], CONFIG_APP_STREAM_TX_BUF_SIZE - used);
+    if (len < 0) {
+        (void)stream_flush(cur, used);
+        used = 0;
+        len = stream_encode_stats(&snap, tx_buf[*cur], CONFIG_APP_STREAM_TX_BUF_SIZE);
+    }
+    tx_pending[*cur].stats++;
+
+    return used + len;
+}
+
+static void stream_stats_restart(int64_t *next_ms)
+{
+    struct chan_stats_snapshot snap;
+
+    chan_stats_read(CHAN_STATS_STREAM, &snap, true);
+    *next_ms = k_uptime_get() + STREAM_STATS_INTERVAL_MS;
+}
+#else
+static inline size_t stream_put_stats(int *cur, size_t used, int64_t *next_ms)
+{
+    ARG_UNUSED(cur);
+    ARG_UNUSED(next_ms);
+    return used;
+}
+
+static inline void stream_stats_restart(int64_t *next_ms)
+{
+    ARG_UNUSED(next_ms);
+}
+#endif
+
+/* Report the ring's drop count, flushing if full */
+static size_t stream_put_drop(int *cur, size_t used, uint32_t dropped)
+{
+    int len = stream_encode_drop(dropped, &tx_buf[*cur][used],
+                                 CONFIG_APP_STREAM_TX_BUF_SIZE - used);
+
+    /* Events and stats may have left less than a DROP packet free */
+    if (len < 0) {
+        (void)stream_flush(cur, used);
+        used = 0;
+        len = stream_encode_drop(dropped, tx_buf[*cur], CONFIG_APP_STREAM_TX_BUF_SIZE);
+    }
+
+    return used + len;
+}
+
+#if defined(CONFIG_APP_CAPTURE)
+/* Pending download: set by stream_send_capture(), cleared by the thread */
+static atomic_t capture_req;
+static uint32_t capture_index;
+static uint32_t capture_count;
+
+/* Send a requested capture range: CAPTURE_INFO, then CAPTURE_DATA chunks */
+static void stream_put_capture(int *cur)
+{
+    struct capture_status st;
+    struct stream_capture_info info;
+    uint16_t chunk[STREAM_CAPTURE_CHUNK];
+    uint32_t index = capture_index;
+    uint32_t end;
+    size_t used = 0;
+    int len;
+
+    if (!atomic_get(&capture_req)) {
+        return;
+    }
+
+    /* Pinned by stream_send_capture(), so no new capture can overwrite it */
+    capture_get_status(&st);
+    info = (struct stream_capture_info){
+        .ch = st.config.ch,
+        .samples = st.config.samples,
+        .trigger_index = st.config.pre_samples,
+        .interval_ns = st.interval_ns,
+    };
+    regs_get_scale(info.ch, &info.ref_mv, &info.resolution);
+    end = MIN((uint64_t)index + capture_count, st.config.samples);
+
+    used = stream_encode_capture_info(&info, tx_buf[*cur], CONFIG_APP_STREAM_TX_BUF_SIZE);
+
+    while (index < end) {
+        size_t n = capture_read(index, chunk, MIN(end - index, STREAM_CAPTURE_CHUNK));
+
+        len = stream_encode_capture_data(index, chunk, n, &tx_buf[*cur][used],
+                                         CONFIG_APP_STREAM_TX_BUF_SIZE - used);
+        if (len < 0) {
+            (void)stream_flush(cur, used);
+            used = 0;
+            continue;
+        }
+
+        used += len;
+        index += n;
+    }
+
+    (void)stream_flush(cur, used);
+
+    capture_unlock();
+    atomic_clear(&capture_req);
+}
+#else
+static inline void stream_put_capture(int *cur)
+{
+    ARG_UNUSED(cur);
+}
+#endif /* CONFIG_APP_CAPTURE */
+
+/* Delta state for the next frame, NULL to send it whole */
+static struct stream_delta_ref *stream_next_ref(void)
+{
+#if defined(CONFIG_APP_STREAM_DELTA)
+    /* Periodic whole frames let a host that lost a packet pick up again */
+    if (delta_ref.run >= CONFIG_APP_STREAM_KEYFRAME_INTERVAL) {
+        delta_ref.valid = false;
+    }
+    return &delta_ref;
+#else
+    return NULL;
+#endif
+}
+
+static void stream_thread_entry(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    struct sample_ring_reader rd;
+    uint32_t reported_dropped;
+    int64_t next_stats_ms = 0;
+    int cur = 0;
+
+    while (1) {
+        k_sem_take(&stream_wake_sem, K_FOREVER);
+
+        /* Downloads are also served while the frame stream is stopped */
+        stream_put_capture(&cur);
+        if (!atomic_get(&stream_running)) {
+            continue;
+        }
+
+        sample_ring_reader_init(&rd);
+        reported_dropped = 0;
+        stream_ref_reset();
+#if defined(CONFIG_APP_THRESHOLDS)
+        threshold_flush_events();
+#endif
+        stream_stats_restart(&next_stats_ms);
+        stream_send_info(&cur);
+
+        while (atomic_get(&stream_running)) {
+            const struct sample_ring_slot *frame;
+            k_spinlock_key_t key;
+            size_t used = 0;
+
+            stream_put_capture(&cur);
+            if (atomic_get(&stream_mode) == STREAM_MODE_FRAMES) {
+                frame = sample_ring_peek(&rd);
+            } else {
+                /* Keep the cursor current so switching back skips the backlog */
+                uint32_t dropped = rd.dropped;
+
+                sample_ring_reader_init(&rd);
+                rd.dropped = dropped;
+                frame = NULL;
+            }
+
+#if defined(CONFIG_APP_THRESHOLDS)
+            used = stream_put_events(cur);
+#endif
+            used = stream_put_stats(&cur, used, &next_stats_ms);
+            if (frame == NULL && used == 0) {
+                k_usleep(CONFIG_APP_STREAM_POLL_US);
+                continue;
+            }
+
+            if (rd.dropped != reported_dropped) {
+                used = stream_put_drop(&cur, used, rd.dropped);
+                reported_dropped = rd.dropped;
+                key = k_spin_lock(&status_lock);
+                status.dropped = rd.dropped;
+                k_spin_unlock(&status_lock, key);
+            }
+
+            /* Encode straight from the packed ring slots, no intermediate copy */
+            for (int n = 0; frame != NULL && n < STREAM_BATCH;
+                 frame = sample_ring_peek(&rd)) {
+                struct stream_delta_ref *ref = stream_next_ref();
+                int len = stream_encode_frame(frame, ref, &tx_buf[cur][used],
+                                              CONFIG_APP_STREAM_TX_BUF_SIZE - used);
+
+                if (len < 0) {
+                    /* Buffer full: flush it and continue in the other one */
+                    (void)stream_flush(&cur, used);
+                    used = 0;
+                    len = stream_encode_frame(frame, ref, tx_buf[cur],
+                                              CONFIG_APP_STREAM_TX_BUF_SIZE);
+                }
+
+                /*
+                 * Lapped while encoding: drop the packet, the next peek
+                 * skips ahead, and the next frame goes out whole
+                 */
+                if (!sample_ring_consume(&rd)) {
+                    stream_ref_reset();
+                    continue;
+                }
+                if (tx_buf[cur][used + 3] & STREAM_FLAG_DELTA) {
+                    tx_pending[cur].delta++;
+                }
+                used += len;
+                n++;
+                tx_pending[cur].frames++;
+            }
+
+            if (used > 0) {
+                (void)stream_flush(&cur, used);
+            }
+        }
+    }
+}
+
+int stream_init(void)
+{
+    int ret;
+
+    if (!device_is_ready(stream_dev)) {
+        LOG_ERR("Stream UART not ready");
+        return -ENODEV;
+    }
+
+    /* Fall back to polled TX on drivers without the async API */
+    ret = uart_callback_set(stream_dev, stream_uart_cb, NULL);
+    stream_async = (ret == 0);
+
+    k_thread_create(&stream_thread_data, stream_thread_stack,
+                    K_THREAD_STACK_SIZEOF(stream_thread_stack),
+                    stream_thread_entry,
+                    NULL, NULL, NULL,
+                    CONFIG_APP_STREAM_THREAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&stream_thread_data, "adc_stream");
+
+    LOG_INF("Stream on %s (%s TX)", stream_dev->name, stream_async ? "async" : "polled");
+    return 0;
+}
+
+int stream_start(enum stream_mode mode)
+{
+    k_spinlock_key_t key;
+
+    if (mode == STREAM_MODE_STATS && STREAM_STATS_INTERVAL_MS == 0) {
+        return -ENOTSUP;
+    }
+
+    atomic_set(&stream_mode, mode);
+    if (atomic_set(&stream_running, 1)) {
+        return 0;
+    }
+
+    key = k_spin_lock(&status_lock);
+    status.frames_sent = 0;
+    status.delta_sent = 0;
+    status.bytes_sent = 0;
+    status.dropped = 0;
+    status.events_sent = 0;
+    status.stats_sent = 0;
+    status.tx_errors = 0;
+    k_spin_unlock(&status_lock, key);
+    k_sem_give(&stream_wake_sem);
+
+    return 0;
+}
+
+void stream_stop(void)
+{
+    atomic_set(&stream_running, 0);
+}
+
+#if defined(CONFIG_APP_CAPTURE)
+int stream_send_capture(uint32_t index, uint32_t count)
+{
+    int ret;
+
+    if (!device_is_ready(stream_dev)) {
+        return -ENODEV;
+    }
+
+    if (atomic_get(&capture_req)) {
+        return -EBUSY;
+    }
+
+    ret = capture_lock();
+    if (ret < 0) {
+        return ret;
+    }
+
+    capture_index = index;
+    capture_count = count;
+    if (!atomic_cas(&capture_req, 0, 1)) {
+        capture_unlock();
+        return -EBUSY;
+    }
+    k_sem_give(&stream_wake_sem);
+
+    return 0;
+}
+#endif
+
+void stream_get_status(struct stream_status *out)
+{
+    k_spinlock_key_t key = k_spin_lock(&status_lock);
+
+    *out = status;
+    k_spin_unlock(&status_lock, key);
+    out->running = atomic_get(&stream_running);
+    out->async_tx = stream_async;
+    out->mode = (enum stream_mode)atomic_get(&stream_mode);
+}
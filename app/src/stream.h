@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Sample Stream - Binary frame transport on a dedicated UART
+ *
+ * A stream thread drains the sample ring with its own reader, encodes
+ * frames with stream_proto.h and sends them on the UART chosen as
+ * 'app,stream-uart' in devicetree, using the async (DMA) TX API when the
+ * driver supports it and polled TX otherwise. The shell thread is never
+ * involved in the data path.
+ */
+
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Whether the stream sends frames
+ *
+ * INFO, EVENT and STATS packets are sent in both modes.
+ */
+enum stream_mode {
+    STREAM_MODE_FRAMES,  /* Every frame from the sample ring */
+    STREAM_MODE_STATS,   /* No frames, for low-bandwidth dashboards */
+};
+
+/**
+ * @brief Stream counters
+ */
+struct stream_status {
+    bool running;          /* Stream is enabled */
+    bool async_tx;         /* Using the UART async (DMA) API */
+    enum stream_mode mode;
+    uint32_t frames_sent;  /* FRAME packets the UART accepted since start */
+    uint32_t delta_sent;   /* Of those, DELTA-coded against the previous one */
+    uint32_t bytes_sent;   /* Bytes handed to the UART since start */
+    uint32_t dropped;      /* Frames the stream could not keep up with */
+    uint32_t events_sent;  /* EVENT packets sent since start */
+    uint32_t stats_sent;   /* STATS packets sent since start */
+    uint32_t tx_errors;    /* TX buffers the UART refused, packets lost */
+};
+
+/**
+ * @brief Initialize the stream transport
+ *
+ * Creates the stream thread in the stopped state.
+ *
+ * @return 0 on success, negative errno on failure
+ */
+int stream_init(void);
+
+/**
+ * @brief Start streaming from the newest sample onwards
+ *
+ * Sends an INFO packet first. If already running, only switches the
+ * mode. STATS packets cover CONFIG_APP_CHAN_STATS_STREAM_INTERVAL_MS
+ * windows in either mode.
+ *
+ * @param mode Whether to send frames
+ * @return 0 on success, -ENOTSUP for STREAM_MODE_STATS without STATS
+ *         packets configured
+ */
+int stream_start(enum stream_mode mode);
+
+/**
+ * @brief Stop streaming after the packet in flight
+ */
+void stream_stop(void);
+
+/**
+ * @brief Queue a download of a finished burst capture
+ *
+ * The stream thread sends a CAPTURE_INFO packet and the samples
+ * [index, index + count) as CAPTURE_DATA packets, interleaved with the
+ * frame stream if it is running. The capture cannot be re-armed until
+ * the download completes.
+ *
+ * @param index First sample
+ * @param count Number of samples, clipped to the end of the capture
+ * @return 0 on success, -ENODATA if no capture is done, -EBUSY while
+ *         another download is queued, -ENODEV without a stream UART
+ */
+int stream_send_capture(uint32_t index, uint32_t count);
+
+/**
+ * @brief Get stream counters
+ *
+ * @param out Structure to receive the current status
+ */
+void stream_get_status(struct stream_status *out);
+
+#endif /* STREAM_H_ */
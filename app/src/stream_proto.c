@@ -0,0 +1,217 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Stream Protocol Encoder
+ */
+
+#include "stream_proto.h"
+#include "frame_pack.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+/* Fill in header and CRC around a payload already written at buf + HDR */
+static int finish_packet(uint8_t type, uint8_t flags, size_t payload_len, uint8_t *buf)
+{
+    uint16_t crc;
+
+    buf[0] = STREAM_SYNC0;
+    buf[1] = STREAM_SYNC1;
+    buf[2] = type;
+    buf[3] = flags;
+    sys_put_le16((uint16_t)payload_len, &buf[4]);
+
+    crc = crc16_itu_t(0xFFFF, &buf[2], STREAM_HDR_SIZE - 2 + payload_len);
+    sys_put_le16(crc, &buf[STREAM_HDR_SIZE + payload_len]);
+
+    return STREAM_HDR_SIZE + payload_len + STREAM_CRC_SIZE;
+}
+
+int stream_encode_info(const struct stream_info *info, uint8_t *buf, size_t len)
+{
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+
+    if (len < STREAM_HDR_SIZE + STREAM_INFO_PAYLOAD_SIZE + STREAM_CRC_SIZE) {
+        return -ENOMEM;
+    }
+
+    p[0] = STREAM_PROTO_VERSION;
+    p[1] = NUM_CH;
+    p[2] = info->resolution;
+    p[3] = 0;
+    sys_put_le16(info->ref_mv, &p[4]);
+    sys_put_le32(info->period_us, &p[6]);
+
+    return finish_packet(STREAM_PKT_INFO, 0, STREAM_INFO_PAYLOAD_SIZE, buf);
+}
+
+/* DELTA time and values; 0 if they take more than max bytes */
+static size_t encode_delta(const struct sample_ring_slot *slot, const uint16_t raw[NUM_CH],
+                           const struct stream_delta_ref *ref, uint8_t *p, size_t max)
+{
+    uint8_t head[2 * FRAME_VARINT_MAX_SIZE];
+    size_t head_len = frame_varint_put(slot->seq, head);
+    size_t values_len;
+
+    head_len += frame_varint_put(
+        frame_zigzag((int64_t)(slot->timestamp_ns - ref->timestamp_ns)), &head[head_len]);
+    if (head_len >= max) {
+        return 0;
+    }
+    memcpy(p, head, head_len);
+
+    values_len = frame_delta_encode(raw, ref->raw, NUM_CH, &p[head_len], max - head_len);
+    return (values_len == 0) ? 0 : head_len + values_len;
+}
+
+int stream_encode_frame(const struct sample_ring_slot *slot, struct stream_delta_ref *ref,
+                        uint8_t *buf, size_t len)
+{
+    size_t values_len = STREAM_VALUES_SIZE(SAMPLE_RING_PACK12);
+    size_t whole_len = STREAM_FRAME_FIXED_SIZE + values_len;
+    size_t payload_len = 0;
+    uint8_t flags = slot->synced ? STREAM_FLAG_SYNCED : 0;
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+    uint16_t raw[NUM_CH];
+
+    if (len < STREAM_HDR_SIZE + whole_len + STREAM_CH_TIME_SIZE + STREAM_CRC_SIZE) {
+        return -ENOMEM;
+    }
+
+    if (ref != NULL) {
+        frame_unpack(slot->codes, NUM_CH, SAMPLE_RING_PACK12, raw);
+        if (ref->valid && slot->seq == ref->seq + 1) {
+            /* Only worth it if shorter than the whole frame */
+            payload_len = encode_delta(slot, raw, ref, p, whole_len - 1);
+        }
+    }
+
+    if (payload_len > 0) {
+        flags |= STREAM_FLAG_DELTA;
+        ref->run++;
+    } else {
+        sys_put_le32(slot->seq, &p[0]);
+        sys_put_le64(slot->timestamp_ns, &p[4]);
+        p[12] = NUM_CH;
+        memcpy(&p[STREAM_FRAME_FIXED_SIZE], slot->codes, values_len);
+        payload_len = whole_len;
+        flags |= SAMPLE_RING_PACK12 ? STREAM_FLAG_PACK12 : 0;
+        if (ref != NULL) {
+            ref->run = 0;
+        }
+    }
+
+    if (ref != NULL) {
+        ref->valid = true;
+        ref->seq = slot->seq;
+        ref->timestamp_ns = slot->timestamp_ns;
+        memcpy(ref->raw, raw, sizeof(ref->raw));
+    }
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    for (int i = 0; i < NUM_CH; i++) {
+        sys_put_le32(slot->ch_offset_ns[i], &p[payload_len]);
+        payload_len += 4;
+    }
+    flags |= STREAM_FLAG_CH_TIME;
+#endif
+
+    return finish_packet(STREAM_PKT_FRAME, flags, payload_len, buf);
+}
+
+int stream_encode_drop(uint32_t total_dropped, uint8_t *buf, size_t len)
+{
+    if (len < STREAM_HDR_SIZE + STREAM_DROP_PAYLOAD_SIZE + STREAM_CRC_SIZE) {
+        return -ENOMEM;
+    }
+
+    sys_put_le32(total_dropped, &buf[STREAM_HDR_SIZE]);
+
+    return finish_packet(STREAM_PKT_DROP, 0, STREAM_DROP_PAYLOAD_SIZE, buf);
+}
+
+int stream_encode_event(uint32_t seq, uint8_t ch, uint8_t type, uint16_t raw,
+                        uint8_t *buf, size_t len)
+{
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+
+    if (len < STREAM_EVENT_PKT_SIZE) {
+        return -ENOMEM;
+    }
+
+    sys_put_le32(seq, &p[0]);
+    p[4] = ch;
+    p[5] = type;
+    sys_put_le16(raw, &p[6]);
+
+    return finish_packet(STREAM_PKT_EVENT, 0, STREAM_EVENT_PAYLOAD_SIZE, buf);
+}
+
+int stream_encode_capture_info(const struct stream_capture_info *info, uint8_t *buf,
+                               size_t len)
+{
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+
+    if (len < STREAM_HDR_SIZE + STREAM_CAPTURE_INFO_PAYLOAD_SIZE + STREAM_CRC_SIZE) {
+        return -ENOMEM;
+    }
+
+    p[0] = info->ch;
+    p[1] = info->resolution;
+    sys_put_le16(info->ref_mv, &p[2]);
+    sys_put_le32(info->samples, &p[4]);
+    sys_put_le32(info->trigger_index, &p[8]);
+    sys_put_le32(info->interval_ns, &p[12]);
+
+    return finish_packet(STREAM_PKT_CAPTURE_INFO, 0, STREAM_CAPTURE_INFO_PAYLOAD_SIZE, buf);
+}
+
+int stream_encode_capture_data(uint32_t index, const uint16_t *raw, size_t count,
+                               uint8_t *buf, size_t len)
+{
+    size_t payload_len = STREAM_CAPTURE_DATA_FIXED_SIZE + count * 2;
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+
+    if (count == 0 || count > STREAM_CAPTURE_CHUNK) {
+        return -EINVAL;
+    }
+    if (len < STREAM_HDR_SIZE + payload_len + STREAM_CRC_SIZE) {
+        return -ENOMEM;
+    }
+
+    sys_put_le32(index, &p[0]);
+    for (size_t i = 0; i < count; i++) {
+        sys_put_le16(raw[i], &p[STREAM_CAPTURE_DATA_FIXED_SIZE + i * 2]);
+    }
+
+    return finish_packet(STREAM_PKT_CAPTURE_DATA, 0, payload_len, buf);
+}
+
+int stream_encode_stats(const struct chan_stats_snapshot *snap, uint8_t *buf, size_t len)
+{
+    size_t payload_len = STREAM_STATS_FIXED_SIZE + NUM_CH * STREAM_STATS_CH_SIZE;
+    uint8_t *p = &buf[STREAM_HDR_SIZE];
+    uint8_t *c = &p[STREAM_STATS_FIXED_SIZE];
+
+    if (len < STREAM_STATS_PKT_SIZE) {
+        return -ENOMEM;
+    }
+
+    sys_put_le32(snap->duration_ms, &p[0]);
+    p[4] = NUM_CH;
+
+    for (int i = 0; i < NUM_CH; i++) {
+        const struct chan_stats *st = &snap->ch[i];
+
+        sys_put_le32(st->count, &c[0]);
+        sys_put_le16(st->min, &c[4]);
+        sys_put_le16(st->max, &c[6]);
+        sys_put_le16(st->mean, &c[8]);
+        sys_put_le16(st->rms, &c[10]);
+        c += STREAM_STATS_CH_SIZE;
+    }
+
+    return finish_packet(STREAM_PKT_STATS, 0, payload_len, buf);
+}
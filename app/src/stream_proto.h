@@ -0,0 +1,284 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Stream Protocol - Framed binary packets for the sample stream
+ *
+ * All multi-byte fields are little-endian. Every packet is:
+ *
+ *   off  size  field
+ *   0    1     sync0 (0xA5)
+ *   1    1     sync1 (0x5A)
+ *   2    1     type (STREAM_PKT_*)
+ *   3    1     flags (STREAM_FLAG_*)
+ *   4    2     payload length N
+ *   6    N     payload
+ *   6+N  2     CRC-16/CCITT-FALSE over bytes 2 .. 6+N-1
+ *
+ * This header is the protocol reference; host decoders must match it.
+ */
+
+#ifndef STREAM_PROTO_H_
+#define STREAM_PROTO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+#include "regs.h"
+#include "sample_ring.h"
+#include "chan_stats.h"
+
+#define STREAM_SYNC0 0xA5
+#define STREAM_SYNC1 0x5A
+
+#define STREAM_PROTO_VERSION 4
+
+/* Header (sync, type, flags, length) and trailer (CRC) sizes */
+#define STREAM_HDR_SIZE 6
+#define STREAM_CRC_SIZE 2
+
+/* Packet types */
+#define STREAM_PKT_INFO  0x01  /* Stream description, sent on start */
+#define STREAM_PKT_FRAME 0x02  /* One sample frame */
+#define STREAM_PKT_DROP  0x03  /* Frames lost on the board before encoding */
+#define STREAM_PKT_EVENT 0x04  /* Threshold alarm or change notification */
+#define STREAM_PKT_CAPTURE_INFO 0x05  /* Burst capture description */
+#define STREAM_PKT_CAPTURE_DATA 0x06  /* Consecutive samples of a burst capture */
+#define STREAM_PKT_STATS 0x07  /* Per-channel statistics over a window */
+
+/* Packet flags */
+#define STREAM_FLAG_PACK12  BIT(0)  /* FRAME: values are 12-bit packed */
+#define STREAM_FLAG_CH_TIME BIT(1)  /* FRAME: per-channel offsets follow the values */
+#define STREAM_FLAG_SYNCED  BIT(2)  /* FRAME: frame start is sync time (sync.h) */
+#define STREAM_FLAG_DELTA   BIT(3)  /* FRAME: coded against the previous FRAME */
+
+/*
+ * INFO payload:
+ *   0  1  protocol version
+ *   1  1  number of channels
+ *   2  1  raw code resolution in bits (0 = values are millivolts)
+ *   3  1  reserved
+ *   4  2  reference voltage in mV
+ *   6  4  frame period in microseconds
+ */
+#define STREAM_INFO_PAYLOAD_SIZE 10
+
+/*
+ * FRAME payload:
+ *   0  4  seq
+ *   4  8  frame start, ns since boot (regs_clock_ns()), or with
+ *         STREAM_FLAG_SYNCED ns since the first edge of the sync train
+ *         this board saw; a board that joined the train late is whole
+ *         sync periods behind the others (see sync.h)
+ *   12 1  number of channels
+ *   13 .  raw codes as packed by frame_pack(): 2 bytes each, or with
+ *         STREAM_FLAG_PACK12 two values per 3 bytes (v0[7:0],
+ *         v0[11:8] | v1[3:0] << 4, v1[11:4]); an odd trailing value
+ *         takes 2 bytes.
+ *   .  .  with STREAM_FLAG_CH_TIME: per channel, 4 bytes of ns from the
+ *         frame start to its conversion
+ *
+ * With STREAM_FLAG_DELTA the frame is coded against the previous FRAME
+ * packet, whose seq is this frame's minus one and whose channel count it
+ * shares (see frame_pack.h for varints and zigzag):
+ *   0  .  varint: seq, so a decoder can tell it follows its predecessor
+ *   .  .  varint: zigzag of the frame start minus the previous one's
+ *   .  .  per channel, frame_delta_encode(): varint zigzag of the raw
+ *         code minus the previous frame's
+ *   .  .  with STREAM_FLAG_CH_TIME: offsets as above
+ * A DELTA frame needs its predecessor: a decoder that missed it, or whose
+ * last FRAME has another seq than this one's minus one, skips frames until
+ * the next one without the flag. The encoder sends a whole
+ * frame whenever the delta coding would not be shorter.
+ */
+#define STREAM_FRAME_FIXED_SIZE 13
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+#define STREAM_CH_TIME_SIZE (NUM_CH * 4)
+#else
+#define STREAM_CH_TIME_SIZE 0
+#endif
+
+/* DROP payload: 0  4  total frames dropped since the stream started */
+#define STREAM_DROP_PAYLOAD_SIZE 4
+
+/*
+ * EVENT payload:
+ *   0  4  seq of the frame that triggered the event
+ *   4  1  channel
+ *   5  1  event type (1 HIGH, 2 LOW, 3 CLEAR, 4 CHANGE; see threshold.h)
+ *   6  2  raw code that triggered the event
+ */
+#define STREAM_EVENT_PAYLOAD_SIZE 8
+#define STREAM_EVENT_PKT_SIZE \
+    (STREAM_HDR_SIZE + STREAM_EVENT_PAYLOAD_SIZE + STREAM_CRC_SIZE)
+
+/*
+ * CAPTURE_INFO payload, sent before the CAPTURE_DATA packets of a download:
+ *   0  1  channel
+ *   1  1  raw code resolution in bits
+ *   2  2  reference voltage in mV
+ *   4  4  samples in the capture
+ *   8  4  trigger sample index (= pre-trigger samples)
+ *   12 4  mean interval between samples in nanoseconds
+ */
+#define STREAM_CAPTURE_INFO_PAYLOAD_SIZE 16
+
+/*
+ * CAPTURE_DATA payload:
+ *   0  4  index of the first sample in the capture
+ *   4  .  raw codes, 2 bytes each; (payload length - 4) / 2 of them
+ */
+#define STREAM_CAPTURE_DATA_FIXED_SIZE 4
+
+/*
+ * STATS payload:
+ *   0  4  window length in ms
+ *   4  1  number of channels
+ *   5  .  per channel, 12 bytes: sample count (4), min (2), max (2),
+ *         mean (2), RMS (2); raw codes, all 0 if the count is 0
+ */
+#define STREAM_STATS_FIXED_SIZE 5
+#define STREAM_STATS_CH_SIZE    12
+#define STREAM_STATS_PKT_SIZE                                                   \
+    (STREAM_HDR_SIZE + STREAM_STATS_FIXED_SIZE + NUM_CH * STREAM_STATS_CH_SIZE + \
+     STREAM_CRC_SIZE)
+
+/** Samples per CAPTURE_DATA packet, at most */
+#define STREAM_CAPTURE_CHUNK 64
+
+/** Bytes needed for NUM_CH values in the given packing */
+#define STREAM_VALUES_SIZE(pack12) FRAME_PACKED_SIZE(NUM_CH, pack12)
+
+/** Largest packet the encoder produces */
+#define STREAM_MAX_PKT_SIZE                                                     \
+    MAX(STREAM_HDR_SIZE + STREAM_CRC_SIZE +                                     \
+        MAX(STREAM_FRAME_FIXED_SIZE + STREAM_VALUES_SIZE(0) +                   \
+            STREAM_CH_TIME_SIZE,                                                \
+            STREAM_CAPTURE_DATA_FIXED_SIZE + STREAM_CAPTURE_CHUNK * 2),         \
+        STREAM_STATS_PKT_SIZE)
+
+/**
+ * @brief Stream description carried by the INFO packet
+ */
+struct stream_info {
+    uint8_t resolution;   /* Bits per raw code, 0 if values are mV */
+    uint16_t ref_mv;      /* Full-scale reference voltage */
+    uint32_t period_us;   /* Nominal frame period */
+};
+
+/**
+ * @brief Encoder state for DELTA frames: the last frame sent
+ *
+ * Owned by one stream. Clear @p valid to make the next frame whole, e.g.
+ * on start or when the packet last encoded was discarded.
+ */
+struct stream_delta_ref {
+    bool valid;             /* The fields below describe the last frame sent */
+    uint16_t run;           /* DELTA frames since the last whole frame */
+    uint32_t seq;
+    uint64_t timestamp_ns;
+    uint16_t raw[NUM_CH];
+};
+
+/**
+ * @brief Burst capture description carried by the CAPTURE_INFO packet
+ */
+struct stream_capture_info {
+    uint8_t ch;             /* Captured channel */
+    uint8_t resolution;     /* Bits per raw code */
+    uint16_t ref_mv;        /* Full-scale reference voltage */
+    uint32_t samples;       /* Samples in the capture */
+    uint32_t trigger_index; /* Index of the trigger sample */
+    uint32_t interval_ns;   /* Mean interval between samples */
+};
+
+/**
+ * @brief Encode an INFO packet
+ *
+ * @param info Stream description
+ * @param buf  Output buffer
+ * @param len  Size of @p buf
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ */
+int stream_encode_info(const struct stream_info *info, uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode a FRAME packet from a sample ring slot
+ *
+ * A whole frame carries the slot's packed codes as they are
+ * (STREAM_FLAG_PACK12 with CONFIG_APP_FRAME_PACK12). Given @p ref, the
+ * frame is DELTA-coded if @p ref holds its predecessor and that is
+ * shorter, and @p ref then describes this frame. With
+ * CONFIG_APP_CHANNEL_TIMESTAMPS the per-channel offsets are appended
+ * (STREAM_FLAG_CH_TIME).
+ *
+ * @param slot Frame to encode
+ * @param ref  Delta state, or NULL to always send whole frames
+ * @param buf  Output buffer
+ * @param len  Size of @p buf; a whole frame must fit
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ *         (@p ref is left alone)
+ */
+int stream_encode_frame(const struct sample_ring_slot *slot, struct stream_delta_ref *ref,
+                        uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode a DROP packet
+ *
+ * @param total_dropped Frames lost since the stream started
+ * @param buf           Output buffer
+ * @param len           Size of @p buf
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ */
+int stream_encode_drop(uint32_t total_dropped, uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode an EVENT packet
+ *
+ * @param seq  Frame that triggered the event
+ * @param ch   Channel
+ * @param type Event type
+ * @param raw  Raw code that triggered the event
+ * @param buf  Output buffer
+ * @param len  Size of @p buf
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ */
+int stream_encode_event(uint32_t seq, uint8_t ch, uint8_t type, uint16_t raw,
+                        uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode a CAPTURE_INFO packet
+ *
+ * @param info Capture description
+ * @param buf  Output buffer
+ * @param len  Size of @p buf
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ */
+int stream_encode_capture_info(const struct stream_capture_info *info, uint8_t *buf,
+                               size_t len);
+
+/**
+ * @brief Encode a CAPTURE_DATA packet
+ *
+ * @param index First sample's index in the capture
+ * @param raw   Raw codes
+ * @param count Number of codes, 1 to STREAM_CAPTURE_CHUNK
+ * @param buf   Output buffer
+ * @param len   Size of @p buf
+ * @return Packet length in bytes, -EINVAL for a bad @p count, or
+ *         -ENOMEM if @p buf is too small
+ */
+int stream_encode_capture_data(uint32_t index, const uint16_t *raw, size_t count,
+                               uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode a STATS packet
+ *
+ * @param snap Window aggregates of all channels
+ * @param buf  Output buffer
+ * @param len  Size of @p buf
+ * @return Packet length in bytes, or -ENOMEM if @p buf is too small
+ */
+int stream_encode_stats(const struct chan_stats_snapshot *snap, uint8_t *buf, size_t len);
+
+#endif /* STREAM_PROTO_H_ */
@@ -0,0 +1,185 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-Board Sync Implementation
+ *
+ * The edge interrupt stamps the frame clock, feeds the time model and
+ * re-phases the sampling scheduler. Readers copy the model under a
+ * spinlock; the conversion itself runs outside it.
+ */
+
+#include "sync.h"
+#include "regs.h"
+#include "sample_sched.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sync, LOG_LEVEL_INF);
+
+#define ZEPHYR_USER_NODE DT_PATH(zephyr_user)
+
+static const struct gpio_dt_spec sync_in = GPIO_DT_SPEC_GET(ZEPHYR_USER_NODE, sync_gpios);
+static struct gpio_callback sync_in_cb;
+
+static struct sync_model sync_state;
+static struct k_spinlock sync_lock;
+
+#if defined(CONFIG_APP_SYNC_OUTPUT)
+static const struct gpio_dt_spec sync_out = GPIO_DT_SPEC_GET(ZEPHYR_USER_NODE, sync_out_gpios);
+static bool sync_out_enabled;
+
+static void sync_out_toggle(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+    (void)gpio_pin_toggle_dt(&sync_out);
+}
+
+/* Toggles every half period: one rising edge per period */
+static K_TIMER_DEFINE(sync_out_timer, sync_out_toggle, NULL);
+#endif
+
+static void sync_edge_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+    uint64_t now = regs_clock_ns();
+    k_spinlock_key_t key;
+    enum sync_edge kind;
+    int32_t rate_ppb;
+    uint32_t trains;
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(cb);
+    ARG_UNUSED(pins);
+
+    key = k_spin_lock(&sync_lock);
+    kind = sync_model_edge(&sync_state, now);
+    rate_ppb = sync_state.rate_ppb;
+    trains = sync_state.trains;
+    k_spin_unlock(&sync_lock, key);
+
+    if (kind == SYNC_EDGE_IGNORED) {
+        return;
+    }
+
+    /* A new train's first edge is common time 0, a tick on every board */
+    sample_sched_sync(now, rate_ppb);
+
+    if (kind == SYNC_EDGE_NEW_TRAIN) {
+        LOG_INF("Sync train %u started", trains);
+    }
+}
+
+uint64_t sync_time_ns(uint64_t local_ns, bool *locked)
+{
+    struct sync_model m;
+    k_spinlock_key_t key;
+
+    key = k_spin_lock(&sync_lock);
+    m = sync_state;
+    k_spin_unlock(&sync_lock, key);
+
+    return sync_model_time(&m, local_ns, locked);
+}
+
+void sync_get_status(struct sync_status *st)
+{
+    struct sync_model m;
+    k_spinlock_key_t key;
+
+    key = k_spin_lock(&sync_lock);
+    m = sync_state;
+    k_spin_unlock(&sync_lock, key);
+
+    (void)sync_model_time(&m, regs_clock_ns(), &st->locked);
+    st->period_ms = CONFIG_APP_SYNC_PERIOD_MS;
+    st->edge = m.edge;
+    st->missed = m.missed;
+    st->trains = m.trains;
+    st->last_edge_ns = m.last_edge_ns;
+    st->rate_ppb = m.rate_ppb;
+    st->phase_err_ns = m.phase_err_ns;
+#if defined(CONFIG_APP_SYNC_OUTPUT)
+    st->output = sync_out_enabled;
+#else
+    st->output = false;
+#endif
+}
+
+int sync_output_enable(bool enable)
+{
+#if defined(CONFIG_APP_SYNC_OUTPUT)
+    k_timeout_t half = K_USEC(CONFIG_APP_SYNC_PERIOD_MS * (USEC_PER_MSEC / 2));
+
+    if (enable == sync_out_enabled) {
+        return 0;
+    }
+
+    if (enable) {
+        /* First rising edge half a period from now */
+        (void)gpio_pin_set_dt(&sync_out, 0);
+        k_timer_start(&sync_out_timer, half, half);
+    } else {
+        k_timer_stop(&sync_out_timer);
+        (void)gpio_pin_set_dt(&sync_out, 0);
+    }
+    sync_out_enabled = enable;
+
+    return 0;
+#else
+    ARG_UNUSED(enable);
+    return -ENOTSUP;
+#endif
+}
+
+int sync_init(void)
+{
+    int ret;
+
+    sync_model_init(&sync_state, CONFIG_APP_SYNC_PERIOD_MS);
+
+    if (!gpio_is_ready_dt(&sync_in)) {
+        LOG_ERR("Sync input not ready");
+        return -ENODEV;
+    }
+
+    ret = gpio_pin_configure_dt(&sync_in, GPIO_INPUT);
+    if (ret < 0) {
+        LOG_ERR("Failed to configure sync input: %d", ret);
+        return ret;
+    }
+
+    gpio_init_callback(&sync_in_cb, sync_edge_isr, BIT(sync_in.pin));
+    ret = gpio_add_callback_dt(&sync_in, &sync_in_cb);
+    if (ret < 0) {
+        LOG_ERR("Failed to add sync callback: %d", ret);
+        return ret;
+    }
+
+    ret = gpio_pin_interrupt_configure_dt(&sync_in, GPIO_INT_EDGE_TO_ACTIVE);
+    if (ret < 0) {
+        LOG_ERR("Failed to enable sync interrupt: %d", ret);
+        return ret;
+    }
+
+#if defined(CONFIG_APP_SYNC_OUTPUT)
+    if (!gpio_is_ready_dt(&sync_out)) {
+        LOG_ERR("Sync output not ready");
+        return -ENODEV;
+    }
+
+    ret = gpio_pin_configure_dt(&sync_out, GPIO_OUTPUT_INACTIVE);
+    if (ret < 0) {
+        LOG_ERR("Failed to configure sync output: %d", ret);
+        return ret;
+    }
+
+    (void)sync_output_enable(true);
+#endif
+
+    LOG_INF("Sync input ready (period %u ms%s)", CONFIG_APP_SYNC_PERIOD_MS,
+            IS_ENABLED(CONFIG_APP_SYNC_OUTPUT) ? ", driving pulses" : "");
+
+    return 0;
+}
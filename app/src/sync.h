@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-Board Sync - Common timebase from a shared trigger line
+ *
+ * Every board timestamps the rising edges of one shared sync pulse
+ * train (devicetree 'sync-gpios' on /zephyr,user) with the frame clock.
+ * One board, the master, may also drive the train ('sync-out-gpios',
+ * CONFIG_APP_SYNC_OUTPUT), wired to its own input like everyone else's.
+ *
+ * Edge n of a train is common time n * CONFIG_APP_SYNC_PERIOD_MS, so
+ * boards agree on the time without exchanging messages. Between edges
+ * the local clock is scaled by its rate error measured over the last
+ * edges. Each edge also re-phases the sampling scheduler
+ * (sample_sched_sync()), so frame ticks fall on common-time multiples of
+ * the frame period on every board.
+ *
+ * A gap of more than 1.5 sync periods unlocks the timebase. An edge that
+ * ends a gap of up to CONFIG_APP_SYNC_MAX_MISSED_EDGES missed edges, and
+ * still lands on the train's period grid, continues the train at its
+ * index; any other edge starts a new train at common time 0.
+ *
+ * Common time counts from the first edge this board saw. A board that
+ * joins a running train (boots or connects late) or misses more edges
+ * than the bound therefore runs whole sync periods apart from the
+ * others, and nothing on the line tells it so; the host has to align
+ * such streams, or the master restarts the train ('adcsync stop', pause,
+ * 'adcsync start') once every board is listening.
+ */
+
+#ifndef SYNC_H_
+#define SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Sync state, for the shell
+ */
+struct sync_status {
+    bool locked;            /* Common time is valid */
+    bool output;            /* This board drives the pulse train */
+    uint32_t period_ms;     /* Nominal edge spacing */
+    uint32_t edge;          /* Index of the last edge in the current train */
+    uint32_t missed;        /* Edges missed in the current train */
+    uint32_t trains;        /* Trains started since boot */
+    uint64_t last_edge_ns;  /* Frame clock at the last edge */
+    int32_t rate_ppb;       /* Local clock rate error, + when fast */
+    int32_t phase_err_ns;   /* Model error at the last edge, + when late */
+};
+
+/** @brief What sync_model_edge() made of an edge */
+enum sync_edge {
+    SYNC_EDGE_IGNORED,    /* Less than half a period after the last edge */
+    SYNC_EDGE_TRACKED,    /* Next edge of the current train, maybe after missed ones */
+    SYNC_EDGE_NEW_TRAIN,  /* First edge, or the first after a gap or a phase jump */
+};
+
+/**
+ * @brief Edge-to-edge model of one pulse train
+ *
+ * Exposed for unit tests; the driver keeps one instance.
+ */
+struct sync_model {
+    uint64_t period_ns;     /* Nominal edge spacing */
+    uint64_t last_edge_ns;  /* Local time of the last edge */
+    uint32_t edge;          /* Index of the last edge in the train */
+    uint32_t missed;        /* Edges missed in the train */
+    uint32_t trains;        /* Trains started */
+    int32_t rate_ppb;       /* Smoothed local rate error */
+    int32_t phase_err_ns;   /* Prediction error at the last edge */
+    bool started;           /* At least one edge seen */
+    bool rate_valid;        /* At least one interval measured */
+};
+
+/**
+ * @brief Reset a model to no edges seen
+ *
+ * @param m         Model
+ * @param period_ms Nominal edge spacing in milliseconds
+ */
+void sync_model_init(struct sync_model *m, uint32_t period_ms);
+
+/**
+ * @brief Feed one edge to a model
+ *
+ * @param m       Model
+ * @param edge_ns Local time of the edge
+ * @return How the edge was used
+ */
+enum sync_edge sync_model_edge(struct sync_model *m, uint64_t edge_ns);
+
+/**
+ * @brief Convert a local time to common time with a model
+ *
+ * @param m        Model
+ * @param local_ns Local time, may be slightly before the last edge
+ * @param locked   Receives whether the result is common time; if false
+ *                 the result is @p local_ns unchanged
+ * @return Common time in nanoseconds since the train's first edge
+ */
+uint64_t sync_model_time(const struct sync_model *m, uint64_t local_ns, bool *locked);
+
+#if defined(CONFIG_APP_SYNC)
+
+/**
+ * @brief Configure the sync input (and output) and start listening
+ *
+ * @return 0 on success, negative errno on failure
+ */
+int sync_init(void);
+
+/**
+ * @brief Convert a frame clock reading to the common timebase
+ *
+ * ISR-safe.
+ *
+ * @param local_ns Frame clock reading (regs_clock_ns())
+ * @param locked   Receives whether the result is common time
+ * @return Common time while locked, @p local_ns otherwise
+ */
+uint64_t sync_time_ns(uint64_t local_ns, bool *locked);
+
+/**
+ * @brief Get the sync state
+ *
+ * @param st Receives the state
+ */
+void sync_get_status(struct sync_status *st);
+
+/**
+ * @brief Start or stop driving the pulse train
+ *
+ * Stopping for more than CONFIG_APP_SYNC_MAX_MISSED_EDGES + 1.5 periods
+ * makes every board start a new train, at common time 0, on the next
+ * edge; a shorter stop usually does too, as the restart is off the old
+ * train's grid.
+ *
+ * @param enable true to drive pulses
+ * @return 0 on success, -ENOTSUP without CONFIG_APP_SYNC_OUTPUT
+ */
+int sync_output_enable(bool enable);
+
+#else
+
+static inline int sync_init(void)
+{
+    return 0;
+}
+
+static inline uint64_t sync_time_ns(uint64_t local_ns, bool *locked)
+{
+    *locked = false;
+    return local_ns;
+}
+
+#endif /* CONFIG_APP_SYNC */
+
+#endif /* SYNC_H_ */
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-Board Sync - Pulse train time model
+ *
+ * Pure arithmetic on local edge times, kept apart from the GPIO driver so
+ * it can be unit tested. Rates are in parts per billion and bounded by
+ * the half-period edge window, so with periods up to 10 s every product
+ * below fits 64 bits. Intervals spanning missed edges are divided by
+ * their period count before they are scaled.
+ */
+
+#include "sync.h"
+#include <stdlib.h>
+
+/* Weight of the newest interval in the rate estimate, 1/N */
+#define SYNC_RATE_SMOOTHING 4
+
+#define PPB 1000000000LL
+
+void sync_model_init(struct sync_model *m, uint32_t period_ms)
+{
+    *m = (struct sync_model){
+        .period_ns = (uint64_t)period_ms * 1000000ULL,
+    };
+}
+
+/* Past this gap without an edge the timebase is no longer trusted */
+static uint64_t holdover_ns(const struct sync_model *m)
+{
+    return m->period_ns + m->period_ns / 2;
+}
+
+static enum sync_edge new_train(struct sync_model *m, uint64_t edge_ns)
+{
+    m->started = true;
+    m->rate_valid = false;
+    m->edge = 0;
+    m->missed = 0;
+    m->trains++;
+    m->rate_ppb = 0;
+    m->phase_err_ns = 0;
+    m->last_edge_ns = edge_ns;
+    return SYNC_EDGE_NEW_TRAIN;
+}
+
+enum sync_edge sync_model_edge(struct sync_model *m, uint64_t edge_ns)
+{
+    uint64_t interval;
+    uint64_t periods;
+    int64_t expected;
+    int64_t residual;
+    int64_t meas_ppb;
+
+    interval = edge_ns - m->last_edge_ns;
+    if (!m->started || edge_ns < m->last_edge_ns) {
+        return new_train(m, edge_ns);
+    }
+
+    /* Bounce or a stray pulse; real edges are a period apart */
+    if (interval < m->period_ns / 2) {
+        return SYNC_EDGE_IGNORED;
+    }
+
+    /* Whole periods since the last edge; more than one if edges were missed */
+    expected = (int64_t)m->period_ns + (int64_t)m->period_ns * m->rate_ppb / PPB;
+    periods = (interval + (uint64_t)expected / 2) / (uint64_t)expected;
+    residual = (int64_t)interval - (int64_t)periods * expected;
+
+    /*
+     * After missed edges the train only continues if this edge is still
+     * on its grid; a restarted train has an arbitrary phase.
+     */
+    if (periods > 1 + CONFIG_APP_SYNC_MAX_MISSED_EDGES ||
+        (periods > 1 && llabs(residual) > (int64_t)m->period_ns / 4)) {
+        return new_train(m, edge_ns);
+    }
+
+    m->phase_err_ns = (int32_t)residual;
+
+    meas_ppb = ((int64_t)interval - (int64_t)(periods * m->period_ns)) / (int64_t)periods *
+               PPB / (int64_t)m->period_ns;
+    if (m->rate_valid) {
+        m->rate_ppb += (int32_t)((meas_ppb - m->rate_ppb) / SYNC_RATE_SMOOTHING);
+    } else {
+        m->rate_ppb = (int32_t)meas_ppb;
+        m->rate_valid = true;
+    }
+
+    m->edge += (uint32_t)periods;
+    m->missed += (uint32_t)(periods - 1);
+    m->last_edge_ns = edge_ns;
+    return SYNC_EDGE_TRACKED;
+}
+
+uint64_t sync_model_time(const struct sync_model *m, uint64_t local_ns, bool *locked)
+{
+    int64_t delta = (int64_t)(local_ns - m->last_edge_ns);
+    int64_t common;
+
+    if (!m->rate_valid || delta > (int64_t)holdover_ns(m)) {
+        *locked = false;
+        return local_ns;
+    }
+
+    /* Local nanoseconds run (1 + rate) times as fast as common ones */
+    common = (int64_t)(m->edge * m->period_ns) + delta -
+             delta * m->rate_ppb / (PPB + m->rate_ppb);
+    *locked = true;
+
+    return (common > 0) ? (uint64_t)common : 0;
+}
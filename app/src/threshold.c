@@ -0,0 +1,341 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Threshold Rules Implementation
+ *
+ * The rule table is written by the shell and read by the sampling
+ * thread, so both sides take a spinlock; evaluation holds it only while
+ * walking NUM_CH channels. Events found during a frame are collected on
+ * the stack and queued after the lock is released.
+ *
+ * With hardware monitors, the window is converted to raw codes so the
+ * hardware trips exactly when the software rule could fire: high_raw is
+ * the largest code at or below high_mv and low_raw the smallest code at
+ * or above low_mv, under the same regs_raw_to_mv() rounding.
+ */
+
+#include "threshold.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(threshold, LOG_LEVEL_INF);
+
+#ifdef CONFIG_APP_THRESHOLD_QUEUE_DEPTH
+#define THRESHOLD_QUEUE_DEPTH CONFIG_APP_THRESHOLD_QUEUE_DEPTH
+#else
+#define THRESHOLD_QUEUE_DEPTH 16
+#endif
+
+#define THRESHOLD_FLAGS_ALL (THRESHOLD_HIGH | THRESHOLD_LOW | THRESHOLD_CHANGE)
+
+enum channel_state {
+    STATE_NORMAL,
+    STATE_HIGH,
+    STATE_LOW,
+};
+
+struct channel_rule {
+    struct threshold_rule rule;
+    enum channel_state state;
+    bool primed;         /* last_mv holds a reference value */
+    int32_t last_mv;     /* Value at the last CHANGE event */
+};
+
+static struct channel_rule rules[NUM_CH];
+static struct k_spinlock rules_lock;
+static uint32_t alarm_mask;
+
+static const struct threshold_hw *hw_ops;
+static atomic_t hw_covered;
+
+static K_EVENT_DEFINE(alarm_event);
+static K_MSGQ_DEFINE(threshold_msgq, sizeof(struct threshold_event), THRESHOLD_QUEUE_DEPTH, 4);
+static atomic_t events_dropped;
+
+void threshold_init(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&rules_lock);
+
+    memset(rules, 0, sizeof(rules));
+    alarm_mask = 0;
+    k_spin_unlock(&rules_lock, key);
+
+    k_event_clear(&alarm_event, UINT32_MAX);
+    k_msgq_purge(&threshold_msgq);
+    atomic_set(&events_dropped, 0);
+
+    if (hw_ops != NULL) {
+        for (unsigned int ch = 0; ch < NUM_CH; ch++) {
+            (void)hw_ops->set_window(ch, false, 0, 0);
+        }
+    }
+    atomic_set(&hw_covered, 0);
+}
+
+void threshold_set_hw(const struct threshold_hw *hw)
+{
+    hw_ops = hw;
+}
+
+uint32_t threshold_hw_covered(void)
+{
+    return (uint32_t)atomic_get(&hw_covered);
+}
+
+/* Largest code whose value is at most mv, -1 if there is none */
+static int32_t raw_at_most(unsigned int ch, int32_t mv, uint32_t full_scale)
+{
+    uint32_t lo = 0, hi = full_scale;
+
+    if (regs_raw_to_mv(ch, 0) > mv) {
+        return -1;
+    }
+
+    /* regs_raw_to_mv() is monotonic in the code */
+    while (lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+
+        if (regs_raw_to_mv(ch, mid) <= mv) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return (int32_t)lo;
+}
+
+/* Mirror a rule's high/low window into hardware, if there is any */
+static void hw_arm(unsigned int ch, const struct threshold_rule *r)
+{
+    uint32_t full_scale;
+    int32_t low_raw = 0, high_raw;
+    uint16_t ref_mv;
+    uint8_t resolution;
+    bool covered = false;
+
+    if (hw_ops == NULL) {
+        return;
+    }
+
+    regs_get_scale(ch, &ref_mv, &resolution);
+    full_scale = BIT(resolution) - 1;
+    high_raw = full_scale;
+
+    if (r->flags & THRESHOLD_HIGH) {
+        high_raw = raw_at_most(ch, r->high_mv, full_scale);
+    }
+    if (r->flags & THRESHOLD_LOW) {
+        low_raw = raw_at_most(ch, r->low_mv - 1, full_scale) + 1;
+    }
+
+    /* A window the hardware could never be inside stays in software */
+    if ((r->flags & (THRESHOLD_HIGH | THRESHOLD_LOW)) && high_raw >= 0 &&
+        low_raw <= (int32_t)full_scale && low_raw <= high_raw) {
+        covered = hw_ops->set_window(ch, true, low_raw, high_raw) == 0;
+    }
+    if (!covered) {
+        (void)hw_ops->set_window(ch, false, 0, 0);
+    }
+
+    if (covered) {
+        atomic_set_bit(&hw_covered, ch);
+    } else {
+        atomic_clear_bit(&hw_covered, ch);
+    }
+}
+
+int threshold_set_rule(unsigned int ch, const struct threshold_rule *rule)
+{
+    k_spinlock_key_t key;
+
+    if (ch >= NUM_CH || (rule->flags & ~THRESHOLD_FLAGS_ALL) ||
+        rule->hysteresis_mv < 0 || rule->deadband_mv < 0) {
+        return -EINVAL;
+    }
+    if ((rule->flags & THRESHOLD_HIGH) && (rule->flags & THRESHOLD_LOW) &&
+        rule->low_mv >= rule->high_mv) {
+        return -EINVAL;
+    }
+    if ((rule->flags & THRESHOLD_CHANGE) && rule->deadband_mv == 0) {
+        return -EINVAL;
+    }
+
+    key = k_spin_lock(&rules_lock);
+    rules[ch].rule = *rule;
+    rules[ch].state = STATE_NORMAL;
+    rules[ch].primed = false;
+    alarm_mask &= ~BIT(ch);
+    k_spin_unlock(&rules_lock, key);
+
+    k_event_clear(&alarm_event, BIT(ch));
+    hw_arm(ch, rule);
+
+    return 0;
+}
+
+void threshold_rescale(void)
+{
+    for (unsigned int ch = 0; ch < NUM_CH; ch++) {
+        struct threshold_rule rule;
+        k_spinlock_key_t key = k_spin_lock(&rules_lock);
+
+        rule = rules[ch].rule;
+        k_spin_unlock(&rules_lock, key);
+
+        hw_arm(ch, &rule);
+    }
+}
+
+int threshold_get_rule(unsigned int ch, struct threshold_rule *rule)
+{
+    k_spinlock_key_t key;
+
+    if (ch >= NUM_CH) {
+        return -EINVAL;
+    }
+
+    key = k_spin_lock(&rules_lock);
+    *rule = rules[ch].rule;
+    k_spin_unlock(&rules_lock, key);
+
+    return 0;
+}
+
+/* Advance one channel's alarm state; returns the events it produced */
+static size_t channel_evaluate(struct channel_rule *c, int32_t mv, uint8_t types[3])
+{
+    const struct threshold_rule *r = &c->rule;
+    size_t n = 0;
+
+    if (c->state == STATE_HIGH && mv < r->high_mv - r->hysteresis_mv) {
+        c->state = STATE_NORMAL;
+        types[n++] = THRESHOLD_EV_CLEAR;
+    } else if (c->state == STATE_LOW && mv > r->low_mv + r->hysteresis_mv) {
+        c->state = STATE_NORMAL;
+        types[n++] = THRESHOLD_EV_CLEAR;
+    }
+
+    /* A jump straight across the band clears and re-arms in one frame */
+    if (c->state == STATE_NORMAL) {
+        if ((r->flags & THRESHOLD_HIGH) && mv > r->high_mv) {
+            c->state = STATE_HIGH;
+            types[n++] = THRESHOLD_EV_HIGH;
+        } else if ((r->flags & THRESHOLD_LOW) && mv < r->low_mv) {
+            c->state = STATE_LOW;
+            types[n++] = THRESHOLD_EV_LOW;
+        }
+    }
+
+    return n;
+}
+
+void threshold_evaluate(const struct adc_regs *frame)
+{
+    /* At most a transition pair plus a CHANGE per channel */
+    struct threshold_event events[NUM_CH * 3];
+    size_t num_events = 0;
+    uint32_t prev_mask, new_mask;
+    uint32_t quiet = 0;
+    k_spinlock_key_t key;
+
+    if (hw_ops != NULL) {
+        quiet = hw_ops->quiet() & (uint32_t)atomic_get(&hw_covered);
+    }
+
+    key = k_spin_lock(&rules_lock);
+
+    prev_mask = alarm_mask;
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        struct channel_rule *c = &rules[ch];
+        uint8_t types[3];
+        size_t n = 0;
+        int32_t mv;
+
+        if (c->rule.flags == 0) {
+            continue;
+        }
+
+        /* Hardware saw nothing outside the window: no transition possible */
+        bool hw_quiet = (quiet & BIT(ch)) && c->state == STATE_NORMAL;
+
+        if (hw_quiet && !(c->rule.flags & THRESHOLD_CHANGE)) {
+            continue;
+        }
+
+        mv = regs_raw_to_mv(ch, frame->raw[ch]);
+        if (!hw_quiet) {
+            n = channel_evaluate(c, mv, types);
+        }
+
+        if (c->rule.flags & THRESHOLD_CHANGE) {
+            if (!c->primed) {
+                c->last_mv = mv;
+                c->primed = true;
+            } else if (abs(mv - c->last_mv) >= c->rule.deadband_mv) {
+                c->last_mv = mv;
+                types[n++] = THRESHOLD_EV_CHANGE;
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            events[num_events++] = (struct threshold_event){
+                .seq = frame->seq,
+                .ch = ch,
+                .type = types[i],
+                .raw = frame->raw[ch],
+            };
+        }
+
+        WRITE_BIT(alarm_mask, ch, c->state != STATE_NORMAL);
+    }
+
+    new_mask = alarm_mask;
+    k_spin_unlock(&rules_lock, key);
+
+    if (new_mask != prev_mask) {
+        k_event_set(&alarm_event, new_mask);
+    }
+
+    for (size_t i = 0; i < num_events; i++) {
+        if (events[i].type != THRESHOLD_EV_CHANGE) {
+            LOG_INF("ch[%u] %s (raw %u, seq %u)", events[i].ch,
+                    events[i].type == THRESHOLD_EV_HIGH ? "HIGH" :
+                    events[i].type == THRESHOLD_EV_LOW ? "LOW" : "clear",
+                    events[i].raw, events[i].seq);
+        }
+        if (k_msgq_put(&threshold_msgq, &events[i], K_NO_WAIT) != 0) {
+            atomic_inc(&events_dropped);
+        }
+    }
+}
+
+uint32_t threshold_alarms(void)
+{
+    return k_event_test(&alarm_event, UINT32_MAX);
+}
+
+uint32_t threshold_wait(uint32_t mask, k_timeout_t timeout)
+{
+    return k_event_wait(&alarm_event, mask, false, timeout);
+}
+
+int threshold_get_event(struct threshold_event *ev, k_timeout_t timeout)
+{
+    return k_msgq_get(&threshold_msgq, ev, timeout) == 0 ? 0 : -EAGAIN;
+}
+
+void threshold_flush_events(void)
+{
+    k_msgq_purge(&threshold_msgq);
+}
+
+uint32_t threshold_events_dropped(void)
+{
+    return (uint32_t)atomic_get(&events_dropped);
+}
@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Threshold Rules - Per-channel alarms and change notifications
+ *
+ * Rules are evaluated by the sampling thread right after regs_update(),
+ * so an excursion is reported within one frame. Two ways to consume:
+ *
+ * - Alarm level: threshold_wait() blocks on a k_event whose bit n is
+ *   set while channel n is above its high or below its low threshold.
+ *   Any number of threads can wait; nothing is consumed.
+ * - Event records: every transition (HIGH, LOW, CLEAR) and deadband
+ *   CHANGE is queued for threshold_get_event(). Single consumer (the
+ *   stream thread when streaming); records are dropped when full.
+ *
+ * A backend with hardware limit monitors (STM32 analog watchdogs) can
+ * register struct threshold_hw. High/low windows are then mirrored into
+ * hardware, and a channel whose monitor has not tripped is not checked
+ * in software while it is out of alarm. Without it every rule is checked
+ * in software (the SIM target).
+ */
+
+#ifndef THRESHOLD_H_
+#define THRESHOLD_H_
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include "regs.h"
+
+/* Rule flags */
+#define THRESHOLD_HIGH   BIT(0)  /* Alarm while above high_mv */
+#define THRESHOLD_LOW    BIT(1)  /* Alarm while below low_mv */
+#define THRESHOLD_CHANGE BIT(2)  /* Event on each move of deadband_mv or more */
+
+/**
+ * @brief Rule of one channel (values in millivolts)
+ *
+ * An alarm raised at high_mv clears once the value falls below
+ * high_mv - hysteresis_mv; one raised at low_mv once it rises above
+ * low_mv + hysteresis_mv.
+ */
+struct threshold_rule {
+    uint8_t flags;           /* THRESHOLD_* */
+    int32_t high_mv;
+    int32_t low_mv;
+    int32_t hysteresis_mv;
+    int32_t deadband_mv;     /* Minimum change from the last CHANGE event */
+};
+
+/**
+ * @brief Event types (also the stream EVENT packet's type byte)
+ */
+enum threshold_event_type {
+    THRESHOLD_EV_HIGH = 1,    /* Rose above high_mv */
+    THRESHOLD_EV_LOW = 2,     /* Fell below low_mv */
+    THRESHOLD_EV_CLEAR = 3,   /* Back inside the hysteresis band */
+    THRESHOLD_EV_CHANGE = 4,  /* Moved by at least deadband_mv */
+};
+
+/**
+ * @brief One queued event
+ */
+struct threshold_event {
+    uint32_t seq;   /* Frame that triggered the event */
+    uint8_t ch;
+    uint8_t type;   /* enum threshold_event_type */
+    uint16_t raw;   /* Raw code that triggered the event */
+};
+
+/**
+ * @brief Hardware limit monitor hooks, implemented by the ADC backend
+ *
+ * Windows are in raw codes; a monitor trips on any conversion below
+ * low_raw or above high_raw.
+ */
+struct threshold_hw {
+    /**
+     * Arm (enable) or disarm a channel's window. Called from the thread
+     * setting the rule. Return 0 if hardware now monitors the channel,
+     * negative errno if it cannot (the rule stays software-checked).
+     */
+    int (*set_window)(unsigned int ch, bool enable, uint16_t low_raw, uint16_t high_raw);
+    /**
+     * Channels whose monitor has not tripped since the previous call.
+     * Called by the sampling thread once per evaluated frame.
+     */
+    uint32_t (*quiet)(void);
+};
+
+/**
+ * @brief Clear all rules, alarms and queued events
+ *
+ * Keeps a registered struct threshold_hw.
+ */
+void threshold_init(void);
+
+/**
+ * @brief Register hardware limit monitors
+ *
+ * Called once by the ADC backend during init, before any rule is set.
+ *
+ * @param hw Hooks, or NULL to check every rule in software
+ */
+void threshold_set_hw(const struct threshold_hw *hw);
+
+/**
+ * @brief Get the channels whose high/low rule hardware monitors
+ *
+ * @return Channel mask, bit n for channel n
+ */
+uint32_t threshold_hw_covered(void);
+
+/**
+ * @brief Install or replace the rule of a channel
+ *
+ * Resets the channel's alarm state; the next frame is evaluated afresh.
+ *
+ * @param ch   Channel number (0 to NUM_CH-1)
+ * @param rule Rule to copy; flags == 0 disables the channel
+ * @return 0 on success, -EINVAL on a bad channel or rule
+ */
+int threshold_set_rule(unsigned int ch, const struct threshold_rule *rule);
+
+/**
+ * @brief Recompute the hardware windows after a resolution change
+ *
+ * Rules are in millivolts, so only the raw-code windows given to a
+ * registered struct threshold_hw change; alarm states are kept.
+ */
+void threshold_rescale(void);
+
+/**
+ * @brief Get the rule of a channel
+ *
+ * @param ch   Channel number (0 to NUM_CH-1)
+ * @param rule Receives a copy of the rule
+ * @return 0 on success, -EINVAL on a bad channel
+ */
+int threshold_get_rule(unsigned int ch, struct threshold_rule *rule);
+
+/**
+ * @brief Evaluate every rule against a new frame
+ *
+ * Sampling thread only.
+ *
+ * @param frame Frame just published with regs_update()
+ */
+void threshold_evaluate(const struct adc_regs *frame);
+
+/**
+ * @brief Get the channels currently in alarm
+ *
+ * @return Channel mask, bit n for channel n
+ */
+uint32_t threshold_alarms(void);
+
+/**
+ * @brief Wait until any channel in @p mask is in alarm
+ *
+ * Returns at once if one already is.
+ *
+ * @param mask    Channels of interest
+ * @param timeout How long to wait
+ * @return Channels of @p mask in alarm, 0 on timeout
+ */
+uint32_t threshold_wait(uint32_t mask, k_timeout_t timeout);
+
+/**
+ * @brief Take the oldest queued event
+ *
+ * @param ev      Receives the event
+ * @param timeout How long to wait for one
+ * @return 0 on success, -EAGAIN on timeout
+ */
+int threshold_get_event(struct threshold_event *ev, k_timeout_t timeout);
+
+/**
+ * @brief Discard queued events
+ */
+void threshold_flush_events(void);
+
+/**
+ * @brief Get the number of events dropped because the queue was full
+ *
+ * @return Total dropped since threshold_init()
+ */
+uint32_t threshold_events_dropped(void);
+
+#endif /* THRESHOLD_H_ */
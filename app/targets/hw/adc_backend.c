@@ -25,11 +25,20 @@
  */
 
 #include "../../src/adc_backend.h"
+#include "../../src/frame_pack.h"
+#include "../../src/mem_placement.h"
+#include "../../src/sampler_stats.h"
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/adc.h>
 #include <zephyr/logging/log.h>
 
+#if defined(CONFIG_APP_ADC_AWD)
+#include <stm32_ll_adc.h>
+#include <zephyr/spinlock.h>
+#include "../../src/threshold.h"
+#endif
+
 LOG_MODULE_REGISTER(adc_backend_hw, LOG_LEVEL_INF);
 
 /*
@@ -40,6 +49,9 @@ LOG_MODULE_REGISTER(adc_backend_hw, LOG_LEVEL_INF);
  * ADC3 channels: INP0, INP1, INP4, INP5, INP6, INP8, INP9 (7 channels)
  *
  * NOTE: PC2 and PC3 are PC2_C/PC3_C pins that only connect to ADC3!
+ *
+ * The mapping itself is the io-channels property of the zephyr,user node
+ * in the board overlay: element n is software channel n.
  */
 
 #define ADC_CONFIGURED 1
@@ -48,98 +60,568 @@ LOG_MODULE_REGISTER(adc_backend_hw, LOG_LEVEL_INF);
 
 #define ADC1_NODE DT_NODELABEL(adc1)
 #define ADC3_NODE DT_NODELABEL(adc3)
+#define ZEPHYR_USER_NODE DT_PATH(zephyr_user)
+
+#if !DT_NODE_HAS_PROP(ZEPHYR_USER_NODE, io_channels)
+#error "Board overlay must map the software channels in zephyr,user io-channels"
+#endif
+
+/* Software channels (bit n = channel n) and hardware channels of a converter */
+#define CH_SW_BIT_ON(node_id, prop, idx, ctlr)                                  \
+    (DT_SAME_NODE(DT_IO_CHANNELS_CTLR_BY_IDX(node_id, idx), ctlr) ? BIT(idx) : 0) |
+#define CH_HW_BIT_ON(node_id, prop, idx, ctlr)                                  \
+    (DT_SAME_NODE(DT_IO_CHANNELS_CTLR_BY_IDX(node_id, idx), ctlr) ?             \
+         BIT(DT_IO_CHANNELS_INPUT_BY_IDX(node_id, idx)) : 0) |
+#define ADC_SW_CHANNELS(ctlr)                                                   \
+    (DT_FOREACH_PROP_ELEM_VARGS(ZEPHYR_USER_NODE, io_channels, CH_SW_BIT_ON, ctlr) 0)
+#define ADC_HW_CHANNELS(ctlr)                                                   \
+    (DT_FOREACH_PROP_ELEM_VARGS(ZEPHYR_USER_NODE, io_channels, CH_HW_BIT_ON, ctlr) 0)
+
+#define ADC1_CHANNELS ADC_SW_CHANNELS(ADC1_NODE)
+#define ADC3_CHANNELS ADC_SW_CHANNELS(ADC3_NODE)
+
+BUILD_ASSERT(DT_PROP_LEN(ZEPHYR_USER_NODE, io_channels) == NUM_CH,
+             "zephyr,user io-channels must list CONFIG_APP_NUM_CH channels");
+BUILD_ASSERT((ADC1_CHANNELS | ADC3_CHANNELS) == ADC_BACKEND_ALL_CHANNELS,
+             "every io-channels entry must be on adc1 or adc3");
+BUILD_ASSERT(__builtin_popcount(ADC_HW_CHANNELS(ADC1_NODE)) ==
+                 __builtin_popcount(ADC1_CHANNELS) &&
+             __builtin_popcount(ADC_HW_CHANNELS(ADC3_NODE)) ==
+                 __builtin_popcount(ADC3_CHANNELS),
+             "an ADC channel is listed twice in io-channels");
+
+/*
+ * Software channel (0-14) -> converter, hardware channel ID and the
+ * settings of its channel@<id> node (gain, reference, acquisition time,
+ * resolution and hardware oversampling ratio), if it has one.
+ */
+#define CHANNEL_SPEC(node_id, prop, idx) ADC_DT_SPEC_GET_BY_IDX(node_id, idx)
+
+static const struct adc_dt_spec channel_mappings[NUM_CH] = {
+    DT_FOREACH_PROP_ELEM_SEP(ZEPHYR_USER_NODE, io_channels, CHANNEL_SPEC, (,))
+};
 
-static const struct device *adc1_dev;
-static const struct device *adc3_dev;
 static struct adc_channel_cfg channel_cfgs[NUM_CH];
-static int16_t sample_buffer[NUM_CH];
+#if !defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+/* With CONFIG_ADC_STM32_DMA the driver uses DMA even for single reads */
+static uint16_t sample_buffer[NUM_CH] APP_DMA_BSS;
+#endif
+
+/* Defaults for channels without a channel@<id> devicetree node */
+#define ADC_RESOLUTION   CONFIG_APP_ADC_RESOLUTION
+#define ADC_OVERSAMPLING CONFIG_APP_ADC_OVERSAMPLING
+#define ADC_REF_MV       3300
 
-#define ADC_RESOLUTION 12
-#define ADC_REF_MV     3300
+BUILD_ASSERT(!IS_ENABLED(CONFIG_APP_FRAME_PACK12) || ADC_RESOLUTION <= FRAME_PACK12_BITS,
+             "CONFIG_APP_FRAME_PACK12 would clamp CONFIG_APP_ADC_RESOLUTION codes");
 
-/* Map software channel (0-14) to ADC peripheral and hardware channel ID */
-struct channel_map {
-    const struct device **dev;  /* Pointer to ADC device */
-    uint8_t channel_id;          /* Hardware ADC channel ID */
+/* Effective per-channel sequence settings, filled in at init */
+static uint8_t channel_resolution[NUM_CH];
+static uint8_t channel_oversampling[NUM_CH];
+
+/* Build-time settings, restored by ADC_BACKEND_DEFAULT */
+static uint8_t default_resolution[NUM_CH];
+static uint8_t default_oversampling[NUM_CH];
+
+/* Resolutions (bit n = n bits) and oversampling limits per converter */
+#define ADC1_RESOLUTIONS   (BIT(8) | BIT(10) | BIT(12) | BIT(14) | BIT(16))
+#define ADC3_RESOLUTIONS   (BIT(6) | BIT(8) | BIT(10) | BIT(12))
+#define ADC1_MAX_OVERSAMPLING 10
+#define ADC3_MAX_OVERSAMPLING 8
+
+#if defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+/*
+ * Scan mode: each converter runs all of its channels as one regular
+ * sequence and DMA moves the results into that converter's buffer.
+ * The STM32 driver ranks the sequence in ascending channel-ID order,
+ * so slot_to_ch[] maps each buffer slot back to a software channel.
+ * Frames that skip a rate group scan only the due channels; active_to_ch[]
+ * is the same mapping for that reduced sequence.
+ */
+struct scan_group {
+    const struct device *dev;      /* ADC device */
+    uint32_t channels;             /* Software channels on this converter */
+    uint16_t *buffer;              /* DMA target, one slot per channel */
+    uint8_t num_slots;             /* Channels in this converter's scan */
+    uint8_t slot_to_ch[NUM_CH];    /* Buffer slot -> software channel */
+    uint32_t prepared_mask;        /* Software channels of the current sequence */
+    uint8_t num_active;            /* Slots in the current sequence */
+    uint8_t active_to_ch[NUM_CH];  /* Current buffer slot -> software channel */
+    struct adc_sequence sequence;
 };
 
-static struct channel_map channel_mappings[NUM_CH] = {
-    /* C0: PA3 -> ADC1_INP15 */
-    { &adc1_dev, 15 },
-    /* C1: PC0 -> ADC1_INP10 */
-    { &adc1_dev, 10 },
-    /* C2: PC3 -> ADC3_INP1 (PC3_C is ADC3 only!) */
-    { &adc3_dev, 1 },
-    /* C3: PB1 -> ADC1_INP5 */
-    { &adc1_dev, 5 },
-    /* C4: PC2 -> ADC3_INP0 (PC2_C is ADC3 only!) */
-    { &adc3_dev, 0 },
-    /* C5: PF10 -> ADC3_INP6 */
-    { &adc3_dev, 6 },
-    /* C6: PA5 -> ADC1_INP19 */
-    { &adc1_dev, 19 },
-    /* C7: PA6 -> ADC1_INP3 */
-    { &adc1_dev, 3 },
-    /* C8: PA4 -> ADC1_INP18 */
-    { &adc1_dev, 18 },
-    /* C9: PF3 -> ADC3_INP5 */
-    { &adc3_dev, 5 },
-    /* C10: PF4 -> ADC3_INP9 */
-    { &adc3_dev, 9 },
-    /* C11: PF5 -> ADC3_INP4 */
-    { &adc3_dev, 4 },
-    /* C12: PF6 -> ADC3_INP8 */
-    { &adc3_dev, 8 },
-    /* C13: PA0 -> ADC1_INP16 */
-    { &adc1_dev, 16 },
-    /* C14: PB0 -> ADC1_INP9 */
-    { &adc1_dev, 9 },
+/* The STM32H7 driver rejects DMA buffers in cacheable memory */
+static uint16_t adc1_scan_buffer[NUM_CH] APP_DMA_BSS;
+static uint16_t adc3_scan_buffer[NUM_CH] APP_DMA_BSS;
+
+static struct scan_group scan_groups[] = {
+    { .dev = DEVICE_DT_GET(ADC1_NODE), .channels = ADC1_CHANNELS, .buffer = adc1_scan_buffer },
+    { .dev = DEVICE_DT_GET(ADC3_NODE), .channels = ADC3_CHANNELS, .buffer = adc3_scan_buffer },
 };
 
+#if defined(CONFIG_APP_ADC_PARALLEL)
+/* Completion signal per converter for adc_read_async() */
+static struct k_poll_signal scan_signals[ARRAY_SIZE(scan_groups)];
+static struct k_poll_event scan_events[ARRAY_SIZE(scan_groups)];
+
+/* Scan that timed out but is still converting into its group's buffer */
+static bool scan_pending[ARRAY_SIZE(scan_groups)];
+
+/* Upper bound on one scan; far above the longest sequence at any setting */
+#define SCAN_TIMEOUT K_MSEC(100)
+#endif
+#endif /* CONFIG_APP_ADC_MODE_SCAN_DMA */
+
 #endif /* ADC_CONFIGURED */
 
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+/**
+ * @brief Restrict a scan group's sequence to the channels due this frame
+ *
+ * The sequence is only rebuilt when the due set changes, so frames with
+ * a constant channel set cost nothing here.
+ *
+ * @param grp     Scan group
+ * @param ch_mask Software channels to sample
+ * @return Number of slots in the resulting sequence (0: skip the group)
+ */
+static uint8_t scan_group_prepare(struct scan_group *grp, uint32_t ch_mask)
+{
+    if (ch_mask == grp->prepared_mask) {
+        return grp->num_active;
+    }
+
+    grp->num_active = 0;
+    grp->sequence.channels = 0;
+
+    for (uint8_t slot = 0; slot < grp->num_slots; slot++) {
+        int ch = grp->slot_to_ch[slot];
+
+        if (ch_mask & BIT(ch)) {
+            grp->active_to_ch[grp->num_active++] = ch;
+            grp->sequence.channels |= BIT(channel_mappings[ch].channel_id);
+        }
+    }
+
+    grp->sequence.buffer_size = grp->num_active * sizeof(grp->buffer[0]);
+    grp->prepared_mask = ch_mask;
+
+    return grp->num_active;
+}
+
+/**
+ * @brief Build the per-converter scan sequences from channel_mappings[]
+ *
+ * Duplicate channels are rejected at build time, so this cannot fail.
+ *
+ * @return 0
+ */
+static int scan_groups_init(void)
+{
+    for (size_t g = 0; g < ARRAY_SIZE(scan_groups); g++) {
+        struct scan_group *grp = &scan_groups[g];
+        uint32_t mask = 0;
+
+        for (int i = 0; i < NUM_CH; i++) {
+            if (grp->channels & BIT(i)) {
+                mask |= BIT(channel_mappings[i].channel_id);
+            }
+        }
+
+        /* Walk channel IDs in rank order and record the owner of each slot */
+        grp->num_slots = 0;
+        for (uint8_t id = 0; id < 32; id++) {
+            if (!(mask & BIT(id))) {
+                continue;
+            }
+            for (int i = 0; i < NUM_CH; i++) {
+                if ((grp->channels & BIT(i)) && channel_mappings[i].channel_id == id) {
+                    grp->slot_to_ch[grp->num_slots++] = i;
+                    break;
+                }
+            }
+        }
+
+        if (grp->num_slots == 0) {
+            continue;
+        }
+
+        /* Resolution and oversampling are per sequence, i.e. per converter */
+        int first = grp->slot_to_ch[0];
+
+        for (uint8_t slot = 1; slot < grp->num_slots; slot++) {
+            int ch = grp->slot_to_ch[slot];
+
+            if (channel_resolution[ch] != channel_resolution[first] ||
+                channel_oversampling[ch] != channel_oversampling[first]) {
+                LOG_WRN("Channel %d: resolution/oversampling differs from channel %d; "
+                        "scan uses channel %d's", ch, first, first);
+                channel_resolution[ch] = channel_resolution[first];
+                channel_oversampling[ch] = channel_oversampling[first];
+                regs_set_scale(ch, ADC_REF_MV, channel_resolution[ch]);
+            }
+        }
+
+        grp->sequence = (struct adc_sequence){
+            .buffer = grp->buffer,
+            .resolution = channel_resolution[first],
+            .oversampling = channel_oversampling[first],
+        };
+        grp->prepared_mask = 0;
+        scan_group_prepare(grp, ADC_BACKEND_ALL_CHANNELS);
+
+        LOG_INF("Scan group %u: %u channels, mask 0x%08x", (unsigned int)g,
+                grp->num_slots, mask);
+
+#if defined(CONFIG_APP_ADC_PARALLEL)
+        /* A rebuild must not clear the signal a timed-out scan will raise */
+        if (!scan_pending[g]) {
+            k_poll_signal_init(&scan_signals[g]);
+            k_poll_event_init(&scan_events[g], K_POLL_TYPE_SIGNAL,
+                              K_POLL_MODE_NOTIFY_ONLY, &scan_signals[g]);
+        }
+#endif
+    }
+
+    return 0;
+}
+#endif
+
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_AWD)
+/*
+ * Analog watchdogs 2 and 3 of each converter compare every conversion of
+ * a set of channels against one window and latch a status flag when a
+ * result falls outside it. The Zephyr ADC driver owns the converter
+ * interrupt and does not service AWD flags, so the watchdog interrupt
+ * stays disabled and the flags are read once per frame instead; the CPU
+ * does no per-sample work. Channels with the same window share a
+ * watchdog, so each converter monitors up to two distinct windows.
+ *
+ * AWD configuration registers are only writable while the converter is
+ * idle, so rule changes are staged and applied by the sampling thread
+ * before its next conversion. A converter still busy with a timed-out
+ * scan keeps its change staged until the scan settles.
+ */
+#define AWD_PER_ADC 2
+
+/* ADC3 (12-bit) AWD2/AWD3 compare only the 8 MSBs of the result */
+#define ADC3_AWD23_BITS 8
+
+struct awd_unit {
+    uint32_t channels;   /* Software channels monitored */
+    uint16_t low_raw;    /* Window in channel codes */
+    uint16_t high_raw;
+    uint32_t low_thr;    /* Window as programmed into the watchdog */
+    uint32_t high_thr;
+};
+
+struct awd_adc {
+    uint32_t channels;   /* Software channels on this converter */
+    ADC_TypeDef *adc;
+    bool msb_only;       /* Thresholds compare the ADC3_AWD23_BITS MSBs */
+    bool dirty;          /* Staged change not yet in the registers */
+    struct awd_unit units[AWD_PER_ADC];
+};
+
+static struct awd_adc awd_adcs[] = {
+    { .channels = ADC1_CHANNELS, .adc = (ADC_TypeDef *)DT_REG_ADDR(ADC1_NODE) },
+    { .channels = ADC3_CHANNELS, .adc = (ADC_TypeDef *)DT_REG_ADDR(ADC3_NODE),
+      .msb_only = true },
+};
+
+static const uint32_t awd_ll_id[AWD_PER_ADC] = { LL_ADC_AWD2, LL_ADC_AWD3 };
+
+#if defined(CONFIG_APP_ADC_PARALLEL)
+/* awd_adcs[] follows scan_groups[], so one index serves both */
+BUILD_ASSERT(ARRAY_SIZE(awd_adcs) == ARRAY_SIZE(scan_groups),
+             "one watchdog block per scan group");
+#endif
+
+static struct k_spinlock awd_lock;
+static uint32_t awd_covered;   /* Channels in an armed watchdog */
+static uint32_t awd_tripped;   /* Channels to check in software */
+
+static struct awd_adc *awd_adc_of(unsigned int ch)
+{
+    for (size_t a = 0; a < ARRAY_SIZE(awd_adcs); a++) {
+        if (awd_adcs[a].channels & BIT(ch)) {
+            return &awd_adcs[a];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Convert a code window to watchdog thresholds. With MSB-only compare the
+ * window shrinks to the coarser grid, so the watchdog trips on every code
+ * outside the requested window (and maybe a few inside, which software
+ * then rejects).
+ */
+static int awd_thresholds(const struct awd_adc *a, unsigned int ch, uint16_t low_raw,
+                          uint16_t high_raw, uint32_t *low_thr, uint32_t *high_thr)
+{
+    uint8_t shift = 0;
+
+    if (a->msb_only && channel_resolution[ch] > ADC3_AWD23_BITS) {
+        shift = channel_resolution[ch] - ADC3_AWD23_BITS;
+    }
+
+    if (((uint32_t)high_raw + 1) >> shift == 0) {
+        return -ENOTSUP;
+    }
+
+    *high_thr = (((uint32_t)high_raw + 1) >> shift) - 1;
+    *low_thr = (low_raw == 0) ? 0 : (((uint32_t)low_raw - 1) >> shift) + 1;
+
+    return 0;
+}
+
+static int awd_set_window(unsigned int ch, bool enable, uint16_t low_raw, uint16_t high_raw)
+{
+    struct awd_adc *a = awd_adc_of(ch);
+    uint32_t low_thr, high_thr;
+    k_spinlock_key_t key;
+    int ret = 0;
+
+    if (a == NULL) {
+        return -ENOTSUP;
+    }
+
+    /* Oversampled results are not what the watchdog compares against */
+    if (enable && channel_oversampling[ch] != 0) {
+        enable = false;
+        ret = -ENOTSUP;
+    }
+    if (enable) {
+        ret = awd_thresholds(a, ch, low_raw, high_raw, &low_thr, &high_thr);
+        enable = (ret == 0);
+    }
+
+    key = k_spin_lock(&awd_lock);
+
+    for (int u = 0; u < AWD_PER_ADC; u++) {
+        a->units[u].channels &= ~BIT(ch);
+    }
+
+    if (enable) {
+        struct awd_unit *unit = NULL;
+
+        /* Share a watchdog with an identical window, else take a free one */
+        for (int u = 0; u < AWD_PER_ADC && unit == NULL; u++) {
+            if (a->units[u].channels != 0 && a->units[u].low_raw == low_raw &&
+                a->units[u].high_raw == high_raw) {
+                unit = &a->units[u];
+            }
+        }
+        for (int u = 0; u < AWD_PER_ADC && unit == NULL; u++) {
+            if (a->units[u].channels == 0) {
+                unit = &a->units[u];
+                unit->low_raw = low_raw;
+                unit->high_raw = high_raw;
+                unit->low_thr = low_thr;
+                unit->high_thr = high_thr;
+            }
+        }
+
+        if (unit != NULL) {
+            unit->channels |= BIT(ch);
+        } else {
+            ret = -ENOSPC;
+        }
+    }
+
+    awd_covered = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(awd_adcs); i++) {
+        for (int u = 0; u < AWD_PER_ADC; u++) {
+            awd_covered |= awd_adcs[i].units[u].channels;
+        }
+    }
+
+    /* Until the new window is live, this channel is checked in software */
+    awd_tripped |= BIT(ch);
+    a->dirty = true;
+
+    k_spin_unlock(&awd_lock, key);
+
+    return ret;
+}
+
+static uint32_t awd_quiet(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&awd_lock);
+    uint32_t quiet = awd_covered & ~awd_tripped;
+
+    awd_tripped = 0;
+    k_spin_unlock(&awd_lock, key);
+
+    return quiet;
+}
+
+static const struct threshold_hw awd_hw = {
+    .set_window = awd_set_window,
+    .quiet = awd_quiet,
+};
+
+/* Write staged windows to the watchdogs of the idle converters */
+static void awd_apply(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&awd_lock);
+
+    for (size_t i = 0; i < ARRAY_SIZE(awd_adcs); i++) {
+        struct awd_adc *a = &awd_adcs[i];
+
+        if (!a->dirty) {
+            continue;
+        }
+#if defined(CONFIG_APP_ADC_PARALLEL)
+        /* A timed-out scan still converts; stay staged until it settles */
+        if (scan_pending[i]) {
+            continue;
+        }
+#endif
+
+        for (int u = 0; u < AWD_PER_ADC; u++) {
+            const struct awd_unit *unit = &a->units[u];
+            volatile uint32_t *cr = (u == 0) ? &a->adc->AWD2CR : &a->adc->AWD3CR;
+            uint32_t hw_channels = 0;
+
+            for (int ch = 0; ch < NUM_CH; ch++) {
+                if (unit->channels & BIT(ch)) {
+                    hw_channels |= BIT(channel_cfgs[ch].channel_id);
+                }
+            }
+
+            *cr = 0;
+            if (hw_channels != 0) {
+                LL_ADC_ConfigAnalogWDThresholds(a->adc, awd_ll_id[u], unit->high_thr,
+                                                unit->low_thr);
+                *cr = hw_channels;
+            }
+        }
+
+        LL_ADC_ClearFlag_AWD2(a->adc);
+        LL_ADC_ClearFlag_AWD3(a->adc);
+        a->dirty = false;
+    }
+
+    k_spin_unlock(&awd_lock, key);
+}
+
+/* Latch which watchdogs tripped during this frame's conversions */
+static void awd_collect(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&awd_lock);
+
+    for (size_t i = 0; i < ARRAY_SIZE(awd_adcs); i++) {
+        struct awd_adc *a = &awd_adcs[i];
+
+        if (LL_ADC_IsActiveFlag_AWD2(a->adc)) {
+            LL_ADC_ClearFlag_AWD2(a->adc);
+            awd_tripped |= a->units[0].channels;
+        }
+        if (LL_ADC_IsActiveFlag_AWD3(a->adc)) {
+            LL_ADC_ClearFlag_AWD3(a->adc);
+            awd_tripped |= a->units[1].channels;
+        }
+    }
+
+    k_spin_unlock(&awd_lock, key);
+}
+#endif /* CONFIG_APP_ADC_AWD */
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/* Stamped per adc_read(), or per slot by scan_group_stamp() */
+static uint64_t conv_ns[NUM_CH];
+
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+/*
+ * The driver reports only the end of a scan, so spread its slots evenly
+ * from the start to the completion the thread saw. Conversions of one
+ * sequence take equal time, so the error is the fixed start/finish cost.
+ */
+static void scan_group_stamp(const struct scan_group *grp, uint64_t t0, uint64_t t1)
+{
+    for (uint8_t slot = 0; slot < grp->num_active; slot++) {
+        conv_ns[grp->active_to_ch[slot]] = t0 + (t1 - t0) * slot / grp->num_active;
+    }
+}
+#endif
+#endif /* CONFIG_APP_CHANNEL_TIMESTAMPS */
+
 int adc_backend_init(void)
 {
 #if ADC_CONFIGURED
     int ret;
 
-    /* Initialize ADC1 */
-    adc1_dev = DEVICE_DT_GET(ADC1_NODE);
-    if (!device_is_ready(adc1_dev)) {
+    if (!device_is_ready(DEVICE_DT_GET(ADC1_NODE))) {
         LOG_ERR("ADC1 device not ready");
         return -ENODEV;
     }
 
-    /* Initialize ADC3 */
-    adc3_dev = DEVICE_DT_GET(ADC3_NODE);
-    if (!device_is_ready(adc3_dev)) {
+    if (!device_is_ready(DEVICE_DT_GET(ADC3_NODE))) {
         LOG_ERR("ADC3 device not ready");
         return -ENODEV;
     }
 
     /* Configure all channels */
     for (int i = 0; i < NUM_CH; i++) {
-        channel_cfgs[i] = (struct adc_channel_cfg){
-            .gain = ADC_GAIN_1,
-            .reference = ADC_REF_INTERNAL,  /* STM32 uses VREF+ pin (3.3V) */
-            .acquisition_time = ADC_ACQ_TIME_DEFAULT,  /* Use driver default */
-            .channel_id = channel_mappings[i].channel_id,
-            .differential = 0,  /* Single-ended mode */
-        };
+        const struct adc_dt_spec *spec = &channel_mappings[i];
+
+        if (spec->channel_cfg_dt_node_exists) {
+            channel_cfgs[i] = spec->channel_cfg;
+            channel_resolution[i] = spec->resolution ? spec->resolution : ADC_RESOLUTION;
+            channel_oversampling[i] = spec->oversampling;
+            /* 12-bit packed frames would clamp wider codes */
+            if (IS_ENABLED(CONFIG_APP_FRAME_PACK12) &&
+                channel_resolution[i] > FRAME_PACK12_BITS) {
+                LOG_ERR("Channel %d: %u-bit resolution needs CONFIG_APP_FRAME_PACK12=n",
+                        i, channel_resolution[i]);
+                return -ENOTSUP;
+            }
+        } else {
+            channel_cfgs[i] = (struct adc_channel_cfg){
+                .gain = ADC_GAIN_1,
+                .reference = ADC_REF_INTERNAL,  /* STM32 uses VREF+ pin (3.3V) */
+                .acquisition_time = ADC_ACQ_TIME_DEFAULT,  /* Use driver default */
+                .channel_id = spec->channel_id,
+                .differential = 0,  /* Single-ended mode */
+            };
+            channel_resolution[i] = ADC_RESOLUTION;
+            channel_oversampling[i] = ADC_OVERSAMPLING;
+        }
+        default_resolution[i] = channel_resolution[i];
+        default_oversampling[i] = channel_oversampling[i];
 
         /* Setup channel on the appropriate ADC device */
-        ret = adc_channel_setup(*channel_mappings[i].dev, &channel_cfgs[i]);
+        ret = adc_channel_setup(spec->dev, &channel_cfgs[i]);
         if (ret < 0) {
             LOG_ERR("Failed to setup channel %d (ADC channel %d): %d", 
-                    i, channel_mappings[i].channel_id, ret);
+                    i, spec->channel_id, ret);
             return ret;
         }
-        LOG_INF("Channel %d setup OK: ADC%d ch%d", i, 
-                (channel_mappings[i].dev == &adc1_dev) ? 1 : 3,
-                channel_mappings[i].channel_id);
+        regs_set_scale(i, ADC_REF_MV, channel_resolution[i]);
+
+        LOG_INF("Channel %d setup OK: ADC%d ch%d, %u-bit, %ux oversampling", i,
+                (ADC1_CHANNELS & BIT(i)) ? 1 : 3,
+                spec->channel_id, channel_resolution[i],
+                1U << channel_oversampling[i]);
     }
 
+#if defined(CONFIG_APP_ADC_AWD)
+    threshold_set_hw(&awd_hw);
+#endif
+
+#if defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+    ret = scan_groups_init();
+    if (ret < 0) {
+        return ret;
+    }
+    LOG_INF("ADC backend (HW) initialized with %d channels (DMA scan%s)", NUM_CH,
+            IS_ENABLED(CONFIG_APP_ADC_PARALLEL) ? ", ADC1/ADC3 in parallel" : "");
+#else
     LOG_INF("ADC backend (HW) initialized with %d channels", NUM_CH);
+#endif
     return 0;
 
 #else
@@ -149,28 +631,240 @@ int adc_backend_init(void)
 #endif
 }
 
-int adc_backend_sample_all(int32_t out_mv[NUM_CH])
+int adc_backend_config_check(uint8_t resolution, uint8_t oversampling)
+{
+#if ADC_CONFIGURED
+    if (resolution != ADC_BACKEND_DEFAULT &&
+        (resolution > 16 ||
+         (ADC1_CHANNELS != 0 && !(ADC1_RESOLUTIONS & BIT(resolution))) ||
+         (ADC3_CHANNELS != 0 && !(ADC3_RESOLUTIONS & BIT(resolution))))) {
+        return -ENOTSUP;
+    }
+
+    if (oversampling != ADC_BACKEND_DEFAULT &&
+        ((ADC1_CHANNELS != 0 && oversampling > ADC1_MAX_OVERSAMPLING) ||
+         (ADC3_CHANNELS != 0 && oversampling > ADC3_MAX_OVERSAMPLING))) {
+        return -ENOTSUP;
+    }
+#else
+    ARG_UNUSED(resolution);
+    ARG_UNUSED(oversampling);
+#endif
+
+    return 0;
+}
+
+int adc_backend_configure(uint8_t resolution, uint8_t oversampling)
 {
+    int ret = adc_backend_config_check(resolution, oversampling);
+
+    if (ret < 0) {
+        return ret;
+    }
+
 #if ADC_CONFIGURED
+    for (int i = 0; i < NUM_CH; i++) {
+        channel_resolution[i] =
+            (resolution == ADC_BACKEND_DEFAULT) ? default_resolution[i] : resolution;
+        channel_oversampling[i] =
+            (oversampling == ADC_BACKEND_DEFAULT) ? default_oversampling[i] : oversampling;
+        regs_set_scale(i, ADC_REF_MV, channel_resolution[i]);
+    }
+
+#if defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+    /* Per-converter sequences carry resolution and oversampling */
+    ret = scan_groups_init();
+    if (ret < 0) {
+        return ret;
+    }
+#endif
+
+    LOG_INF("Sequences rebuilt: resolution %s, oversampling %s",
+            (resolution == ADC_BACKEND_DEFAULT) ? "default" : "override",
+            (oversampling == ADC_BACKEND_DEFAULT) ? "default" : "override");
+#endif
+
+    return 0;
+}
+
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+/**
+ * @brief Copy a finished scan into the output frame
+ *
+ * @param g       Scan group index
+ * @param ret     Result of the conversion
+ * @param out_raw Frame being assembled
+ */
+static void scan_group_publish(size_t g, int ret, uint16_t out_raw[NUM_CH])
+{
+    const struct scan_group *grp = &scan_groups[g];
+
+    if (ret < 0) {
+        uint32_t missed;
+
+        if (sampler_stats_channels_failed(grp->prepared_mask & grp->channels, ret, &missed)) {
+            LOG_ERR("ADC scan failed on group %u: %d (%u more not logged)",
+                    (unsigned int)g, ret, missed);
+        }
+        for (uint8_t slot = 0; slot < grp->num_active; slot++) {
+            out_raw[grp->active_to_ch[slot]] = 0;
+        }
+        return;
+    }
+
+    for (uint8_t slot = 0; slot < grp->num_active; slot++) {
+        out_raw[grp->active_to_ch[slot]] = grp->buffer[slot];
+    }
+}
+#endif
+
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_PARALLEL)
+/**
+ * @brief Check whether a timed-out scan has finished since
+ *
+ * The ADC API cannot cancel a read, so a scan that outlived SCAN_TIMEOUT
+ * keeps the converter and DMA into its buffer; no new read may start on
+ * the group until its signal is raised.
+ *
+ * @param g Scan group index
+ * @return true if the group is free for a new scan
+ */
+static bool scan_group_settled(size_t g)
+{
+    unsigned int signaled;
+    int result;
+
+    if (!scan_pending[g]) {
+        return true;
+    }
+
+    k_poll_signal_check(&scan_signals[g], &signaled, &result);
+    if (signaled) {
+        scan_pending[g] = false;
+    }
+
+    return signaled;
+}
+#endif
+
+static int sample_frame(uint32_t ch_mask, uint16_t out_raw[NUM_CH])
+{
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_PARALLEL)
+    bool started[ARRAY_SIZE(scan_groups)] = {false};
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    uint64_t t_start[ARRAY_SIZE(scan_groups)];
+#endif
+    int ret;
+
+    /* Kick off every converter first so their scans overlap... */
+    for (size_t g = 0; g < ARRAY_SIZE(scan_groups); g++) {
+        struct scan_group *grp = &scan_groups[g];
+
+        if (scan_group_prepare(grp, ch_mask) == 0) {
+            continue;
+        }
+
+        if (!scan_group_settled(g)) {
+            scan_group_publish(g, -EBUSY, out_raw);
+            continue;
+        }
+
+        k_poll_signal_reset(&scan_signals[g]);
+        scan_events[g].state = K_POLL_STATE_NOT_READY;
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        t_start[g] = regs_clock_ns();
+#endif
+        ret = adc_read_async(grp->dev, &grp->sequence, &scan_signals[g]);
+        if (ret < 0) {
+            scan_group_publish(g, ret, out_raw);
+            continue;
+        }
+        started[g] = true;
+    }
+
+    /* ...then collect them; the frame takes as long as the slowest scan */
+    for (size_t g = 0; g < ARRAY_SIZE(scan_groups); g++) {
+        unsigned int signaled;
+        int result;
+
+        if (!started[g]) {
+            continue;
+        }
+
+        ret = k_poll(&scan_events[g], 1, SCAN_TIMEOUT);
+        if (ret == 0) {
+            k_poll_signal_check(&scan_signals[g], &signaled, &result);
+            ret = signaled ? result : -EIO;
+        } else {
+            /* Still converting: hold the group until the signal is raised */
+            scan_pending[g] = true;
+            ret = -ETIMEDOUT;
+        }
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        /* A scan that finished while the thread waited on another looks longer */
+        scan_group_stamp(&scan_groups[g], t_start[g], regs_clock_ns());
+#endif
+        scan_group_publish(g, ret, out_raw);
+    }
+
+    return 0;
+
+#elif ADC_CONFIGURED && defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+    int ret;
+
+    for (size_t g = 0; g < ARRAY_SIZE(scan_groups); g++) {
+        struct scan_group *grp = &scan_groups[g];
+
+        if (scan_group_prepare(grp, ch_mask) == 0) {
+            continue;
+        }
+
+        /* One conversion start, one DMA completion for the whole scan */
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        uint64_t t0 = regs_clock_ns();
+
+        ret = adc_read(grp->dev, &grp->sequence);
+        scan_group_stamp(grp, t0, regs_clock_ns());
+#else
+        ret = adc_read(grp->dev, &grp->sequence);
+#endif
+        scan_group_publish(g, ret, out_raw);
+    }
+
+    return 0;
+
+#elif ADC_CONFIGURED
     int ret;
 
     for (int i = 0; i < NUM_CH; i++) {
+        if (!(ch_mask & BIT(i))) {
+            continue;
+        }
+
         struct adc_sequence sequence = {
             .buffer = &sample_buffer[i],
             .buffer_size = sizeof(sample_buffer[i]),
-            .resolution = ADC_RESOLUTION,
+            .resolution = channel_resolution[i],
+            .oversampling = channel_oversampling[i],
             .channels = BIT(channel_cfgs[i].channel_id),
         };
 
         /* Read from the appropriate ADC device */
-        ret = adc_read(*channel_mappings[i].dev, &sequence);
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        conv_ns[i] = regs_clock_ns();
+#endif
+        ret = adc_read(channel_mappings[i].dev, &sequence);
         if (ret < 0) {
-            LOG_ERR("ADC read failed for channel %d (ADC channel %d): %d", 
-                    i, channel_cfgs[i].channel_id, ret);
-            out_mv[i] = 0;
+            uint32_t missed;
+
+            if (sampler_stats_channels_failed(BIT(i), ret, &missed)) {
+                LOG_ERR("ADC read failed for channel %d (ADC channel %d): %d "
+                        "(%u more not logged)", i, channel_cfgs[i].channel_id, ret, missed);
+            }
+            out_raw[i] = 0;
         } else {
-            int32_t raw = sample_buffer[i];
-            out_mv[i] = (raw * ADC_REF_MV) / ((1 << ADC_RESOLUTION) - 1);
+            out_raw[i] = sample_buffer[i];
         }
     }
 
@@ -179,8 +873,85 @@ int adc_backend_sample_all(int32_t out_mv[NUM_CH])
 #else
     /* Return zeros when not configured */
     for (int i = 0; i < NUM_CH; i++) {
-        out_mv[i] = 0;
+        if (ch_mask & BIT(i)) {
+            out_raw[i] = 0;
+        }
     }
     return 0;
 #endif
 }
+
+#if ADC_CONFIGURED
+/* Burst conversions land here; with CONFIG_ADC_STM32_DMA the driver DMAs them */
+static uint16_t burst_buffer APP_DMA_BSS;
+
+struct burst_ctx {
+    adc_backend_burst_cb cb;
+    void *user_data;
+};
+
+static enum adc_action burst_sampled(const struct device *dev,
+                                     const struct adc_sequence *sequence,
+                                     uint16_t sampling_index)
+{
+    const struct burst_ctx *ctx = sequence->options->user_data;
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(sampling_index);
+
+    /* Runs in the ADC (or DMA) ISR; repeat restarts the conversion at once */
+    return ctx->cb(burst_buffer, ctx->user_data) ? ADC_ACTION_REPEAT : ADC_ACTION_FINISH;
+}
+#endif
+
+int adc_backend_burst(unsigned int ch, adc_backend_burst_cb cb, void *user_data)
+{
+    if (ch >= NUM_CH) {
+        return -EINVAL;
+    }
+
+#if ADC_CONFIGURED
+    struct burst_ctx ctx = { .cb = cb, .user_data = user_data };
+    const struct adc_sequence_options options = {
+        .interval_us = 0,
+        .callback = burst_sampled,
+        .user_data = &ctx,
+    };
+    struct adc_sequence sequence = {
+        .options = &options,
+        .channels = BIT(channel_cfgs[ch].channel_id),
+        .buffer = &burst_buffer,
+        .buffer_size = sizeof(burst_buffer),
+        .resolution = channel_resolution[ch],
+        .oversampling = channel_oversampling[ch],
+    };
+
+    return adc_read(channel_mappings[ch].dev, &sequence);
+#else
+    ARG_UNUSED(cb);
+    ARG_UNUSED(user_data);
+    return -ENOTSUP;
+#endif
+}
+
+int adc_backend_sample(uint32_t ch_mask, uint16_t out_raw[NUM_CH])
+{
+#if ADC_CONFIGURED && defined(CONFIG_APP_ADC_AWD)
+    int ret;
+
+    awd_apply();
+    ret = sample_frame(ch_mask, out_raw);
+    awd_collect();
+
+    return ret;
+#else
+    return sample_frame(ch_mask, out_raw);
+#endif
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+void adc_backend_channel_offsets(uint64_t start_ns, uint32_t offset_ns[NUM_CH])
+{
+    regs_channel_offsets(conv_ns, start_ns, offset_ns);
+}
+#endif
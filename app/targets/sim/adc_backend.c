@@ -5,6 +5,8 @@
  */
 
 #include "../../src/adc_backend.h"
+#include "../../src/sampler_stats.h"
+#include "sim_wave.h"
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/adc.h>
@@ -24,18 +26,46 @@ static const struct device *adc_dev;
 
 /* ADC channel configuration */
 static struct adc_channel_cfg channel_cfgs[NUM_CH];
-static int16_t sample_buffer[NUM_CH];
+/* Polled: slot n is channel n. Scan: due channels packed in ascending order */
+static uint16_t sample_buffer[NUM_CH];
 
 /* Reference voltage in mV */
 #define ADC_REF_MV 3300
 
-/* ADC resolution (12-bit typical for emulator) */
+/* Default ADC resolution (12-bit typical for emulator) */
 #define ADC_RESOLUTION 12
 
+/* Resolutions the emulator converts at */
+#define ADC_MIN_RESOLUTION 6
+#define ADC_MAX_RESOLUTION 16
+
+/* Resolution of every sequence; changed by adc_backend_configure() */
+static uint8_t resolution = ADC_RESOLUTION;
+
 /* Injected values for each channel (used by adcset command) */
 static int32_t injected_mv[NUM_CH];
 static bool injection_enabled[NUM_CH];
 
+/* Waveforms (used by adcwave command); evaluated by the emulator per conversion */
+static struct sim_wave waves[NUM_CH];
+
+static int wave_value(const struct device *dev, unsigned int chan, void *data,
+                      uint32_t *result)
+{
+    int32_t mv = sim_wave_eval(data, k_ticks_to_us_floor64(k_uptime_ticks()));
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(chan);
+
+    *result = CLAMP(mv, 0, ADC_REF_MV);
+    return 0;
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/* Stamped per adc_read(), or spread over the emulated scan */
+static uint64_t conv_ns[NUM_CH];
+#endif
+
 int adc_backend_init(void)
 {
     int ret;
@@ -69,37 +99,175 @@ int adc_backend_init(void)
 
         injected_mv[i] = 0;
         injection_enabled[i] = false;
+
+        regs_set_scale(i, ADC_REF_MV, ADC_RESOLUTION);
     }
 
-    LOG_INF("ADC backend (SIM) initialized with %d channels", NUM_CH);
+    LOG_INF("ADC backend (SIM) initialized with %d channels%s", NUM_CH,
+            IS_ENABLED(CONFIG_APP_ADC_MODE_SCAN) ? " (single-sequence scan)" : "");
 
     return 0;
 }
 
-int adc_backend_sample_all(int32_t out_mv[NUM_CH])
+int adc_backend_config_check(uint8_t res, uint8_t oversampling)
+{
+    /* The emulator has no hardware oversampling */
+    if (oversampling != ADC_BACKEND_DEFAULT && oversampling != 0) {
+        return -ENOTSUP;
+    }
+
+    if (res != ADC_BACKEND_DEFAULT &&
+        (res < ADC_MIN_RESOLUTION || res > ADC_MAX_RESOLUTION)) {
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+
+int adc_backend_configure(uint8_t res, uint8_t oversampling)
+{
+    int ret = adc_backend_config_check(res, oversampling);
+
+    if (ret < 0) {
+        return ret;
+    }
+
+    resolution = (res == ADC_BACKEND_DEFAULT) ? ADC_RESOLUTION : res;
+    for (int i = 0; i < NUM_CH; i++) {
+        regs_set_scale(i, ADC_REF_MV, resolution);
+    }
+
+    LOG_INF("Resolution %u bits", resolution);
+
+    return 0;
+}
+
+int adc_backend_sample(uint32_t ch_mask, uint16_t out_raw[NUM_CH])
 {
     int ret;
 
+#if defined(CONFIG_APP_ADC_MODE_SCAN)
+    /* Software channel n is emulator channel n, so the mask is the sequence */
+    struct adc_sequence sequence = {
+        .buffer = sample_buffer,
+        .buffer_size = __builtin_popcount(ch_mask) * sizeof(sample_buffer[0]),
+        .resolution = resolution,
+        .channels = ch_mask,
+    };
+    size_t slot = 0;
+
+    if (ch_mask == 0) {
+        return 0;
+    }
+
+    uint32_t missed;
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    size_t num_slots = __builtin_popcount(ch_mask);
+    uint64_t t0 = regs_clock_ns();
+    uint64_t t1;
+#endif
+
+    ret = adc_read(adc_dev, &sequence);
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+    t1 = regs_clock_ns();
+#endif
+    if (ret < 0 && sampler_stats_channels_failed(ch_mask, ret, &missed)) {
+        LOG_ERR("ADC scan failed: %d (%u more not logged)", ret, missed);
+    }
+
+    for (int i = 0; i < NUM_CH; i++) {
+        if (ch_mask & BIT(i)) {
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+            /* Only the scan's end is reported; spread its slots evenly */
+            conv_ns[i] = t0 + (t1 - t0) * slot / num_slots;
+#endif
+            out_raw[i] = (ret < 0) ? 0 : sample_buffer[slot++];
+        }
+    }
+
+    return 0;
+#else
     for (int i = 0; i < NUM_CH; i++) {
+        if (!(ch_mask & BIT(i))) {
+            continue;
+        }
+
         struct adc_sequence sequence = {
             .buffer = &sample_buffer[i],
             .buffer_size = sizeof(sample_buffer[i]),
-            .resolution = ADC_RESOLUTION,
+            .resolution = resolution,
             .channels = BIT(i),
         };
 
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+        conv_ns[i] = regs_clock_ns();
+#endif
         ret = adc_read(adc_dev, &sequence);
         if (ret < 0) {
-            LOG_ERR("ADC read failed for channel %d: %d", i, ret);
-            out_mv[i] = 0;
+            uint32_t missed;
+
+            if (sampler_stats_channels_failed(BIT(i), ret, &missed)) {
+                LOG_ERR("ADC read failed for channel %d: %d (%u more not logged)", i, ret,
+                        missed);
+            }
+            out_raw[i] = 0;
         } else {
-            /* Convert raw value to millivolts */
-            int32_t raw = sample_buffer[i];
-            out_mv[i] = (raw * ADC_REF_MV) / ((1 << ADC_RESOLUTION) - 1);
+            /* Publish the raw code; readers convert to mV on demand */
+            out_raw[i] = sample_buffer[i];
         }
     }
 
     return 0;
+#endif
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+void adc_backend_channel_offsets(uint64_t start_ns, uint32_t offset_ns[NUM_CH])
+{
+    regs_channel_offsets(conv_ns, start_ns, offset_ns);
+}
+#endif
+
+struct burst_ctx {
+    adc_backend_burst_cb cb;
+    void *user_data;
+};
+
+static enum adc_action burst_sampled(const struct device *dev,
+                                     const struct adc_sequence *sequence,
+                                     uint16_t sampling_index)
+{
+    const struct burst_ctx *ctx = sequence->options->user_data;
+
+    ARG_UNUSED(dev);
+    ARG_UNUSED(sampling_index);
+
+    /* Repeat converts into the same buffer slot again */
+    return ctx->cb(*(const uint16_t *)sequence->buffer, ctx->user_data) ? ADC_ACTION_REPEAT
+                                                                         : ADC_ACTION_FINISH;
+}
+
+int adc_backend_burst(unsigned int ch, adc_backend_burst_cb cb, void *user_data)
+{
+    if (ch >= NUM_CH) {
+        return -EINVAL;
+    }
+
+    struct burst_ctx ctx = { .cb = cb, .user_data = user_data };
+    const struct adc_sequence_options options = {
+        .interval_us = 0,
+        .callback = burst_sampled,
+        .user_data = &ctx,
+    };
+    struct adc_sequence sequence = {
+        .options = &options,
+        .channels = BIT(ch),
+        .buffer = &sample_buffer[ch],
+        .buffer_size = sizeof(sample_buffer[ch]),
+        .resolution = resolution,
+    };
+
+    return adc_read(adc_dev, &sequence);
 }
 
 /**
@@ -133,8 +301,69 @@ int adc_backend_inject_mv(unsigned int ch, int32_t mv)
 
     injected_mv[ch] = mv;
     injection_enabled[ch] = true;
+    waves[ch].type = SIM_WAVE_OFF;
 
     LOG_INF("Injected ch[%u] = %d mV", ch, mv);
 
     return 0;
 }
+
+/**
+ * @brief Drive a channel with a waveform (SIM only)
+ *
+ * The channel falls back to its constant injected value first, so the
+ * emulator never evaluates a half-written waveform. SIM_WAVE_OFF leaves
+ * it there.
+ *
+ * @param ch   Channel number (0 to NUM_CH-1)
+ * @param wave Waveform, copied
+ * @return 0 on success, negative errno on failure
+ */
+int adc_backend_wave_set(unsigned int ch, const struct sim_wave *wave)
+{
+    int ret;
+
+    if (ch >= NUM_CH || wave->table_len > SIM_WAVE_TABLE_MAX) {
+        return -EINVAL;
+    }
+
+    ret = adc_emul_const_value_set(adc_dev, ch, injected_mv[ch]);
+    if (ret < 0) {
+        LOG_ERR("Failed to stop waveform on channel %d: %d", ch, ret);
+        return ret;
+    }
+
+    waves[ch] = *wave;
+    if (wave->type == SIM_WAVE_OFF) {
+        LOG_INF("Waveform off on ch[%u], back to %d mV", ch, injected_mv[ch]);
+        return 0;
+    }
+
+    ret = adc_emul_value_func_set(adc_dev, ch, wave_value, &waves[ch]);
+    if (ret < 0) {
+        LOG_ERR("Failed to start waveform on channel %d: %d", ch, ret);
+        waves[ch].type = SIM_WAVE_OFF;
+        return ret;
+    }
+
+    LOG_INF("Waveform %s on ch[%u]", sim_wave_type_name(wave->type), ch);
+
+    return 0;
+}
+
+/**
+ * @brief Get a channel's waveform (SIM only)
+ *
+ * @param ch   Channel number (0 to NUM_CH-1)
+ * @param wave Receives a copy
+ * @return 0 on success, -EINVAL for an invalid channel
+ */
+int adc_backend_wave_get(unsigned int ch, struct sim_wave *wave)
+{
+    if (ch >= NUM_CH) {
+        return -EINVAL;
+    }
+
+    *wave = waves[ch];
+    return 0;
+}
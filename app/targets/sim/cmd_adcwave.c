@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Shell command: adcwave - Drive ADC channels with waveforms (SIM only)
+ *
+ * This command is only compiled for simulator builds. Unlike adcset, the
+ * signal keeps changing without further shell traffic, so filters,
+ * thresholds and the stream can be exercised under sustained load.
+ */
+
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_wave.h"
+
+/* Declare the waveform functions from adc_backend.c */
+extern int adc_backend_wave_set(unsigned int ch, const struct sim_wave *wave);
+extern int adc_backend_wave_get(unsigned int ch, struct sim_wave *wave);
+
+/* Keeps t_us * freq_mhz in sim_wave_eval() within 64 bits for days of uptime */
+#define WAVE_MAX_FREQ_MHZ 10000000U
+
+#define WAVE_MAX_MV 3300
+
+static int parse_channel(const struct shell *sh, const char *arg, unsigned int *ch)
+{
+    char *end;
+    unsigned long val = strtoul(arg, &end, 10);
+
+    if (*end != '\0' || val >= CONFIG_APP_NUM_CH) {
+        shell_error(sh, "Invalid channel %s (0-%d)", arg, CONFIG_APP_NUM_CH - 1);
+        return -EINVAL;
+    }
+
+    *ch = (unsigned int)val;
+    return 0;
+}
+
+static int parse_mv(const struct shell *sh, const char *arg, int32_t *mv)
+{
+    char *end;
+    long val = strtol(arg, &end, 10);
+
+    if (*end != '\0' || val < 0 || val > WAVE_MAX_MV) {
+        shell_error(sh, "Invalid millivolt value %s (0-%d)", arg, WAVE_MAX_MV);
+        return -EINVAL;
+    }
+
+    *mv = (int32_t)val;
+    return 0;
+}
+
+/* Frequency in Hz with up to three decimals, e.g. "50" or "0.25" */
+static int parse_freq(const struct shell *sh, const char *arg, uint32_t *freq_mhz)
+{
+    char *end;
+    uint64_t mhz = strtoul(arg, &end, 10) * 1000ULL;
+
+    if (*end == '.') {
+        uint32_t scale = 100;
+
+        for (end++; *end >= '0' && *end <= '9' && scale > 0; end++, scale /= 10) {
+            mhz += (uint64_t)(*end - '0') * scale;
+        }
+    }
+
+    if (*end != '\0' || mhz == 0 || mhz > WAVE_MAX_FREQ_MHZ) {
+        shell_error(sh, "Invalid frequency %s (0.001-%u Hz)", arg,
+                    WAVE_MAX_FREQ_MHZ / 1000);
+        return -EINVAL;
+    }
+
+    *freq_mhz = (uint32_t)mhz;
+    return 0;
+}
+
+static int wave_apply(const struct shell *sh, unsigned int ch, const struct sim_wave *wave)
+{
+    int ret = adc_backend_wave_set(ch, wave);
+
+    if (ret < 0) {
+        shell_error(sh, "Waveform failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "ch[%u]: %s", ch, sim_wave_type_name(wave->type));
+    return 0;
+}
+
+static int cmd_adcwave_list(const struct shell *sh, size_t argc, char **argv)
+{
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    shell_print(sh, "Waveforms:");
+
+    for (unsigned int ch = 0; ch < CONFIG_APP_NUM_CH; ch++) {
+        struct sim_wave w;
+
+        (void)adc_backend_wave_get(ch, &w);
+        if (w.type == SIM_WAVE_OFF) {
+            continue;
+        }
+
+        shell_fprintf(sh, SHELL_NORMAL, "  ch[%u]: %s", ch, sim_wave_type_name(w.type));
+        if (w.type != SIM_WAVE_NOISE) {
+            shell_fprintf(sh, SHELL_NORMAL, " %u.%03u Hz", w.freq_mhz / 1000,
+                          w.freq_mhz % 1000);
+        }
+        if (w.type == SIM_WAVE_TABLE) {
+            shell_print(sh, " %u points", w.table_len);
+        } else {
+            shell_print(sh, " amplitude=%d offset=%d mV", w.amplitude_mv, w.offset_mv);
+        }
+    }
+
+    return 0;
+}
+
+/* sine|ramp|square <ch> <freq_hz> <amplitude_mv> [offset_mv] */
+static int cmd_adcwave_periodic(const struct shell *sh, size_t argc, char **argv,
+                                enum sim_wave_type type)
+{
+    struct sim_wave w = { .type = type, .offset_mv = WAVE_MAX_MV / 2 };
+    unsigned int ch;
+
+    if (parse_channel(sh, argv[1], &ch) < 0 ||
+        parse_freq(sh, argv[2], &w.freq_mhz) < 0 ||
+        parse_mv(sh, argv[3], &w.amplitude_mv) < 0 ||
+        (argc > 4 && parse_mv(sh, argv[4], &w.offset_mv) < 0)) {
+        return -EINVAL;
+    }
+
+    return wave_apply(sh, ch, &w);
+}
+
+static int cmd_adcwave_sine(const struct shell *sh, size_t argc, char **argv)
+{
+    return cmd_adcwave_periodic(sh, argc, argv, SIM_WAVE_SINE);
+}
+
+static int cmd_adcwave_ramp(const struct shell *sh, size_t argc, char **argv)
+{
+    return cmd_adcwave_periodic(sh, argc, argv, SIM_WAVE_RAMP);
+}
+
+static int cmd_adcwave_square(const struct shell *sh, size_t argc, char **argv)
+{
+    return cmd_adcwave_periodic(sh, argc, argv, SIM_WAVE_SQUARE);
+}
+
+/* noise <ch> <amplitude_mv> [offset_mv] */
+static int cmd_adcwave_noise(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sim_wave w = { .type = SIM_WAVE_NOISE, .offset_mv = WAVE_MAX_MV / 2 };
+    unsigned int ch;
+
+    if (parse_channel(sh, argv[1], &ch) < 0 ||
+        parse_mv(sh, argv[2], &w.amplitude_mv) < 0 ||
+        (argc > 3 && parse_mv(sh, argv[3], &w.offset_mv) < 0)) {
+        return -EINVAL;
+    }
+
+    w.noise_state = ch + 1;
+    return wave_apply(sh, ch, &w);
+}
+
+/* table <ch> <freq_hz> <mv> [<mv> ...] */
+static int cmd_adcwave_table(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sim_wave w = { .type = SIM_WAVE_TABLE };
+    unsigned int ch;
+
+    if (argc - 3 > SIM_WAVE_TABLE_MAX) {
+        shell_error(sh, "At most %d points", SIM_WAVE_TABLE_MAX);
+        return -EINVAL;
+    }
+
+    if (parse_channel(sh, argv[1], &ch) < 0 || parse_freq(sh, argv[2], &w.freq_mhz) < 0) {
+        return -EINVAL;
+    }
+
+    for (size_t i = 3; i < argc; i++) {
+        int32_t mv;
+
+        if (parse_mv(sh, argv[i], &mv) < 0) {
+            return -EINVAL;
+        }
+        w.table_mv[w.table_len++] = (int16_t)mv;
+    }
+
+    return wave_apply(sh, ch, &w);
+}
+
+static int cmd_adcwave_off(const struct shell *sh, size_t argc, char **argv)
+{
+    struct sim_wave w = { .type = SIM_WAVE_OFF };
+    unsigned int ch;
+
+    ARG_UNUSED(argc);
+
+    if (parse_channel(sh, argv[1], &ch) < 0) {
+        return -EINVAL;
+    }
+
+    return wave_apply(sh, ch, &w);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(adcwave_cmds,
+    SHELL_CMD(list, NULL, "Show active waveforms", cmd_adcwave_list),
+    SHELL_CMD_ARG(sine, NULL, "Sine: sine <ch> <freq_hz> <amplitude_mv> [offset_mv]",
+                  cmd_adcwave_sine, 4, 1),
+    SHELL_CMD_ARG(ramp, NULL, "Sawtooth: ramp <ch> <freq_hz> <amplitude_mv> [offset_mv]",
+                  cmd_adcwave_ramp, 4, 1),
+    SHELL_CMD_ARG(square, NULL, "Square: square <ch> <freq_hz> <amplitude_mv> [offset_mv]",
+                  cmd_adcwave_square, 4, 1),
+    SHELL_CMD_ARG(noise, NULL, "Uniform noise: noise <ch> <amplitude_mv> [offset_mv]",
+                  cmd_adcwave_noise, 3, 1),
+    SHELL_CMD_ARG(table, NULL, "Replay points: table <ch> <freq_hz> <mv> [<mv> ...]",
+                  cmd_adcwave_table, 4, SIM_WAVE_TABLE_MAX - 1),
+    SHELL_CMD_ARG(off, NULL, "Back to the adcset value: off <ch>", cmd_adcwave_off, 2, 0),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(adcwave, &adcwave_cmds, "Waveform injection (SIM only)",
+                   cmd_adcwave_list);
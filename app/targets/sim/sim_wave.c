@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Waveform generator for the simulator ADC (SIM only)
+ *
+ * Integer-only: the phase is a 32-bit fraction of a period and the sine
+ * comes from a quarter-wave Q15 table with linear interpolation, so the
+ * emulator's conversion callback stays cheap.
+ */
+
+#include "sim_wave.h"
+
+/* One microsecond times one millihertz, in periods */
+#define PERIOD_UNITS 1000000000ULL
+
+/* sin(pi/2 * i/64) in Q15, i = 0..64 */
+static const int16_t quarter_sine[65] = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+/* Fraction of the current period, 2^32 = one full period */
+static uint32_t wave_phase(uint32_t freq_mhz, uint64_t t_us)
+{
+    uint64_t frac = (t_us * freq_mhz) % PERIOD_UNITS;
+
+    return (uint32_t)((frac << 32) / PERIOD_UNITS);
+}
+
+/* sin(2 pi phase / 2^32) in Q15 */
+static int32_t sine_q15(uint32_t phase)
+{
+    uint32_t x = (phase >> 8) & 0x3fffff;   /* Position in the quadrant, 22 bits */
+    uint32_t quadrant = phase >> 30;
+    uint32_t idx, frac;
+    int32_t v;
+
+    if (quadrant & 1) {
+        x = 0x400000 - x;
+    }
+
+    idx = x >> 16;
+    frac = x & 0xffff;
+    v = quarter_sine[idx];
+    if (idx < 64) {
+        v += ((quarter_sine[idx + 1] - v) * (int32_t)frac) >> 16;
+    }
+
+    return (quadrant & 2) ? -v : v;
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = (*state != 0) ? *state : 0x2545f491;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+int32_t sim_wave_eval(struct sim_wave *w, uint64_t t_us)
+{
+    int64_t amp = w->amplitude_mv;
+    uint32_t phase;
+
+    switch (w->type) {
+    case SIM_WAVE_SINE:
+        phase = wave_phase(w->freq_mhz, t_us);
+        return w->offset_mv + (int32_t)((amp * sine_q15(phase)) / 32767);
+
+    case SIM_WAVE_RAMP:
+        phase = wave_phase(w->freq_mhz, t_us);
+        return w->offset_mv - (int32_t)amp + (int32_t)((2 * amp * phase) >> 32);
+
+    case SIM_WAVE_SQUARE:
+        phase = wave_phase(w->freq_mhz, t_us);
+        return w->offset_mv + (int32_t)((phase < 0x80000000U) ? amp : -amp);
+
+    case SIM_WAVE_NOISE: {
+        /* Uniform over the 2 * amplitude + 1 codes around offset */
+        uint64_t span = (uint64_t)(2 * amp + 1);
+
+        return w->offset_mv - (int32_t)amp +
+               (int32_t)(((uint64_t)xorshift32(&w->noise_state) * span) >> 32);
+    }
+
+    case SIM_WAVE_TABLE:
+        if (w->table_len == 0) {
+            return w->offset_mv;
+        }
+        phase = wave_phase(w->freq_mhz, t_us);
+        return w->table_mv[((uint64_t)phase * w->table_len) >> 32];
+
+    case SIM_WAVE_OFF:
+    default:
+        return w->offset_mv;
+    }
+}
+
+const char *sim_wave_type_name(enum sim_wave_type type)
+{
+    switch (type) {
+    case SIM_WAVE_SINE:
+        return "sine";
+    case SIM_WAVE_RAMP:
+        return "ramp";
+    case SIM_WAVE_SQUARE:
+        return "square";
+    case SIM_WAVE_NOISE:
+        return "noise";
+    case SIM_WAVE_TABLE:
+        return "table";
+    case SIM_WAVE_OFF:
+    default:
+        return "off";
+    }
+}
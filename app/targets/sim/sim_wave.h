@@ -0,0 +1,60 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Waveform generator for the simulator ADC (SIM only)
+ *
+ * A struct sim_wave describes one channel's signal as a function of time.
+ * The SIM backend installs it with adc_emul_value_func_set(), so every
+ * conversion of that channel evaluates the waveform at the current uptime
+ * with no shell round-trip per value.
+ */
+
+#ifndef SIM_WAVE_H_
+#define SIM_WAVE_H_
+
+#include <stdint.h>
+
+/** Maximum points of a replayed table */
+#define SIM_WAVE_TABLE_MAX 32
+
+/** Waveform shapes */
+enum sim_wave_type {
+    SIM_WAVE_OFF = 0,   /* No waveform (constant injection applies) */
+    SIM_WAVE_SINE,      /* offset + amplitude * sin(2 pi f t) */
+    SIM_WAVE_RAMP,      /* Sawtooth from offset - amplitude to offset + amplitude */
+    SIM_WAVE_SQUARE,    /* offset +/- amplitude, 50% duty */
+    SIM_WAVE_NOISE,     /* offset + uniform noise in [-amplitude, amplitude] */
+    SIM_WAVE_TABLE,     /* Table points, one table per period, held between points */
+};
+
+/** One channel's waveform */
+struct sim_wave {
+    enum sim_wave_type type;
+    uint32_t freq_mhz;      /* Frequency in millihertz (unused for NOISE) */
+    int32_t offset_mv;
+    int32_t amplitude_mv;   /* Peak deviation from offset */
+    uint32_t noise_state;   /* xorshift32 state for NOISE, 0 = default seed */
+    uint8_t table_len;      /* Points in table_mv (TABLE) */
+    int16_t table_mv[SIM_WAVE_TABLE_MAX];
+};
+
+/**
+ * @brief Evaluate a waveform
+ *
+ * The result is not clamped to the ADC input range.
+ *
+ * @param w    Waveform (NOISE advances its generator state)
+ * @param t_us Time in microseconds
+ * @return Value in millivolts
+ */
+int32_t sim_wave_eval(struct sim_wave *w, uint64_t t_us);
+
+/**
+ * @brief Get the name of a waveform type ("sine", "ramp", ...)
+ *
+ * @param type Waveform type
+ * @return Static name string
+ */
+const char *sim_wave_type_name(enum sim_wave_type type);
+
+#endif /* SIM_WAVE_H_ */
@@ -0,0 +1,62 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Benchmark helpers - per-call timing and machine-readable result lines
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include "bench.h"
+#include "regs.h"
+
+#if defined(CONFIG_APP_TARGET_SIM) && defined(CONFIG_APP_ADC_MODE_SCAN)
+#define BENCH_MODE "sim-scan"
+#elif defined(CONFIG_APP_TARGET_SIM)
+#define BENCH_MODE "sim"
+#elif defined(CONFIG_APP_ADC_MODE_SCAN_DMA) && defined(CONFIG_APP_ADC_PARALLEL)
+#define BENCH_MODE "async"
+#elif defined(CONFIG_APP_ADC_MODE_SCAN_DMA)
+#define BENCH_MODE "dma"
+#else
+#define BENCH_MODE "polled"
+#endif
+
+void bench_begin(struct bench_result *r)
+{
+    r->n = 0;
+    r->min_ns = UINT64_MAX;
+    r->max_ns = 0;
+    r->total_ns = 0;
+
+    timing_init();
+    timing_start();
+}
+
+void bench_add(struct bench_result *r, timing_t start, timing_t end)
+{
+    uint64_t ns = timing_cycles_to_ns(timing_cycles_get(&start, &end));
+
+    r->n++;
+    r->total_ns += ns;
+    r->min_ns = MIN(r->min_ns, ns);
+    r->max_ns = MAX(r->max_ns, ns);
+}
+
+void bench_merge(struct bench_result *dst, const struct bench_result *src)
+{
+    dst->n += src->n;
+    dst->total_ns += src->total_ns;
+    dst->min_ns = MIN(dst->min_ns, src->min_ns);
+    dst->max_ns = MAX(dst->max_ns, src->max_ns);
+}
+
+void bench_report(const char *name, const struct bench_result *r)
+{
+    uint64_t mean_ns = r->n ? r->total_ns / r->n : 0;
+    uint64_t ops_per_s = r->total_ns ? ((uint64_t)r->n * NSEC_PER_SEC) / r->total_ns : 0;
+
+    printk("BENCH test=%s board=%s mode=%s num_ch=%d n=%u "
+           "min_ns=%llu mean_ns=%llu max_ns=%llu ops_per_s=%llu\n",
+           name, CONFIG_BOARD, BENCH_MODE, NUM_CH, r->n,
+           r->n ? r->min_ns : 0, mean_ns, r->max_ns, ops_per_s);
+}
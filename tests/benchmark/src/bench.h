@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Benchmark helpers - per-call timing and machine-readable result lines
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <zephyr/timing/timing.h>
+
+/** Register-file benchmarks are cheap, so they run 10x the iterations */
+#define BENCH_ITERATIONS      CONFIG_BENCH_ITERATIONS
+#define BENCH_REGS_ITERATIONS (10 * CONFIG_BENCH_ITERATIONS)
+
+/** @brief Accumulated latency of one benchmarked operation */
+struct bench_result {
+    uint32_t n;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t total_ns;
+};
+
+/** @brief Reset a result and start the timing API */
+void bench_begin(struct bench_result *r);
+
+/** @brief Add one timed call between two timing_counter_get() stamps */
+void bench_add(struct bench_result *r, timing_t start, timing_t end);
+
+/** @brief Fold one result into another (e.g. per-thread into total) */
+void bench_merge(struct bench_result *dst, const struct bench_result *src);
+
+/**
+ * @brief Print a result as one line for the twister record harness
+ *
+ * Format: BENCH test=<name> board=<board> mode=<mode> num_ch=<n> n=<calls>
+ *         min_ns=<> mean_ns=<> max_ns=<> ops_per_s=<>
+ */
+void bench_report(const char *name, const struct bench_result *r);
+
+#endif /* BENCH_H */
@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * ADC backend benchmarks - cost of one full frame acquisition
+ */
+
+#include <zephyr/ztest.h>
+#include "adc_backend.h"
+#include "bench.h"
+#include "regs.h"
+
+static void *bench_backend_setup(void)
+{
+    regs_init();
+    zassert_ok(adc_backend_init(), "ADC backend init failed");
+    return NULL;
+}
+
+/**
+ * @brief adc_backend_sample_all() latency for the configured mode and NUM_CH
+ */
+ZTEST(bench_backend, test_sample_all)
+{
+    struct bench_result r;
+    uint16_t raw[NUM_CH];
+
+    bench_begin(&r);
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+        int ret = adc_backend_sample_all(raw);
+        timing_t end = timing_counter_get();
+
+        zassert_ok(ret, "sample_all failed at iteration %d", i);
+        bench_add(&r, start, end);
+    }
+
+    bench_report("sample_all", &r);
+}
+
+/**
+ * @brief Acquisition plus publish, i.e. one sampling-loop iteration
+ */
+ZTEST(bench_backend, test_sample_and_publish)
+{
+    struct bench_result r;
+    uint16_t raw[NUM_CH];
+
+    bench_begin(&r);
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+        int ret = adc_backend_sample_all(raw);
+
+        regs_update(raw);
+        timing_t end = timing_counter_get();
+
+        zassert_ok(ret, "sample_all failed at iteration %d", i);
+        bench_add(&r, start, end);
+    }
+
+    bench_report("sample_and_publish", &r);
+}
+
+ZTEST_SUITE(bench_backend, NULL, bench_backend_setup, NULL, NULL, NULL);
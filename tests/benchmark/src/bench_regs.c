@@ -0,0 +1,218 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Register file benchmarks - regs_update()/regs_read() cost and contention
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/atomic.h>
+#include "bench.h"
+#include "regs.h"
+
+#define READERS           CONFIG_BENCH_READERS
+#define READER_STACK_SIZE 1024
+
+K_THREAD_STACK_ARRAY_DEFINE(reader_stacks, READERS, READER_STACK_SIZE);
+static struct k_thread reader_threads[READERS];
+static struct bench_result reader_results[READERS];
+static atomic_t readers_stop;
+static atomic_t torn_reads;
+
+/* Every channel carries the low bits of seq, so a torn snapshot is detectable */
+static void update_frame(uint32_t seq)
+{
+    uint16_t raw[NUM_CH];
+
+    for (int i = 0; i < NUM_CH; i++) {
+        raw[i] = (uint16_t)seq;
+    }
+    regs_update(raw);
+}
+
+static void check_snapshot(const struct adc_regs *snap)
+{
+    for (int i = 0; i < NUM_CH; i++) {
+        if (snap->raw[i] != (uint16_t)snap->seq) {
+            atomic_inc(&torn_reads);
+            return;
+        }
+    }
+}
+
+/* Spin on regs_read() until told to stop, timing every call */
+static void spinning_reader(void *p1, void *p2, void *p3)
+{
+    struct bench_result *r = p1;
+    struct adc_regs snap;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    while (!atomic_get(&readers_stop)) {
+        timing_t start = timing_counter_get();
+
+        regs_read(&snap);
+        bench_add(r, start, timing_counter_get());
+        check_snapshot(&snap);
+    }
+}
+
+/* Wake once per tick and read, preempting whatever the writer is doing */
+static void periodic_reader(void *p1, void *p2, void *p3)
+{
+    struct bench_result *r = p1;
+    struct adc_regs snap;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        k_sleep(K_TICKS(1));
+
+        timing_t start = timing_counter_get();
+
+        regs_read(&snap);
+        bench_add(r, start, timing_counter_get());
+        check_snapshot(&snap);
+    }
+}
+
+static void start_readers(k_thread_entry_t entry, int prio)
+{
+    atomic_set(&readers_stop, 0);
+
+    for (int i = 0; i < READERS; i++) {
+        bench_begin(&reader_results[i]);
+        k_thread_create(&reader_threads[i], reader_stacks[i], READER_STACK_SIZE,
+                        entry, &reader_results[i], NULL, NULL,
+                        prio, 0, K_NO_WAIT);
+    }
+}
+
+static void join_readers(const char *name)
+{
+    struct bench_result total;
+
+    atomic_set(&readers_stop, 1);
+    bench_begin(&total);
+
+    for (int i = 0; i < READERS; i++) {
+        k_thread_join(&reader_threads[i], K_FOREVER);
+        bench_merge(&total, &reader_results[i]);
+    }
+
+    bench_report(name, &total);
+}
+
+static void *bench_regs_setup(void)
+{
+    /*
+     * The ztest thread is cooperative by default; make it preemptible so
+     * higher-priority readers can interrupt a regs_update() in progress.
+     */
+    k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(5));
+    return NULL;
+}
+
+static void bench_regs_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    atomic_set(&torn_reads, 0);
+}
+
+/**
+ * @brief Writer cost with no readers
+ */
+ZTEST(bench_regs, test_update)
+{
+    struct bench_result r;
+
+    bench_begin(&r);
+    for (uint32_t i = 1; i <= BENCH_REGS_ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        update_frame(i);
+        bench_add(&r, start, timing_counter_get());
+    }
+
+    bench_report("regs_update", &r);
+}
+
+/**
+ * @brief Reader cost with no writer
+ */
+ZTEST(bench_regs, test_read)
+{
+    struct bench_result r;
+    struct adc_regs snap;
+
+    update_frame(1);
+
+    bench_begin(&r);
+    for (int i = 0; i < BENCH_REGS_ITERATIONS; i++) {
+        timing_t start = timing_counter_get();
+
+        regs_read(&snap);
+        bench_add(&r, start, timing_counter_get());
+    }
+
+    zassert_equal(snap.seq, 1, "snapshot should see the single update");
+    bench_report("regs_read", &r);
+}
+
+/**
+ * @brief Writer preempting lower-priority spinning readers
+ *
+ * The writer sleeps a tick between updates so the readers run, then
+ * preempts them mid-copy. Writer latency should match test_update since
+ * the latch never waits on readers; reader latency includes retries.
+ */
+ZTEST(bench_regs, test_update_with_low_prio_readers)
+{
+    struct bench_result r;
+
+    start_readers(spinning_reader, k_thread_priority_get(k_current_get()) + 1);
+
+    bench_begin(&r);
+    for (uint32_t i = 1; i <= BENCH_ITERATIONS; i++) {
+        k_sleep(K_TICKS(1));
+
+        timing_t start = timing_counter_get();
+
+        update_frame(i);
+        bench_add(&r, start, timing_counter_get());
+    }
+
+    join_readers("regs_read_vs_writer");
+    bench_report("regs_update_vs_readers", &r);
+    zassert_equal(atomic_get(&torn_reads), 0, "readers saw torn snapshots");
+}
+
+/**
+ * @brief Higher-priority readers interrupting a continuous writer
+ */
+ZTEST(bench_regs, test_read_preempting_writer)
+{
+    uint32_t seq = 0;
+    bool running = true;
+
+    start_readers(periodic_reader, k_thread_priority_get(k_current_get()) - 1);
+
+    while (running) {
+        update_frame(++seq);
+
+        running = false;
+        for (int i = 0; i < READERS; i++) {
+            if (reader_results[i].n < BENCH_ITERATIONS) {
+                running = true;
+                break;
+            }
+        }
+    }
+
+    join_readers("regs_read_preempting_writer");
+    zassert_equal(atomic_get(&torn_reads), 0, "readers saw torn snapshots");
+}
+
+ZTEST_SUITE(bench_regs, NULL, bench_regs_setup, bench_regs_before, NULL, NULL);
@@ -5,10 +5,15 @@ This module provides config-driven fixtures that create the appropriate
 DUT and instrument instances based on YAML configuration files.
 """
 
+import sys
+
 import pytest
 import yaml
 from pathlib import Path
 
+# Host tools (tools/adc_stream.py) are importable from the tests
+sys.path.insert(0, str(Path(__file__).parent.parent.parent / "tools"))
+
 from devices.qemu import QEMUDevice
 from instruments.virtual import VirtualInstrument
 
@@ -57,6 +62,8 @@ def create_dut(dut_config: dict):
         return PhysicalDevice(
             port=dut_config.get("port"),
             baudrate=dut_config.get("baudrate", 115200),
+            stream_port=dut_config.get("stream_port"),
+            stream_baudrate=dut_config.get("stream_baudrate", 921600),
         )
     else:
         raise ValueError(f"Unknown DUT type: {dut_type}")
@@ -31,3 +31,13 @@ class DUTBase(ABC):
             Response string from the DUT
         """
         pass
+
+    def open_stream(self):
+        """
+        Open the binary sample stream UART (app,stream-uart).
+
+        Returns:
+            Serial-like object whose read(n) returns the raw stream bytes.
+            The caller closes it.
+        """
+        raise NotImplementedError(f"{type(self).__name__} has no stream port")
@@ -17,6 +17,8 @@ class PhysicalDevice(DUTBase):
         port: str,
         baudrate: int = 115200,
         timeout: float = 2.0,
+        stream_port: str = None,
+        stream_baudrate: int = 921600,
     ):
         """
         Initialize physical device connection.
@@ -25,10 +27,14 @@ class PhysicalDevice(DUTBase):
             port: Serial port path (e.g., /dev/ttyACM0, COM3)
             baudrate: Serial baud rate
             timeout: Serial read timeout in seconds
+            stream_port: USB-UART adapter on the stream UART (USART2), if wired
+            stream_baudrate: Stream UART baud rate
         """
         self._port = port
         self._baudrate = baudrate
         self._timeout = timeout
+        self._stream_port = stream_port
+        self._stream_baudrate = stream_baudrate
         self._serial: serial.Serial = None
 
     def start(self) -> None:
@@ -84,6 +90,15 @@ class PhysicalDevice(DUTBase):
 
         return response.decode(errors="replace")
 
+    def open_stream(self):
+        """Open the binary stream on the USB-UART adapter wired to USART2."""
+        if not self._stream_port:
+            raise RuntimeError("No stream_port configured for this device")
+
+        stream = serial.Serial(self._stream_port, baudrate=self._stream_baudrate, timeout=0.05)
+        stream.reset_input_buffer()
+        return stream
+
     def __enter__(self):
         """Context manager entry."""
         self.start()
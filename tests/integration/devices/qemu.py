@@ -36,6 +36,7 @@ class QEMUDevice(DUTBase):
         self._process: subprocess.Popen = None
         self._serial: serial.Serial = None
         self._pty_path: str = None
+        self._stream_pty_path: str = None
 
     def _find_qemu_binary(self) -> str:
         """Find the QEMU binary path."""
@@ -82,7 +83,7 @@ class QEMUDevice(DUTBase):
         qemu_bin = self._find_qemu_binary()
         kernel = self._find_kernel()
 
-        # Start QEMU with PTY
+        # Start QEMU with PTYs: serial0 is the shell, serial1 the binary stream
         cmd = [
             qemu_bin,
             "-m", "32",
@@ -94,6 +95,7 @@ class QEMUDevice(DUTBase):
             "-machine", "acpi=off",
             "-net", "none",
             "-serial", "pty",
+            "-serial", "pty",
             "-kernel", str(kernel),
         ]
 
@@ -105,8 +107,8 @@ class QEMUDevice(DUTBase):
             bufsize=1,
         )
 
-        # Wait for QEMU to print the PTY path
-        self._pty_path = None
+        # Wait for QEMU to print both PTY paths, in serial port order
+        ptys = []
         timeout_iterations = int(self._boot_timeout * 10)  # 100ms per iteration
         for _ in range(timeout_iterations):
             line = self._process.stdout.readline()
@@ -114,11 +116,15 @@ class QEMUDevice(DUTBase):
                 time.sleep(0.1)
                 continue
 
-            # Look for: char device redirected to /dev/pts/X
+            # Look for: char device redirected to /dev/pts/X (label serialN)
             match = re.search(r"/dev/pts/\d+", line)
             if match:
-                self._pty_path = match.group(0)
-                break
+                ptys.append(match.group(0))
+                if len(ptys) == 2:
+                    break
+
+        self._pty_path = ptys[0] if ptys else None
+        self._stream_pty_path = ptys[1] if len(ptys) > 1 else None
 
         if not self._pty_path:
             self._cleanup_process()
@@ -186,6 +192,15 @@ class QEMUDevice(DUTBase):
 
         return response.decode(errors="replace")
 
+    def open_stream(self):
+        """Open the binary stream on QEMU's second serial port."""
+        if not self._stream_pty_path:
+            raise RuntimeError("QEMU did not output a stream PTY path")
+
+        stream = serial.Serial(self._stream_pty_path, baudrate=115200, timeout=0.05)
+        stream.reset_input_buffer()
+        return stream
+
     def __enter__(self):
         """Context manager entry."""
         self.start()
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Binary stream throughput tests.
+
+Reads the stream UART with the host reader (tools/adc_stream.py) at the
+frame period and limits in the config's 'stream' section, so a pipeline
+change that costs throughput fails here:
+- Virtual: QEMU's second serial port
+- Physical: USB-UART adapter on USART2 (dut.stream_port)
+"""
+
+import re
+
+import pytest
+
+from adc_stream import PROTO_VERSION, read_stream
+
+
+def parse_period_us(response: str) -> int:
+    """Parse the frame period from adcrate output."""
+    match = re.search(r"Period:\s*(\d+)\s*us", response)
+    if not match:
+        raise ValueError(f"Could not find period in response: {response}")
+    return int(match.group(1))
+
+
+@pytest.fixture(scope="class")
+def stream_config(test_config):
+    """Throughput limits for this setup; skip if the config has none."""
+    config = test_config.get("stream")
+    if not config:
+        pytest.skip("No 'stream' section in the test config")
+    return config
+
+
+@pytest.fixture(scope="class")
+def stream_capture(dut, stream_config):
+    """One stream run at the configured period, shared by the class."""
+    saved_period = parse_period_us(dut.send_command("adcrate"))
+    response = dut.send_command(f"adcrate period {stream_config['period_us']}")
+    assert parse_period_us(response) == stream_config["period_us"], response
+
+    port = dut.open_stream()
+    try:
+        assert "Stream started" in dut.send_command("adcstream start")
+        capture = read_stream(port, stream_config.get("duration_s", 5))
+    finally:
+        dut.send_command("adcstream stop")
+        port.close()
+        dut.send_command(f"adcrate period {saved_period}")
+
+    return capture
+
+
+class TestStream:
+    """Stream throughput - run against any DUT with a stream port."""
+
+    def test_stream_info(self, stream_capture, stream_config, num_test_channels):
+        """The run starts with an INFO packet describing the stream."""
+        info = stream_capture.info
+        assert info is not None, "No INFO packet received"
+        assert info.version == PROTO_VERSION
+        assert info.num_ch >= num_test_channels
+        assert info.period_us == stream_config["period_us"]
+
+    def test_stream_sustained_rate(self, stream_capture, stream_config):
+        """Frames arrive at no less than the configured minimum rate."""
+        min_fps = stream_config["min_frames_per_s"]
+        rate = stream_capture.frames_per_s
+        print(f"\n  {len(stream_capture.recorder)} frames, {rate:.1f} frames/s delivered, "
+              f"{stream_capture.board_frames_per_s:.1f} frames/s by board time")
+
+        assert rate >= min_fps, f"Stream delivered {rate:.1f} frames/s, need {min_fps}"
+
+    def test_stream_no_sequence_gaps(self, stream_capture):
+        """Every frame from first to last arrives, none dropped on the board."""
+        rec = stream_capture.recorder
+        assert len(rec) > 0, "No frames received"
+        assert rec.gaps == 0, f"{rec.gaps} seq gaps, {rec.missing} frames missing"
+        assert stream_capture.dropped == 0, f"Board dropped {stream_capture.dropped} frames"
+
+    def test_stream_no_corruption(self, stream_capture):
+        """No packet fails its CRC."""
+        assert stream_capture.decoder.crc_errors == 0
+
+    def test_stream_timestamps_monotonic(self, stream_capture):
+        """Frame timestamps strictly increase."""
+        ts = stream_capture.recorder.timestamp_ns
+        steps = [b - a for a, b in zip(ts, ts[1:])]
+        assert steps, "Need at least two frames"
+        assert min(steps) > 0, "Timestamps must increase"
@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fake Sample Scheduler Implementation
+ */
+
+#include "fake_sample_sched.h"
+#include "sample_sched.h"
+#include <errno.h>
+
+struct fake_sample_sched fake_sched;
+
+void fake_sample_sched_reset(uint32_t period_us)
+{
+    fake_sched = (struct fake_sample_sched){ .period_us = period_us };
+}
+
+uint32_t sample_sched_period_us(void)
+{
+    return fake_sched.period_us;
+}
+
+int sample_sched_set_period(uint32_t period_us)
+{
+    if (period_us < SAMPLE_SCHED_MIN_PERIOD_US || period_us > SAMPLE_SCHED_MAX_PERIOD_US) {
+        return -EINVAL;
+    }
+
+    fake_sched.period_us = period_us;
+    fake_sched.set_calls++;
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Fake Sample Scheduler - records period changes for the unit tests
+ *
+ * Stands in for sample_sched.c, which needs a running timer backend.
+ */
+
+#ifndef FAKE_SAMPLE_SCHED_H_
+#define FAKE_SAMPLE_SCHED_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Record of the fake's calls
+ */
+struct fake_sample_sched {
+    uint32_t period_us;      /* Current period */
+    uint32_t set_calls;      /* sample_sched_set_period() calls accepted */
+};
+
+extern struct fake_sample_sched fake_sched;
+
+/**
+ * @brief Reset the fake to @p period_us with no calls recorded
+ *
+ * @param period_us Starting period
+ */
+void fake_sample_sched_reset(uint32_t period_us);
+
+#endif /* FAKE_SAMPLE_SCHED_H_ */
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the adaptive rate state machine (adaptive_rate.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "adaptive_rate.h"
+#include "fake_sample_sched.h"
+#include "regs.h"
+#include "sample_sched.h"
+
+#define FAST_US 1000
+#define SLOW_US (CONFIG_APP_ADAPTIVE_SLOW_PERIOD_MS * USEC_PER_MSEC)
+#define HOLD    CONFIG_APP_ADAPTIVE_HOLD_FRAMES
+#define DELTA   CONFIG_APP_ADAPTIVE_DELTA_MV
+
+/* Feed one frame with every channel at @p mv (scale is 1 mV per code) */
+static void feed(int32_t mv)
+{
+    struct adc_regs frame = {0};
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        frame.raw[ch] = (uint16_t)mv;
+    }
+    adaptive_rate_update(&frame);
+}
+
+/* Run the quiet frames it takes to drop to the slow rate */
+static void settle(int32_t mv)
+{
+    for (int i = 0; i < HOLD; i++) {
+        feed(mv);
+    }
+}
+
+/* Test fixture - Kconfig parameters, first frame at 1000 mV seen */
+static void adaptive_rate_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        regs_set_scale(ch, 4095, 12);
+    }
+    fake_sample_sched_reset(FAST_US);
+    adaptive_rate_init();
+    feed(1000);
+}
+
+/**
+ * @brief Test the fast rate held for hold_frames quiet frames, then slow
+ */
+ZTEST(adaptive_rate, test_hold_then_slow)
+{
+    zassert_true(adaptive_rate_is_fast(), "starts fast");
+    zassert_equal(fake_sched.period_us, FAST_US, "fast period");
+
+    for (int i = 0; i < HOLD - 1; i++) {
+        feed(1000);
+        zassert_true(adaptive_rate_is_fast(), "still holding after %d frames", i + 1);
+    }
+
+    feed(1000);
+    zassert_false(adaptive_rate_is_fast(), "slow after hold_frames");
+    zassert_equal(fake_sched.period_us, SLOW_US, "slow period");
+}
+
+/**
+ * @brief Test that a change of delta_mv restores the fast rate at once
+ */
+ZTEST(adaptive_rate, test_activity_fast)
+{
+    settle(1000);
+    zassert_equal(fake_sched.period_us, SLOW_US, "slow before the change");
+
+    feed(1000 + DELTA - 1);
+    zassert_false(adaptive_rate_is_fast(), "change below delta ignored");
+
+    feed(1000 + DELTA);
+    zassert_true(adaptive_rate_is_fast(), "change of delta is activity");
+    zassert_equal(fake_sched.period_us, FAST_US, "fast period restored");
+
+    /* Activity restarts the hold */
+    for (int i = 0; i < HOLD - 1; i++) {
+        feed(1000 + DELTA);
+    }
+    zassert_true(adaptive_rate_is_fast(), "hold restarted by the activity");
+}
+
+/**
+ * @brief Test that a slow drift counts once it adds up to delta_mv
+ */
+ZTEST(adaptive_rate, test_drift)
+{
+    int32_t mv = 1000;
+
+    settle(mv);
+
+    /* Steps below delta, measured from the last change, not the last frame */
+    while (!adaptive_rate_is_fast()) {
+        mv += DELTA / 4 + 1;
+        feed(mv);
+        zassert_true(mv <= 1000 + DELTA + DELTA / 4, "drift never detected");
+    }
+    zassert_true(mv >= 1000 + DELTA, "detected before the drift added up");
+}
+
+/**
+ * @brief Test that reconfiguring re-applies the fast period
+ *
+ * A slow switch from the processing stage can land after the configure
+ * call's own period change; the next frame must put fast_us back.
+ */
+ZTEST(adaptive_rate, test_configure_restarts_fast)
+{
+    struct adaptive_rate_config cfg;
+
+    settle(1000);
+    adaptive_rate_get(&cfg);
+    cfg.fast_us = 2000;
+
+    zassert_equal(adaptive_rate_configure(&cfg), 0, "configure");
+    zassert_equal(fake_sched.period_us, 2000, "fast period applied at once");
+
+    /* The racing slow switch */
+    zassert_equal(sample_sched_set_period(SLOW_US), 0, "slow switch");
+
+    feed(1000);
+    zassert_true(adaptive_rate_is_fast(), "restarted fast");
+    zassert_equal(fake_sched.period_us, 2000, "fast period re-applied");
+
+    /* The reference is taken again, so the hold restarts from here */
+    settle(1000);
+    zassert_false(adaptive_rate_is_fast(), "backs off after the hold");
+}
+
+/**
+ * @brief Test configuration validation and the disabled state
+ */
+ZTEST(adaptive_rate, test_configure)
+{
+    struct adaptive_rate_config cfg;
+
+    adaptive_rate_get(&cfg);
+    cfg.slow_us = cfg.fast_us - 1;
+    zassert_equal(adaptive_rate_configure(&cfg), -EINVAL, "slow below fast");
+
+    cfg.slow_us = SAMPLE_SCHED_MAX_PERIOD_US + 1;
+    zassert_equal(adaptive_rate_configure(&cfg), -EINVAL, "slow out of range");
+
+    adaptive_rate_get(&cfg);
+    zassert_equal(cfg.slow_us, SLOW_US, "rejected config not stored");
+
+    cfg.enabled = false;
+    zassert_equal(adaptive_rate_configure(&cfg), 0, "disable");
+    for (int i = 0; i < 2 * HOLD; i++) {
+        feed(1000);
+    }
+    zassert_equal(fake_sched.period_us, FAST_US, "disabled stays at fast_us");
+}
+
+ZTEST_SUITE(adaptive_rate, NULL, NULL, adaptive_rate_before, NULL, NULL);
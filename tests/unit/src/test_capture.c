@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the burst capture engine (capture.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "adc_backend.h"
+#include "regs.h"
+#include "capture.h"
+
+/* Fake backend: sample n of the burst is wave(n), up to burst_limit samples */
+static uint16_t (*wave)(uint32_t n);
+static uint32_t burst_limit;
+
+int adc_backend_burst(unsigned int ch, adc_backend_burst_cb cb, void *user_data)
+{
+    ARG_UNUSED(ch);
+
+    for (uint32_t n = 0; n < burst_limit; n++) {
+        if (!cb(wave(n), user_data)) {
+            return 0;
+        }
+    }
+
+    return -ETIMEDOUT;
+}
+
+static uint16_t ramp(uint32_t n)
+{
+    return (uint16_t)n;
+}
+
+/* 0, 10, ... 990 mV, then back to 0 every 100 samples */
+static uint16_t sawtooth(uint32_t n)
+{
+    return (uint16_t)((n % 100) * 10);
+}
+
+static void run_capture(const struct capture_config *cfg, uint16_t *out)
+{
+    struct capture_status st;
+
+    zassert_ok(capture_arm(cfg));
+    zassert_true(capture_run(), "an armed capture runs");
+
+    capture_get_status(&st);
+    zassert_equal(st.state, CAPTURE_DONE, "capture should be done");
+    zassert_ok(capture_lock());
+    zassert_equal(capture_read(0, out, cfg->samples), cfg->samples, "full capture read");
+    capture_unlock();
+}
+
+/* Test fixture - 1 mV per code on ch[0], no capture pending */
+static void capture_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    regs_set_scale(0, 4095, 12);
+    wave = ramp;
+    burst_limit = 100000;
+
+    capture_cancel();
+    (void)capture_run();
+}
+
+/**
+ * @brief Test an immediate trigger keeps the pre-trigger window in order
+ */
+ZTEST(capture, test_trigger_now)
+{
+    const struct capture_config cfg = {
+        .ch = 0, .trigger = CAPTURE_TRIG_NOW, .samples = 10, .pre_samples = 4,
+    };
+    struct capture_status st;
+    uint16_t out[10];
+
+    run_capture(&cfg, out);
+    for (int i = 0; i < 10; i++) {
+        zassert_equal(out[i], i, "sample %d out of order", i);
+    }
+
+    capture_get_status(&st);
+    zassert_equal(st.conversions, 10, "stops right after the post-trigger window");
+}
+
+/**
+ * @brief Test a rising edge lands at the trigger index after the ring wraps
+ */
+ZTEST(capture, test_trigger_rising)
+{
+    const struct capture_config cfg = {
+        .ch = 0, .trigger = CAPTURE_TRIG_RISING, .level_mv = 500,
+        .samples = 40, .pre_samples = 20,
+    };
+    uint16_t out[40];
+
+    wave = sawtooth;
+    run_capture(&cfg, out);
+    zassert_equal(out[19], 500, "last sample at the level before the trigger");
+    zassert_equal(out[20], 510, "first sample above the level is the trigger");
+    zassert_equal(out[0], 310, "pre-trigger window starts 20 samples earlier");
+    zassert_equal(out[39], 700, "post-trigger window ends 19 samples later");
+}
+
+/**
+ * @brief Test edges before the pre-trigger window is full are ignored
+ */
+ZTEST(capture, test_trigger_falling_waits_for_window)
+{
+    const struct capture_config cfg = {
+        .ch = 0, .trigger = CAPTURE_TRIG_FALLING, .level_mv = 500,
+        .samples = 150, .pre_samples = 120,
+    };
+    uint16_t out[150];
+
+    /* Falling edges at samples 100 and 200; only the second has 120 before it */
+    wave = sawtooth;
+    run_capture(&cfg, out);
+    zassert_equal(out[0], 800, "window starts at sample 80");
+    zassert_equal(out[119], 990, "top of the ramp before the edge");
+    zassert_equal(out[120], 0, "edge is the trigger sample");
+}
+
+/**
+ * @brief Test argument checks and the download pin
+ */
+ZTEST(capture, test_arm_busy)
+{
+    struct capture_config cfg = {
+        .ch = 0, .trigger = CAPTURE_TRIG_NOW, .samples = 8, .pre_samples = 2,
+    };
+    uint16_t out[8];
+
+    cfg.pre_samples = 8;
+    zassert_equal(capture_arm(&cfg), -EINVAL, "pre-trigger must be below samples");
+    cfg.pre_samples = 2;
+    cfg.samples = CONFIG_APP_CAPTURE_MAX_SAMPLES + 1;
+    zassert_equal(capture_arm(&cfg), -EINVAL, "larger than the buffer");
+    cfg.samples = 8;
+    cfg.ch = NUM_CH;
+    zassert_equal(capture_arm(&cfg), -EINVAL, "bad channel");
+    cfg.ch = 0;
+    cfg.trigger = CAPTURE_TRIG_ALARM;
+    zassert_equal(capture_arm(&cfg), -ENOTSUP, "alarm trigger needs a rule");
+    cfg.trigger = CAPTURE_TRIG_NOW;
+
+    zassert_ok(capture_arm(&cfg));
+    zassert_equal(capture_arm(&cfg), -EBUSY, "already armed");
+    zassert_equal(capture_lock(), -ENODATA, "nothing to read yet");
+    zassert_true(capture_run());
+
+    zassert_ok(capture_lock());
+    zassert_equal(capture_arm(&cfg), -EBUSY, "pinned by a download");
+    zassert_equal(capture_read(6, out, 8), 2, "read clipped to the end");
+    zassert_equal(out[1], 7, "last sample");
+    capture_unlock();
+    zassert_ok(capture_arm(&cfg), "re-arm after the download");
+}
+
+/**
+ * @brief Test a cancelled or failed burst leaves nothing to download
+ */
+ZTEST(capture, test_cancel_and_failure)
+{
+    const struct capture_config cfg = {
+        .ch = 0, .trigger = CAPTURE_TRIG_RISING, .level_mv = 5000,
+        .samples = 8, .pre_samples = 2,
+    };
+    struct capture_status st;
+
+    /* The level is never crossed, so the fake backend gives up */
+    burst_limit = 1000;
+    zassert_ok(capture_arm(&cfg));
+    zassert_true(capture_run());
+    capture_get_status(&st);
+    zassert_equal(st.state, CAPTURE_IDLE, "failed burst");
+
+    zassert_ok(capture_arm(&cfg));
+    capture_cancel();
+    zassert_true(capture_run());
+    capture_get_status(&st);
+    zassert_equal(st.state, CAPTURE_IDLE, "cancelled burst");
+    zassert_false(capture_run(), "nothing armed");
+}
+
+ZTEST_SUITE(capture, NULL, NULL, capture_before, NULL, NULL);
@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the per-channel statistics windows (chan_stats.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "regs.h"
+#include "chan_stats.h"
+
+static void feed(uint16_t v0, uint32_t mask)
+{
+    uint16_t raw[NUM_CH] = { 0 };
+
+    raw[0] = v0;
+    for (int i = 1; i < NUM_CH; i++) {
+        raw[i] = 100 * i;
+    }
+    chan_stats_update(raw, mask);
+}
+
+/* Test fixture - every window empty */
+static void chan_stats_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    chan_stats_init();
+}
+
+/**
+ * @brief Test min, max, mean and RMS of a known sequence
+ */
+ZTEST(chan_stats, test_aggregates)
+{
+    struct chan_stats_snapshot snap;
+    const uint16_t values[] = { 3, 4, 3, 4, 3, 4, 3, 4, 100, 0 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+        feed(values[i], BIT_MASK(NUM_CH));
+    }
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    zassert_equal(snap.ch[0].count, ARRAY_SIZE(values), "count");
+    zassert_equal(snap.ch[0].min, 0, "min");
+    zassert_equal(snap.ch[0].max, 100, "max");
+    /* Sum 128 over 10 samples */
+    zassert_equal(snap.ch[0].mean, 13, "mean rounds to nearest");
+    /* Sum of squares 10100 over 10 samples, sqrt(1010) = 31.78 */
+    zassert_equal(snap.ch[0].rms, 31, "rms rounds down");
+
+    if (NUM_CH > 1) {
+        zassert_equal(snap.ch[1].min, 100, "constant channel min");
+        zassert_equal(snap.ch[1].max, 100, "constant channel max");
+        zassert_equal(snap.ch[1].mean, 100, "constant channel mean");
+        zassert_equal(snap.ch[1].rms, 100, "constant channel rms");
+    }
+}
+
+/**
+ * @brief Test that reading resets only the window read
+ */
+ZTEST(chan_stats, test_reset_on_read)
+{
+    struct chan_stats_snapshot snap;
+
+    feed(1000, BIT_MASK(NUM_CH));
+    feed(2000, BIT_MASK(NUM_CH));
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, false);
+    zassert_equal(snap.ch[0].count, 2, "peek sees the window");
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    zassert_equal(snap.ch[0].count, 2, "read sees the same window");
+    zassert_equal(snap.ch[0].mean, 1500, "mean");
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    zassert_equal(snap.ch[0].count, 0, "read started a new window");
+    zassert_equal(snap.ch[0].min, 0, "empty window reports zeros");
+    zassert_equal(snap.ch[0].max, 0, "empty window reports zeros");
+
+    chan_stats_read(CHAN_STATS_STREAM, &snap, true);
+    zassert_equal(snap.ch[0].count, 2, "other windows keep running");
+    zassert_equal(snap.ch[0].max, 2000, "stream window max");
+}
+
+/**
+ * @brief Test that channels outside the mask are not counted
+ */
+ZTEST(chan_stats, test_mask)
+{
+    struct chan_stats_snapshot snap;
+
+    feed(10, BIT(0));
+    feed(20, BIT(0));
+    feed(99, 0);
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    zassert_equal(snap.ch[0].count, 2, "masked-out frame not counted");
+    zassert_equal(snap.ch[0].max, 20, "masked-out value not seen");
+    if (NUM_CH > 1) {
+        zassert_equal(snap.ch[1].count, 0, "channel not in the mask");
+    }
+}
+
+/**
+ * @brief Test full-scale 16-bit codes over many samples
+ */
+ZTEST(chan_stats, test_full_scale)
+{
+    struct chan_stats_snapshot snap;
+
+    for (int i = 0; i < 100000; i++) {
+        feed(UINT16_MAX, BIT(0));
+    }
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    zassert_equal(snap.ch[0].count, 100000, "count");
+    zassert_equal(snap.ch[0].mean, UINT16_MAX, "mean");
+    zassert_equal(snap.ch[0].rms, UINT16_MAX, "rms");
+}
+
+ZTEST_SUITE(chan_stats, NULL, NULL, chan_stats_before, NULL, NULL);
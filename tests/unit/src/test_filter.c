@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the filter stage (filter.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "regs.h"
+#include "filter.h"
+
+static void fill(uint16_t frame[NUM_CH], uint16_t value)
+{
+    for (int i = 0; i < NUM_CH; i++) {
+        frame[i] = value;
+    }
+}
+
+/* Feed @p count frames of @p value and return how many were published */
+static int feed(uint16_t value, int count, uint16_t out[NUM_CH])
+{
+    uint16_t in[NUM_CH];
+    int published = 0;
+
+    fill(in, value);
+    for (int i = 0; i < count; i++) {
+        if (filter_process(in, out)) {
+            published++;
+        }
+    }
+
+    return published;
+}
+
+/* Test fixture - default 12-bit scale on every channel */
+static void filter_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+}
+
+/**
+ * @brief Test argument validation
+ */
+ZTEST(filter, test_configure_invalid)
+{
+    zassert_equal(filter_configure(FILTER_BOXCAR, 0, 0), -EINVAL, "decimation 0");
+    zassert_equal(filter_configure(FILTER_BOXCAR, 1001, 0), -EINVAL, "decimation too large");
+    zassert_equal(filter_configure(FILTER_FIR, 1, 7), -EINVAL, "odd tap count");
+    zassert_equal(filter_configure(FILTER_FIR, 1, FILTER_FIR_MAX_TAPS + 2), -EINVAL,
+                  "too many taps");
+    zassert_equal(filter_configure(FILTER_IIR, 1, 0), -EINVAL, "IIR shift 0");
+    zassert_ok(filter_configure(FILTER_FIR, 4, 16), "valid FIR");
+    zassert_equal(filter_decimation(), 4, "decimation should be stored");
+}
+
+/**
+ * @brief Test pass-through is lossless at 12 bits
+ */
+ZTEST(filter, test_none_passthrough)
+{
+    uint16_t in[NUM_CH], out[NUM_CH];
+
+    zassert_ok(filter_configure(FILTER_NONE, 1, 0));
+
+    for (uint16_t code = 0; code <= 4095; code += 195) {
+        fill(in, code);
+        zassert_true(filter_process(in, out), "every frame published");
+        zassert_equal(out[0], code, "code %u should round-trip", code);
+    }
+}
+
+/**
+ * @brief Test decimation publishes one frame per block
+ */
+ZTEST(filter, test_decimation)
+{
+    uint16_t out[NUM_CH];
+
+    zassert_ok(filter_configure(FILTER_BOXCAR, 5, 0));
+    zassert_equal(feed(1000, 23, out), 4, "23 inputs at D=5 give 4 outputs");
+    zassert_equal(feed(1000, 2, out), 1, "block completes on the 25th input");
+}
+
+/**
+ * @brief Test boxcar publishes the block mean
+ */
+ZTEST(filter, test_boxcar_mean)
+{
+    uint16_t in[NUM_CH], out[NUM_CH];
+    const uint16_t block[] = {100, 200, 300, 400};
+
+    zassert_ok(filter_configure(FILTER_BOXCAR, ARRAY_SIZE(block), 0));
+
+    for (size_t i = 0; i < ARRAY_SIZE(block); i++) {
+        fill(in, block[i]);
+        zassert_equal(filter_process(in, out), i == ARRAY_SIZE(block) - 1,
+                      "publish only at end of block");
+    }
+
+    for (int ch = 0; ch < NUM_CH; ch++) {
+        zassert_equal(out[ch], 250, "ch[%d] should be the block mean", ch);
+    }
+}
+
+/**
+ * @brief Test FIR has unity DC gain and settles within its length
+ */
+ZTEST(filter, test_fir_step)
+{
+    uint16_t out[NUM_CH];
+    uint16_t prev;
+
+    zassert_ok(filter_configure(FILTER_FIR, 1, 16));
+
+    /* Primed from the first frame: a constant input is reproduced exactly */
+    feed(4000, 1, out);
+    zassert_equal(out[0], 4000, "DC input should pass unchanged");
+    feed(4000, 20, out);
+    zassert_equal(out[0], 4000, "DC gain should be unity");
+
+    /* Step down: output falls monotonically and settles after 16 inputs */
+    prev = out[0];
+    for (int i = 0; i < 16; i++) {
+        feed(1000, 1, out);
+        zassert_true(out[0] <= prev, "step response should be monotonic");
+        zassert_true(out[0] >= 1000, "step response should not undershoot");
+        prev = out[0];
+    }
+    zassert_equal(out[0], 1000, "settled after the filter length");
+}
+
+/**
+ * @brief Test IIR converges to a constant input
+ */
+ZTEST(filter, test_iir_converges)
+{
+    uint16_t out[NUM_CH];
+
+    zassert_ok(filter_configure(FILTER_IIR, 1, 2));
+
+    feed(2000, 1, out);
+    zassert_equal(out[0], 2000, "state seeded from the first frame");
+
+    feed(3000, 1, out);
+    zassert_equal(out[0], 2250, "one step covers 1/4 of the change");
+
+    feed(3000, 100, out);
+    zassert_within(out[0], 3000, 1, "should converge to the input");
+}
+
+/**
+ * @brief Test channel resolution is honoured
+ */
+ZTEST(filter, test_resolution)
+{
+    uint16_t out[NUM_CH];
+
+    regs_set_scale(0, 3300, 16);
+    zassert_ok(filter_configure(FILTER_BOXCAR, 2, 0));
+
+    feed(65535, 2, out);
+    zassert_equal(out[0], 65535, "16-bit full scale must not wrap");
+    zassert_true(out[1] <= 4095, "12-bit channel stays in range");
+}
+
+/**
+ * @brief Test rescaling keeps the filter but follows the new resolution
+ */
+ZTEST(filter, test_rescale)
+{
+    uint16_t out[NUM_CH];
+
+    zassert_ok(filter_configure(FILTER_BOXCAR, 2, 0));
+    regs_set_scale(0, 3300, 10);
+    filter_rescale();
+
+    zassert_equal(filter_decimation(), 2, "decimation kept");
+    feed(1023, 2, out);
+    zassert_equal(out[0], 1023, "10-bit full scale after rescale");
+}
+
+ZTEST_SUITE(filter, NULL, NULL, filter_before, NULL, NULL);
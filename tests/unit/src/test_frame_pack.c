@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the frame packing helpers (frame_pack.c)
+ *
+ * The byte vectors here are the format reference shared with
+ * tools/adc_stream.py; keep both in step.
+ */
+
+#include <zephyr/ztest.h>
+#include <errno.h>
+#include "frame_pack.h"
+
+/**
+ * @brief Test the 12-bit layout, including an odd trailing code
+ */
+ZTEST(frame_pack, test_pack12)
+{
+    static const uint16_t raw[3] = { 0x123, 0x456, 0x789 };
+    static const uint8_t packed[] = { 0x23, 0x61, 0x45, 0x89, 0x07 };
+    uint8_t out[FRAME_PACKED_SIZE(3, true)];
+    uint16_t back[3];
+
+    zassert_equal(sizeof(out), sizeof(packed), "size of 3 codes");
+
+    frame_pack(raw, 3, true, out);
+    zassert_mem_equal(out, packed, sizeof(packed), "layout");
+
+    frame_unpack(out, 3, true, back);
+    zassert_mem_equal(back, raw, sizeof(raw), "round trip");
+}
+
+/**
+ * @brief Test that codes wider than 12 bits are clamped when packing
+ */
+ZTEST(frame_pack, test_pack12_clamp)
+{
+    static const uint16_t raw[2] = { FRAME_PACK12_MAX, 5000 };
+    uint8_t out[FRAME_PACKED_SIZE(2, true)];
+    uint16_t back[2];
+
+    frame_pack(raw, 2, true, out);
+    frame_unpack(out, 2, true, back);
+    zassert_equal(back[0], FRAME_PACK12_MAX, "4095 is kept");
+    zassert_equal(back[1], FRAME_PACK12_MAX, "large clamps to 4095");
+}
+
+/**
+ * @brief Test the 16-bit layout
+ */
+ZTEST(frame_pack, test_pack16)
+{
+    static const uint16_t raw[2] = { 0x1234, 0xFFFF };
+    static const uint8_t packed[] = { 0x34, 0x12, 0xFF, 0xFF };
+    uint8_t out[FRAME_PACKED_SIZE(2, false)];
+    uint16_t back[2];
+
+    frame_pack(raw, 2, false, out);
+    zassert_mem_equal(out, packed, sizeof(packed), "little-endian");
+
+    frame_unpack(out, 2, false, back);
+    zassert_mem_equal(back, raw, sizeof(raw), "round trip");
+}
+
+/**
+ * @brief Test varint and zigzag encodings against fixed vectors
+ */
+ZTEST(frame_pack, test_varint)
+{
+    uint8_t buf[FRAME_VARINT_MAX_SIZE];
+    uint64_t v;
+
+    zassert_equal(frame_varint_put(0, buf), 1, "0");
+    zassert_equal(buf[0], 0x00, "0 bytes");
+    zassert_equal(frame_varint_put(127, buf), 1, "127");
+    zassert_equal(buf[0], 0x7F, "127 bytes");
+    zassert_equal(frame_varint_put(300, buf), 2, "300");
+    zassert_equal(buf[0], 0xAC, "300 low");
+    zassert_equal(buf[1], 0x02, "300 high");
+
+    zassert_equal(frame_varint_put(UINT64_MAX, buf), FRAME_VARINT_MAX_SIZE, "max");
+    zassert_equal(frame_varint_get(buf, sizeof(buf), &v), FRAME_VARINT_MAX_SIZE, "get max");
+    zassert_equal(v, UINT64_MAX, "max round trip");
+    zassert_equal(frame_varint_get(buf, 3, &v), -EINVAL, "truncated");
+
+    zassert_equal(frame_zigzag(0), 0, "zigzag 0");
+    zassert_equal(frame_zigzag(-1), 1, "zigzag -1");
+    zassert_equal(frame_zigzag(1), 2, "zigzag 1");
+    zassert_equal(frame_zigzag(-2), 3, "zigzag -2");
+    zassert_equal(frame_unzigzag(frame_zigzag(INT64_MIN)), INT64_MIN, "zigzag min");
+    zassert_equal(frame_unzigzag(frame_zigzag(-65535)), -65535, "zigzag -65535");
+}
+
+/**
+ * @brief Test delta coding: sizes, round trip and its limits
+ */
+ZTEST(frame_pack, test_delta)
+{
+    static const uint16_t prev[4] = { 100, 100, 100, 0 };
+    static const uint16_t raw[4] = { 100, 99, 163, 65535 };
+    /* 0 -> 0, -1 -> 1, +63 -> 126, +65535 -> 131070 */
+    static const uint8_t coded[] = { 0x00, 0x01, 0x7E, 0xFE, 0xFF, 0x07 };
+    uint8_t out[FRAME_DELTA_MAX_SIZE(4)];
+    uint16_t back[4];
+
+    zassert_equal(frame_delta_encode(raw, prev, 4, out, sizeof(out)), sizeof(coded), "size");
+    zassert_mem_equal(out, coded, sizeof(coded), "layout");
+    zassert_equal(frame_delta_encode(raw, prev, 4, out, sizeof(coded) - 1), 0,
+                  "does not fit");
+
+    zassert_equal(frame_delta_decode(coded, sizeof(coded), prev, 4, back), sizeof(coded),
+                  "decode");
+    zassert_mem_equal(back, raw, sizeof(raw), "round trip");
+
+    zassert_equal(frame_delta_decode(coded, sizeof(coded) - 1, prev, 4, back), -EINVAL,
+                  "truncated");
+
+    /* -1 applied to a code of 0 */
+    zassert_equal(frame_delta_decode(&coded[1], 1, &prev[3], 1, back), -EINVAL,
+                  "below 0");
+}
+
+ZTEST_SUITE(frame_pack, NULL, NULL, NULL, NULL, NULL);
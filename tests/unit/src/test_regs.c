@@ -5,8 +5,10 @@
  */
 
 #include <zephyr/ztest.h>
+#include <zephyr/irq_offload.h>
 #include <string.h>
 #include "regs.h"
+#include "sample_ring.h"
 
 /* Test fixture - runs before each test */
 static void regs_before(void *fixture)
@@ -29,7 +31,7 @@ ZTEST(regs, test_init)
     zassert_equal(snapshot.last_sample_uptime_ms, 0, "timestamp should be 0 after init");
 
     for (int i = 0; i < NUM_CH; i++) {
-        zassert_equal(snapshot.mv[i], 0, "ch[%d] should be 0 after init", i);
+        zassert_equal(snapshot.raw[i], 0, "ch[%d] should be 0 after init", i);
     }
 }
 
@@ -39,7 +41,7 @@ ZTEST(regs, test_init)
 ZTEST(regs, test_update_read)
 {
     struct adc_regs snapshot;
-    int32_t test_values[NUM_CH] = {1000, 2000, 3000, 4000};
+    uint16_t test_values[NUM_CH] = {1000, 2000, 3000, 4000};
 
     /* Update with test values */
     regs_update(test_values);
@@ -52,7 +54,7 @@ ZTEST(regs, test_update_read)
     zassert_true(snapshot.last_sample_uptime_ms > 0, "timestamp should be set");
 
     for (int i = 0; i < NUM_CH; i++) {
-        zassert_equal(snapshot.mv[i], test_values[i],
+        zassert_equal(snapshot.raw[i], test_values[i],
                       "ch[%d] should match input value", i);
     }
 }
@@ -63,7 +65,7 @@ ZTEST(regs, test_update_read)
 ZTEST(regs, test_seq_increment)
 {
     struct adc_regs snapshot;
-    int32_t values[NUM_CH] = {0};
+    uint16_t values[NUM_CH] = {0};
 
     /* Update multiple times */
     for (uint32_t expected_seq = 1; expected_seq <= 5; expected_seq++) {
@@ -80,18 +82,246 @@ ZTEST(regs, test_seq_increment)
 ZTEST(regs, test_multiple_updates)
 {
     struct adc_regs snapshot;
-    int32_t values1[NUM_CH] = {100, 200, 300, 400};
-    int32_t values2[NUM_CH] = {500, 600, 700, 800};
+    uint16_t values1[NUM_CH] = {100, 200, 300, 400};
+    uint16_t values2[NUM_CH] = {500, 600, 700, 800};
 
     regs_update(values1);
     regs_read(&snapshot);
-    zassert_equal(snapshot.mv[0], 100, "First update should set ch[0]=100");
+    zassert_equal(snapshot.raw[0], 100, "First update should set ch[0]=100");
 
     regs_update(values2);
     regs_read(&snapshot);
-    zassert_equal(snapshot.mv[0], 500, "Second update should overwrite ch[0]=500");
+    zassert_equal(snapshot.raw[0], 500, "Second update should overwrite ch[0]=500");
     zassert_equal(snapshot.seq, 2, "seq should be 2 after two updates");
 }
 
+/**
+ * @brief Test frame timestamps from the frame clock and from the caller
+ */
+ZTEST(regs, test_timestamp)
+{
+    struct adc_regs snapshot;
+    uint16_t values[NUM_CH] = {0};
+    struct regs_stamp stamp = {
+        .timestamp_ns = 0x123456789ULL,
+        .synced = true,
+        .sampled = BIT(0),
+        .ch_offset_ns = NULL,
+    };
+    uint64_t before, after;
+
+    before = regs_clock_ns();
+    regs_update(values);
+    after = regs_clock_ns();
+    regs_read(&snapshot);
+    zassert_true(snapshot.timestamp_ns >= before && snapshot.timestamp_ns <= after,
+                 "regs_update() stamps the frame with the clock");
+    zassert_false(snapshot.synced, "regs_update() frames are local time");
+    zassert_equal(snapshot.sampled, BIT_MASK(NUM_CH), "regs_update() refreshes every channel");
+
+    regs_update_at(values, &stamp);
+    regs_read(&snapshot);
+    zassert_equal(snapshot.timestamp_ns, 0x123456789ULL, "caller's frame start is kept");
+    zassert_true(snapshot.synced, "caller's timebase is kept");
+    zassert_equal(snapshot.sampled, BIT(0), "caller's sampled mask is kept");
+    zassert_true(regs_clock_ns() >= after, "clock is monotonic");
+}
+
+/**
+ * @brief Test deferred raw-to-millivolt conversion
+ */
+ZTEST(regs, test_raw_to_mv)
+{
+    /* Default scale: 3300 mV over 12 bits */
+    zassert_equal(regs_raw_to_mv(0, 0), 0, "zero code");
+    zassert_equal(regs_raw_to_mv(0, 4095), 3300, "full scale code");
+    zassert_equal(regs_raw_to_mv(0, 2048), 1650, "mid scale code");
+
+    regs_set_scale(1, 2500, 16);
+    zassert_equal(regs_raw_to_mv(1, 65535), 2500, "16-bit full scale");
+    zassert_equal(regs_raw_to_mv(1, 26214), 1000, "16-bit 1 V");
+    zassert_equal(regs_raw_to_mv(0, 4095), 3300, "other channels unchanged");
+
+    /* Out-of-range resolutions leave the scale untouched */
+    regs_set_scale(1, 3300, 0);
+    regs_set_scale(1, 3300, 17);
+    regs_set_scale(1, 3300, 200);
+    zassert_equal(regs_raw_to_mv(1, 65535), 2500, "invalid resolution ignored");
+}
+
+static void update_from_isr(const void *param)
+{
+    regs_update((const uint16_t *)param);
+}
+
+/**
+ * @brief Test that the writer can publish from interrupt context
+ */
+ZTEST(regs, test_update_from_isr)
+{
+    struct adc_regs snapshot;
+    uint16_t values[NUM_CH] = {1234, 2345, 3210, 42};
+
+    irq_offload(update_from_isr, values);
+
+    regs_read(&snapshot);
+    zassert_equal(snapshot.seq, 1, "ISR update should increment seq");
+    for (int i = 0; i < NUM_CH; i++) {
+        zassert_equal(snapshot.raw[i], values[i],
+                      "ch[%d] should match value written from ISR", i);
+    }
+}
+
+/**
+ * @brief Test batched read of every frame newer than a sequence number
+ */
+ZTEST(regs, test_read_batch)
+{
+    struct adc_regs batch[8];
+    uint16_t values[NUM_CH] = {0};
+    size_t n;
+
+    zassert_equal(regs_read_batch(0, batch, ARRAY_SIZE(batch)), 0,
+                  "nothing pending after init");
+
+    for (int i = 1; i <= 5; i++) {
+        values[0] = i * 10;
+        regs_update(values);
+    }
+
+    n = regs_read_batch(0, batch, ARRAY_SIZE(batch));
+    zassert_equal(n, 5, "all five frames should be returned");
+    for (size_t i = 0; i < n; i++) {
+        zassert_equal(batch[i].seq, i + 1, "frames should be oldest first");
+        zassert_equal(batch[i].raw[0], (i + 1) * 10, "frame %zu value", i);
+    }
+
+    n = regs_read_batch(3, batch, ARRAY_SIZE(batch));
+    zassert_equal(n, 2, "only frames after seq 3");
+    zassert_equal(batch[0].seq, 4, "first frame after seq 3");
+
+    zassert_equal(regs_read_batch(5, batch, ARRAY_SIZE(batch)), 0,
+                  "caught up at head");
+
+    n = regs_read_batch(0, batch, 2);
+    zassert_equal(n, 2, "limited by max");
+    zassert_equal(batch[1].seq, 2, "oldest frames first when limited");
+}
+
+/**
+ * @brief Test batched read after falling behind the ring's history
+ */
+ZTEST(regs, test_read_batch_stale)
+{
+    static struct adc_regs batch[SAMPLE_RING_DEPTH];
+    uint16_t values[NUM_CH] = {0};
+    uint32_t head = SAMPLE_RING_DEPTH + 10;
+    size_t n;
+
+    for (uint32_t i = 0; i < head; i++) {
+        regs_update(values);
+    }
+
+    n = regs_read_batch(0, batch, ARRAY_SIZE(batch));
+    zassert_equal(n, SAMPLE_RING_DEPTH - 1, "only ring history is returned");
+    zassert_equal(batch[0].seq, head - n + 1, "gap is visible in first seq");
+    zassert_equal(batch[n - 1].seq, head, "newest frame last");
+}
+
+/**
+ * @brief Test borrowing the newest frame in place
+ */
+ZTEST(regs, test_borrow)
+{
+    uint16_t values[NUM_CH] = {0};
+    struct regs_borrow b;
+    const struct adc_regs *frame;
+
+    values[NUM_CH - 1] = 1234;
+    regs_update(values);
+    regs_update(values);
+
+    frame = regs_acquire(&b);
+    zassert_equal(frame, b.frame, "returns the borrowed frame");
+    zassert_equal(frame->seq, 2, "newest frame");
+    zassert_equal(b.seq, 2, "borrow records seq");
+    zassert_equal(frame->raw[NUM_CH - 1], 1234, "values in place");
+
+    zassert_true(regs_release(&b), "no update during the borrow");
+
+    regs_update(values);
+    zassert_false(regs_release(&b), "the next update rewrites the copy");
+}
+
+/**
+ * @brief Test that a borrow outlived by many updates is reported
+ */
+ZTEST(regs, test_borrow_lapped)
+{
+    uint16_t values[NUM_CH] = {0};
+    struct regs_borrow b;
+
+    regs_acquire(&b);
+    for (int i = 0; i < SAMPLE_RING_DEPTH; i++) {
+        regs_update(values);
+    }
+
+    zassert_false(regs_release(&b), "copy was rewritten");
+}
+
+/**
+ * @brief Test the single-channel getter
+ */
+ZTEST(regs, test_get_raw)
+{
+    uint16_t values[NUM_CH] = {0};
+    uint32_t seq;
+
+    for (int i = 0; i < NUM_CH; i++) {
+        values[i] = 100 + i;
+    }
+    regs_update(values);
+
+    for (int i = 0; i < NUM_CH; i++) {
+        zassert_equal(regs_get_raw(i, &seq), 100 + i, "channel %d", i);
+        zassert_equal(seq, 1, "seq of the frame");
+    }
+    zassert_equal(regs_get_raw(NUM_CH, NULL), 0, "invalid channel");
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/**
+ * @brief Test conversion times turned into frame offsets
+ */
+ZTEST(regs, test_channel_offsets)
+{
+    const uint64_t start = 1000000000ULL;
+    uint64_t conv[NUM_CH];
+    uint32_t offset[NUM_CH];
+
+    for (int i = 0; i < NUM_CH; i++) {
+        switch (i % 3) {
+        case 0:
+            conv[i] = start + 1000 * (i + 1);  /* Converted in this frame */
+            break;
+        case 1:
+            conv[i] = start - 1;               /* Not converted since the start */
+            break;
+        default:
+            conv[i] = start + (1ULL << 33);    /* Beyond the 32-bit offset */
+            break;
+        }
+    }
+
+    regs_channel_offsets(conv, start, offset);
+
+    for (int i = 0; i < NUM_CH; i++) {
+        uint32_t expect = (i % 3 == 0) ? 1000 * (i + 1) : (i % 3 == 1) ? 0 : UINT32_MAX;
+
+        zassert_equal(offset[i], expect, "ch[%d] offset", i);
+    }
+}
+#endif
+
 ZTEST_SUITE(regs, NULL, NULL, regs_before, NULL, NULL);
 
@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the processing stage (sample_proc.c)
+ *
+ * Built without CONFIG_APP_SAMPLE_PROC_THREAD, so sample_proc_notify()
+ * drains the ring before it returns.
+ */
+
+#include <zephyr/ztest.h>
+#include "regs.h"
+#include "sample_ring.h"
+#include "sample_proc.h"
+#include "chan_stats.h"
+#include "fake_sample_sched.h"
+
+/* Usable history per reader (see sample_ring.c) */
+#define RING_HISTORY (SAMPLE_RING_DEPTH - 1)
+
+static void push_frames(int count)
+{
+    uint16_t values[NUM_CH] = {0};
+
+    for (int i = 0; i < count; i++) {
+        values[0] = 100 + i;
+        regs_update(values);
+    }
+}
+
+/* Channel 0 samples in the shell's statistics window, which is then reset */
+static uint32_t stats_count(void)
+{
+    struct chan_stats_snapshot snap;
+
+    chan_stats_read(CHAN_STATS_SHELL, &snap, true);
+    return snap.ch[0].count;
+}
+
+/* Test fixture - empty ring, statistics and counters clear */
+static void sample_proc_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    chan_stats_init();
+    fake_sample_sched_reset(CONFIG_APP_SAMPLE_PERIOD_MS * USEC_PER_MSEC);
+    sample_proc_init();
+}
+
+/**
+ * @brief Test that every published frame reaches the consumers once
+ */
+ZTEST(sample_proc, test_drain)
+{
+    struct sample_proc_status st;
+
+    push_frames(10);
+    sample_proc_notify();
+
+    sample_proc_get_status(&st);
+    zassert_equal(st.frames, 10, "frames processed");
+    zassert_equal(st.dropped, 0, "nothing skipped");
+    zassert_equal(stats_count(), 10, "frames fed to the statistics");
+
+    /* Batches of the stage's reads do not lose the remainder */
+    push_frames(7);
+    sample_proc_notify();
+    sample_proc_notify();
+
+    sample_proc_get_status(&st);
+    zassert_equal(st.frames, 17, "second burst processed once");
+    zassert_equal(stats_count(), 7, "second burst fed once");
+}
+
+/**
+ * @brief Test that the stage starts at the newest frame
+ */
+ZTEST(sample_proc, test_starts_at_newest)
+{
+    struct sample_proc_status st;
+
+    push_frames(5);
+    sample_proc_init();
+    sample_proc_notify();
+
+    sample_proc_get_status(&st);
+    zassert_equal(st.frames, 0, "frames before init not processed");
+    zassert_equal(st.dropped, 0, "and not counted as skipped");
+}
+
+/**
+ * @brief Test that a stage lagging past the ring skips and counts frames
+ */
+ZTEST(sample_proc, test_fell_behind)
+{
+    struct sample_proc_status st;
+    int pushed = SAMPLE_RING_DEPTH + 10;
+
+    push_frames(pushed);
+    sample_proc_notify();
+
+    sample_proc_get_status(&st);
+    zassert_equal(st.frames, RING_HISTORY, "the ring's history processed");
+    zassert_equal(st.dropped, pushed - RING_HISTORY, "overwritten frames counted");
+    zassert_equal(st.frames + st.dropped, pushed, "every frame accounted for");
+    zassert_equal(stats_count(), RING_HISTORY, "only processed frames fed");
+
+    /* Caught up: no further skips */
+    push_frames(3);
+    sample_proc_notify();
+
+    sample_proc_get_status(&st);
+    zassert_equal(st.frames, RING_HISTORY + 3, "processing resumes");
+    zassert_equal(st.dropped, pushed - RING_HISTORY, "skip count unchanged");
+}
+
+ZTEST_SUITE(sample_proc, NULL, NULL, sample_proc_before, NULL, NULL);
@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the sample ring (sample_ring.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "regs.h"
+#include "sample_ring.h"
+
+/* Usable history per reader (see sample_ring.c) */
+#define RING_HISTORY (SAMPLE_RING_DEPTH - 1)
+
+static struct adc_regs frames[SAMPLE_RING_DEPTH];
+
+static void push_frames(int count, uint16_t first_value)
+{
+    uint16_t values[NUM_CH] = {0};
+
+    for (int i = 0; i < count; i++) {
+        values[0] = first_value + i;
+        regs_update(values);
+    }
+}
+
+/* Test fixture - runs before each test */
+static void sample_ring_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+}
+
+/**
+ * @brief Test that a new reader starts empty
+ */
+ZTEST(sample_ring, test_empty)
+{
+    struct sample_ring_reader rd;
+
+    sample_ring_reader_init(&rd);
+
+    zassert_equal(sample_ring_head(), 0, "head should be 0 after init");
+    zassert_equal(sample_ring_read(&rd, frames, ARRAY_SIZE(frames)), 0,
+                  "no frames should be pending");
+}
+
+/**
+ * @brief Test that frames come back in order with their seq numbers
+ */
+ZTEST(sample_ring, test_read_in_order)
+{
+    struct sample_ring_reader rd;
+    size_t n;
+
+    sample_ring_reader_init(&rd);
+    push_frames(5, 100);
+
+    n = sample_ring_read(&rd, frames, ARRAY_SIZE(frames));
+    zassert_equal(n, 5, "should read 5 frames, got %u", (unsigned int)n);
+
+    for (size_t i = 0; i < n; i++) {
+        zassert_equal(frames[i].seq, i + 1, "frame %u has wrong seq", (unsigned int)i);
+        zassert_equal(frames[i].raw[0], 100 + i,
+                      "frame %u has wrong value", (unsigned int)i);
+    }
+
+    zassert_equal(rd.dropped, 0, "nothing should be dropped");
+    zassert_equal(sample_ring_read(&rd, frames, ARRAY_SIZE(frames)), 0,
+                  "reader should be caught up");
+}
+
+/**
+ * @brief Test draining in batches smaller than the backlog
+ */
+ZTEST(sample_ring, test_partial_batches)
+{
+    struct sample_ring_reader rd;
+
+    sample_ring_reader_init(&rd);
+    push_frames(7, 0);
+
+    zassert_equal(sample_ring_read(&rd, frames, 3), 3, "first batch");
+    zassert_equal(frames[2].seq, 3, "first batch should end at seq 3");
+    zassert_equal(sample_ring_read(&rd, frames, 3), 3, "second batch");
+    zassert_equal(frames[0].seq, 4, "second batch should start at seq 4");
+    zassert_equal(sample_ring_read(&rd, frames, 3), 1, "last batch");
+    zassert_equal(frames[0].seq, 7, "last batch should be seq 7");
+}
+
+/**
+ * @brief Test that a lagging reader skips to the oldest valid frame
+ */
+ZTEST(sample_ring, test_overrun_counts_dropped)
+{
+    struct sample_ring_reader rd;
+    int pushed = SAMPLE_RING_DEPTH + 10;
+    size_t n;
+
+    sample_ring_reader_init(&rd);
+    push_frames(pushed, 0);
+
+    n = sample_ring_read(&rd, frames, ARRAY_SIZE(frames));
+    zassert_equal(n, RING_HISTORY, "should read the usable history");
+    zassert_equal(rd.dropped, pushed - RING_HISTORY, "dropped count");
+    zassert_equal(frames[0].seq, pushed - RING_HISTORY + 1, "oldest seq");
+    zassert_equal(frames[n - 1].seq, pushed, "newest seq");
+}
+
+/**
+ * @brief Test that readers keep independent cursors
+ */
+ZTEST(sample_ring, test_independent_readers)
+{
+    struct sample_ring_reader fast;
+    struct sample_ring_reader slow;
+
+    sample_ring_reader_init(&fast);
+    sample_ring_reader_init(&slow);
+
+    push_frames(4, 0);
+    zassert_equal(sample_ring_read(&fast, frames, ARRAY_SIZE(frames)), 4, "fast");
+
+    push_frames(2, 0);
+    zassert_equal(sample_ring_read(&fast, frames, ARRAY_SIZE(frames)), 2, "fast again");
+    zassert_equal(sample_ring_read(&slow, frames, ARRAY_SIZE(frames)), 6,
+                  "slow reader should still see every frame");
+}
+
+/**
+ * @brief Test that a reader only sees frames pushed after it was created
+ */
+ZTEST(sample_ring, test_reader_starts_at_head)
+{
+    struct sample_ring_reader rd;
+
+    push_frames(3, 0);
+    sample_ring_reader_init(&rd);
+    push_frames(1, 50);
+
+    zassert_equal(sample_ring_read(&rd, frames, ARRAY_SIZE(frames)), 1, "one new frame");
+    zassert_equal(frames[0].seq, 4, "new frame seq");
+    zassert_equal(frames[0].raw[0], 50, "new frame value");
+}
+
+/**
+ * @brief Test in-place peek/consume walks frames like sample_ring_read()
+ */
+ZTEST(sample_ring, test_peek_consume)
+{
+    struct sample_ring_reader rd;
+    const struct sample_ring_slot *frame;
+    struct adc_regs unpacked;
+
+    sample_ring_reader_init(&rd);
+    zassert_is_null(sample_ring_peek(&rd), "nothing pending");
+
+    push_frames(3, 10);
+    for (uint32_t seq = 1; seq <= 3; seq++) {
+        frame = sample_ring_peek(&rd);
+        zassert_not_null(frame, "frame %u pending", seq);
+        zassert_equal(frame->seq, seq, "in order");
+        sample_ring_unpack(frame, &unpacked);
+        zassert_equal(unpacked.raw[0], 10 + seq - 1, "value in place");
+        zassert_equal(sample_ring_peek(&rd), frame, "peek does not advance");
+        zassert_true(sample_ring_consume(&rd), "frame intact");
+    }
+
+    zassert_is_null(sample_ring_peek(&rd), "caught up");
+}
+
+/**
+ * @brief Test that a frame lapped while borrowed is rejected and counted
+ */
+ZTEST(sample_ring, test_peek_lapped)
+{
+    struct sample_ring_reader rd;
+    const struct sample_ring_slot *frame;
+
+    sample_ring_reader_init(&rd);
+    push_frames(1, 0);
+
+    frame = sample_ring_peek(&rd);
+    zassert_equal(frame->seq, 1, "first frame");
+
+    push_frames(SAMPLE_RING_DEPTH, 0);
+    zassert_false(sample_ring_consume(&rd), "slot was reused");
+
+    frame = sample_ring_peek(&rd);
+    zassert_equal(frame->seq, SAMPLE_RING_DEPTH + 1 - RING_HISTORY + 1,
+                  "skips to the oldest valid frame");
+    zassert_equal(rd.dropped, frame->seq - 1, "skipped frames are dropped");
+}
+
+/**
+ * @brief Test that packing a frame into a slot and back loses nothing
+ */
+ZTEST(sample_ring, test_pack_roundtrip)
+{
+    struct sample_ring_slot slot;
+    struct adc_regs in = { 0 };
+    struct adc_regs out;
+
+    for (int i = 0; i < NUM_CH; i++) {
+        in.raw[i] = (SAMPLE_RING_PACK12 ? FRAME_PACK12_MAX : UINT16_MAX) - i * 37;
+    }
+    in.sampled = BIT(0);
+    in.seq = 0x01020304;
+    in.last_sample_uptime_ms = k_uptime_get();
+    in.timestamp_ns = 0x0102030405060708ULL;
+    in.synced = true;
+
+    sample_ring_pack(&in, &slot);
+    zassert_equal(sizeof(slot.codes), FRAME_PACKED_SIZE(NUM_CH, SAMPLE_RING_PACK12),
+                  "codes are packed");
+
+    sample_ring_unpack(&slot, &out);
+    zassert_mem_equal(out.raw, in.raw, sizeof(in.raw), "codes");
+    zassert_equal(out.sampled, in.sampled, "sampled mask");
+    zassert_equal(out.seq, in.seq, "seq");
+    zassert_equal(out.last_sample_uptime_ms, in.last_sample_uptime_ms, "uptime widened");
+    zassert_equal(out.timestamp_ns, in.timestamp_ns, "timestamp");
+    zassert_true(out.synced, "synced");
+}
+
+ZTEST_SUITE(sample_ring, NULL, NULL, sample_ring_before, NULL, NULL);
@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the runtime sampling configuration (sampler_config.c)
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+#include "sampler_config.h"
+#include "adc_backend.h"
+#include "adaptive_rate.h"
+#include "fake_sample_sched.h"
+#include "filter.h"
+#include "frame_pack.h"
+#include "sample_sched.h"
+
+#define DEFAULT_PERIOD_US (CONFIG_APP_SAMPLE_PERIOD_MS * USEC_PER_MSEC)
+
+/* Fake backend: oversampling up to 2^4, configure() records its calls */
+#define FAKE_MAX_OVERSAMPLING 4
+
+static struct {
+    uint32_t calls;
+    uint8_t resolution;
+    uint8_t oversampling;
+    int ret;
+} backend;
+
+int adc_backend_config_check(uint8_t resolution, uint8_t oversampling)
+{
+    ARG_UNUSED(resolution);
+    if (oversampling != ADC_BACKEND_DEFAULT && oversampling > FAKE_MAX_OVERSAMPLING) {
+        return -ENOTSUP;
+    }
+    return 0;
+}
+
+int adc_backend_configure(uint8_t resolution, uint8_t oversampling)
+{
+    backend.calls++;
+    if (backend.ret == 0) {
+        backend.resolution = resolution;
+        backend.oversampling = oversampling;
+    }
+    return backend.ret;
+}
+
+static struct sampler_config defaults(void)
+{
+    return (struct sampler_config){
+        .period_us = DEFAULT_PERIOD_US,
+        .channel_mask = ADC_BACKEND_ALL_CHANNELS,
+        .resolution = ADC_BACKEND_DEFAULT,
+        .oversampling = ADC_BACKEND_DEFAULT,
+    };
+}
+
+/* Test fixture - build-time defaults applied, no calls recorded */
+static void sampler_config_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    filter_init();
+    fake_sample_sched_reset(DEFAULT_PERIOD_US);
+    adaptive_rate_init();
+    memset(&backend, 0, sizeof(backend));
+
+    zassert_equal(sampler_config_init(), 0, "init");
+    sampler_config_apply();
+    fake_sched.set_calls = 0;
+}
+
+/**
+ * @brief Test that out-of-range configurations are rejected and not staged
+ */
+ZTEST(sampler_config, test_set_reject)
+{
+    struct sampler_config cfg = defaults();
+    struct sampler_config got;
+
+    cfg.period_us = SAMPLE_SCHED_MIN_PERIOD_US - 1;
+    zassert_equal(sampler_config_set(&cfg), -EINVAL, "period below the minimum");
+    cfg.period_us = SAMPLE_SCHED_MAX_PERIOD_US + 1;
+    zassert_equal(sampler_config_set(&cfg), -EINVAL, "period above the maximum");
+
+    cfg = defaults();
+    cfg.channel_mask = 0;
+    zassert_equal(sampler_config_set(&cfg), -EINVAL, "empty channel mask");
+    cfg.channel_mask = ADC_BACKEND_ALL_CHANNELS + 1;
+    zassert_equal(sampler_config_set(&cfg), -EINVAL, "channel past NUM_CH");
+
+    if (IS_ENABLED(CONFIG_APP_FRAME_PACK12)) {
+        cfg = defaults();
+        cfg.resolution = FRAME_PACK12_BITS + 1;
+        zassert_equal(sampler_config_set(&cfg), -ENOTSUP, "wider than the packed frames");
+    }
+
+    cfg = defaults();
+    cfg.oversampling = FAKE_MAX_OVERSAMPLING + 1;
+    zassert_equal(sampler_config_set(&cfg), -ENOTSUP, "backend check rejected");
+
+    sampler_config_get(&got);
+    zassert_equal(got.period_us, DEFAULT_PERIOD_US, "rejected period not staged");
+    zassert_equal(got.channel_mask, ADC_BACKEND_ALL_CHANNELS, "rejected mask not staged");
+    zassert_equal(got.resolution, ADC_BACKEND_DEFAULT, "rejected resolution not staged");
+    zassert_equal(got.oversampling, ADC_BACKEND_DEFAULT, "rejected oversampling not staged");
+
+    sampler_config_apply();
+    zassert_equal(backend.calls, 0, "nothing to apply");
+    zassert_equal(fake_sched.set_calls, 0, "period untouched");
+}
+
+/**
+ * @brief Test the limits of the accepted ranges
+ */
+ZTEST(sampler_config, test_set_accept)
+{
+    struct sampler_config cfg = defaults();
+    struct sampler_config got;
+
+    cfg.period_us = SAMPLE_SCHED_MIN_PERIOD_US;
+    zassert_equal(sampler_config_set(&cfg), 0, "minimum period");
+    cfg.period_us = SAMPLE_SCHED_MAX_PERIOD_US;
+    zassert_equal(sampler_config_set(&cfg), 0, "maximum period");
+
+    cfg.channel_mask = BIT(NUM_CH - 1);
+    zassert_equal(sampler_config_set(&cfg), 0, "last channel alone");
+
+    cfg.resolution = FRAME_PACK12_BITS;
+    cfg.oversampling = FAKE_MAX_OVERSAMPLING;
+    zassert_equal(sampler_config_set(&cfg), 0, "12 bits, maximum oversampling");
+
+    sampler_config_get(&got);
+    zassert_equal(got.period_us, SAMPLE_SCHED_MAX_PERIOD_US, "latest period staged");
+    zassert_equal(got.channel_mask, BIT(NUM_CH - 1), "latest mask staged");
+    zassert_equal(got.resolution, FRAME_PACK12_BITS, "latest resolution staged");
+    zassert_equal(got.oversampling, FAKE_MAX_OVERSAMPLING, "latest oversampling staged");
+}
+
+/**
+ * @brief Test that apply only acts on the fields that changed, once
+ */
+ZTEST(sampler_config, test_apply_changes_only)
+{
+    struct sampler_config cfg = defaults();
+
+    cfg.channel_mask = BIT(0);
+    zassert_equal(sampler_config_set(&cfg), 0, "mask change");
+    zassert_equal(sampler_config_channels(), ADC_BACKEND_ALL_CHANNELS, "staged, not applied");
+
+    sampler_config_apply();
+    zassert_equal(sampler_config_channels(), BIT(0), "mask applied");
+    zassert_equal(backend.calls, 0, "mask change leaves the backend alone");
+    zassert_equal(fake_sched.set_calls, 0, "mask change leaves the period alone");
+
+    cfg.period_us = 2 * DEFAULT_PERIOD_US;
+    zassert_equal(sampler_config_set(&cfg), 0, "period change");
+    sampler_config_apply();
+    zassert_equal(fake_sched.period_us, 2 * DEFAULT_PERIOD_US, "period applied");
+    zassert_equal(backend.calls, 0, "period change does not rebuild sequences");
+
+    cfg.resolution = 10;
+    zassert_equal(sampler_config_set(&cfg), 0, "resolution change");
+    sampler_config_apply();
+    zassert_equal(backend.calls, 1, "backend reconfigured");
+    zassert_equal(backend.resolution, 10, "resolution passed on");
+    zassert_equal(backend.oversampling, ADC_BACKEND_DEFAULT, "oversampling passed on");
+
+    sampler_config_apply();
+    zassert_equal(backend.calls, 1, "applied once");
+}
+
+/**
+ * @brief Test a period staged back after adcrate changed it directly
+ */
+ZTEST(sampler_config, test_apply_after_direct_period)
+{
+    struct adaptive_rate_config rate;
+    struct sampler_config cfg;
+
+    /* As adcrate period does it */
+    adaptive_rate_get(&rate);
+    rate.enabled = false;
+    rate.fast_us = DEFAULT_PERIOD_US / 2;
+    rate.slow_us = DEFAULT_PERIOD_US / 2;
+    zassert_equal(adaptive_rate_configure(&rate), 0, "direct period change");
+    zassert_equal(fake_sched.period_us, DEFAULT_PERIOD_US / 2, "running the direct period");
+
+    sampler_config_get(&cfg);
+    zassert_equal(cfg.period_us, DEFAULT_PERIOD_US / 2, "get reports the running period");
+
+    /* Staging the previously applied period must still change it back */
+    cfg.period_us = DEFAULT_PERIOD_US;
+    zassert_equal(sampler_config_set(&cfg), 0, "set");
+    sampler_config_apply();
+    zassert_equal(fake_sched.period_us, DEFAULT_PERIOD_US, "period applied");
+
+    sampler_config_get(&cfg);
+    zassert_equal(cfg.period_us, DEFAULT_PERIOD_US, "get agrees");
+}
+
+/**
+ * @brief Test that a failed backend change is retried by the next set
+ */
+ZTEST(sampler_config, test_apply_backend_failure)
+{
+    struct sampler_config cfg = defaults();
+
+    cfg.resolution = 10;
+    cfg.channel_mask = BIT(1);
+    backend.ret = -EIO;
+    zassert_equal(sampler_config_set(&cfg), 0, "set");
+    sampler_config_apply();
+    zassert_equal(backend.calls, 1, "backend tried");
+    zassert_equal(sampler_config_channels(), BIT(1), "other fields still applied");
+
+    /* The failed resolution was not recorded as applied */
+    backend.ret = 0;
+    zassert_equal(sampler_config_set(&cfg), 0, "set again");
+    sampler_config_apply();
+    zassert_equal(backend.calls, 2, "backend retried");
+    zassert_equal(backend.resolution, 10, "resolution applied");
+}
+
+ZTEST_SUITE(sampler_config, NULL, NULL, sampler_config_before, NULL, NULL);
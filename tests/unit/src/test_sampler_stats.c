@@ -0,0 +1,121 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the sampling-loop statistics (sampler_stats.c)
+ */
+
+#include <zephyr/ztest.h>
+#include "sampler_stats.h"
+
+/* Test fixture - timing counter running, all accumulators clear */
+static void sampler_stats_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    sampler_stats_init();
+}
+
+/**
+ * @brief Test that overrun wakeups are counted apart from jitter
+ */
+ZTEST(sampler_stats, test_overrun_not_jitter)
+{
+    struct sampler_stat st;
+    uint64_t t = 1000;  /* 0 would read as "no previous wakeup" */
+
+    sampler_stats_wakeup(t, 1000, 1);
+    sampler_stats_get(SAMPLER_STAT_JITTER, &st);
+    zassert_equal(st.count, 0, "first wakeup has no interval");
+
+    sampler_stats_wakeup(t += 10, 1000, 1);
+    sampler_stats_get(SAMPLER_STAT_JITTER, &st);
+    zassert_equal(st.count, 1, "on-time wakeup is a jitter sample");
+
+    /* Four ticks skipped: a long interval, but not jitter */
+    sampler_stats_wakeup(t += 100000, 1000, 5);
+    sampler_stats_get(SAMPLER_STAT_JITTER, &st);
+    zassert_equal(st.count, 1, "overrun kept out of jitter");
+    zassert_equal(sampler_stats_overruns(), 1, "overrun counted");
+
+    /* The next interval is measured from the overrun wakeup */
+    sampler_stats_wakeup(t += 10, 1000, 1);
+    sampler_stats_get(SAMPLER_STAT_JITTER, &st);
+    zassert_equal(st.count, 2, "jitter resumes after the overrun");
+    zassert_true(st.max < 1000 * 1000, "no overrun-sized sample");
+
+    sampler_stats_reset();
+    zassert_equal(sampler_stats_overruns(), 0, "reset clears overruns");
+}
+
+/**
+ * @brief Test the per-channel failure counters and log rate limit
+ */
+ZTEST(sampler_stats, test_channel_error_rate_limit)
+{
+    struct sampler_ch_errors e;
+    uint32_t missed = UINT32_MAX;
+
+    zassert_true(sampler_stats_channel_error(0, -EIO, &missed), "first failure logs");
+    zassert_equal(missed, 0, "nothing missed before the first line");
+
+    for (int i = 0; i < 3; i++) {
+        zassert_false(sampler_stats_channel_error(0, -EBUSY, &missed),
+                      "failure %d within the interval logged", i);
+    }
+
+    sampler_stats_get_errors(0, &e);
+    zassert_equal(e.count, 4, "every failure counted");
+    zassert_equal(e.last_err, -EBUSY, "latest errno kept");
+
+    /* Other channels have their own counters and limit */
+    zassert_true(sampler_stats_channel_error(1, -EIO, &missed), "channel 1 first failure");
+    sampler_stats_get_errors(1, &e);
+    zassert_equal(e.count, 1, "channel 1 count");
+
+    k_msleep(CONFIG_APP_ERROR_LOG_INTERVAL_MS);
+
+    zassert_true(sampler_stats_channel_error(0, -ETIMEDOUT, &missed),
+                 "log due again after the interval");
+    zassert_equal(missed, 3, "failures in between reported");
+    sampler_stats_get_errors(0, &e);
+    zassert_equal(e.count, 5, "count after the interval");
+    zassert_equal(e.last_err, -ETIMEDOUT, "errno after the interval");
+
+    zassert_false(sampler_stats_channel_error(NUM_CH, -EIO, &missed), "bad channel ignored");
+
+    sampler_stats_reset();
+    sampler_stats_get_errors(0, &e);
+    zassert_equal(e.count, 0, "reset clears the counters");
+}
+
+/**
+ * @brief Test a whole-scan failure counted on every channel in the mask
+ */
+ZTEST(sampler_stats, test_channels_failed)
+{
+    struct sampler_ch_errors e;
+    uint32_t missed;
+
+    zassert_true(sampler_stats_channels_failed(BIT(0), -EIO, &missed), "first failure logs");
+    zassert_false(sampler_stats_channels_failed(BIT(0), -EIO, &missed), "rate limited");
+
+    /* Channel 1 is due, so the scan logs; channel 0's skip is not lost */
+    zassert_true(sampler_stats_channels_failed(BIT(0) | BIT(1), -EIO, &missed),
+                 "any due channel logs");
+    zassert_equal(missed, 0, "channel 0 not due, not in missed");
+
+    sampler_stats_get_errors(0, &e);
+    zassert_equal(e.count, 3, "channel 0 counted every scan");
+    sampler_stats_get_errors(1, &e);
+    zassert_equal(e.count, 1, "channel 1 counted once");
+    sampler_stats_get_errors(2, &e);
+    zassert_equal(e.count, 0, "channel outside the mask untouched");
+
+    k_msleep(CONFIG_APP_ERROR_LOG_INTERVAL_MS);
+
+    /* Channel 0 missed 2, channel 1 none: the most is reported */
+    zassert_true(sampler_stats_channels_failed(BIT(0) | BIT(1), -EIO, &missed),
+                 "due after the interval");
+    zassert_equal(missed, 2, "largest gap across the mask");
+}
+
+ZTEST_SUITE(sampler_stats, NULL, NULL, sampler_stats_before, NULL, NULL);
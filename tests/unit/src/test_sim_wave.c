@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the simulator waveform generator (sim_wave.c)
+ */
+
+#include <zephyr/ztest.h>
+#include <stdlib.h>
+#include "sim_wave.h"
+
+/**
+ * @brief Test sine hits offset, peak and trough at the quarter periods
+ */
+ZTEST(sim_wave, test_sine)
+{
+    struct sim_wave w = {
+        .type = SIM_WAVE_SINE, .freq_mhz = 1000, .offset_mv = 1650, .amplitude_mv = 1000,
+    };
+
+    zassert_equal(sim_wave_eval(&w, 0), 1650, "starts at offset");
+    zassert_within(sim_wave_eval(&w, 250000), 2650, 1, "peak at T/4");
+    zassert_within(sim_wave_eval(&w, 500000), 1650, 1, "offset at T/2");
+    zassert_within(sim_wave_eval(&w, 750000), 650, 1, "trough at 3T/4");
+    zassert_within(sim_wave_eval(&w, 125000), 1650 + 707, 2, "sin(pi/4)");
+}
+
+/**
+ * @brief Test the waveform repeats every period at a fractional frequency
+ */
+ZTEST(sim_wave, test_periodic)
+{
+    /* 2.5 Hz: 400 ms period */
+    struct sim_wave w = {
+        .type = SIM_WAVE_SINE, .freq_mhz = 2500, .offset_mv = 1000, .amplitude_mv = 500,
+    };
+
+    for (uint64_t t = 0; t < 400000; t += 37000) {
+        zassert_equal(sim_wave_eval(&w, t), sim_wave_eval(&w, t + 400000 * 7),
+                      "t=%llu should repeat", t);
+    }
+}
+
+/**
+ * @brief Test ramp and square shapes
+ */
+ZTEST(sim_wave, test_ramp_square)
+{
+    struct sim_wave ramp = {
+        .type = SIM_WAVE_RAMP, .freq_mhz = 1000, .offset_mv = 1000, .amplitude_mv = 500,
+    };
+    struct sim_wave square = {
+        .type = SIM_WAVE_SQUARE, .freq_mhz = 1000, .offset_mv = 1000, .amplitude_mv = 500,
+    };
+
+    zassert_equal(sim_wave_eval(&ramp, 0), 500, "ramp starts at the bottom");
+    zassert_within(sim_wave_eval(&ramp, 500000), 1000, 1, "ramp at offset mid-period");
+    zassert_within(sim_wave_eval(&ramp, 999999), 1500, 1, "ramp ends at the top");
+
+    zassert_equal(sim_wave_eval(&square, 100000), 1500, "high half");
+    zassert_equal(sim_wave_eval(&square, 600000), 500, "low half");
+}
+
+/**
+ * @brief Test noise stays within the amplitude and covers both sides
+ */
+ZTEST(sim_wave, test_noise)
+{
+    struct sim_wave w = { .type = SIM_WAVE_NOISE, .offset_mv = 1000, .amplitude_mv = 50 };
+    bool below = false, above = false;
+
+    for (int i = 0; i < 1000; i++) {
+        int32_t mv = sim_wave_eval(&w, 0);
+
+        zassert_true(abs(mv - 1000) <= 50, "sample %d out of range: %d", i, mv);
+        below |= (mv < 1000);
+        above |= (mv > 1000);
+    }
+
+    zassert_true(below && above, "noise should spread around the offset");
+}
+
+/**
+ * @brief Test table replay holds each point for 1/len of a period
+ */
+ZTEST(sim_wave, test_table)
+{
+    struct sim_wave w = {
+        .type = SIM_WAVE_TABLE, .freq_mhz = 1000, .table_len = 4,
+        .table_mv = { 100, 200, 300, 400 },
+    };
+
+    zassert_equal(sim_wave_eval(&w, 0), 100, "first point");
+    zassert_equal(sim_wave_eval(&w, 300000), 200, "second point");
+    zassert_equal(sim_wave_eval(&w, 740000), 300, "third point");
+    zassert_equal(sim_wave_eval(&w, 999999), 400, "last point");
+    zassert_equal(sim_wave_eval(&w, 1000000), 100, "wraps to the first point");
+}
+
+ZTEST_SUITE(sim_wave, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,359 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the stream protocol encoder (stream_proto.c)
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+#include "regs.h"
+#include "sample_ring.h"
+#include "frame_pack.h"
+#include "stream_proto.h"
+
+static uint8_t pkt[STREAM_MAX_PKT_SIZE];
+
+/* Bitwise CRC-16/CCITT-FALSE, independent of the Zephyr implementation */
+static uint16_t ref_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void check_framing(int len, uint8_t type)
+{
+    uint16_t payload_len = sys_get_le16(&pkt[4]);
+
+    zassert_true(len > 0, "encode failed: %d", len);
+    zassert_equal(pkt[0], STREAM_SYNC0, "sync0");
+    zassert_equal(pkt[1], STREAM_SYNC1, "sync1");
+    zassert_equal(pkt[2], type, "type");
+    zassert_equal(len, STREAM_HDR_SIZE + payload_len + STREAM_CRC_SIZE, "length");
+    zassert_equal(sys_get_le16(&pkt[len - 2]), ref_crc16(&pkt[2], len - 4), "CRC");
+}
+
+static void make_frame(struct adc_regs *frame)
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->seq = 0x01020304;
+    frame->last_sample_uptime_ms = 123456;
+    frame->timestamp_ns = 0x0102030405060708ULL;
+    for (int i = 0; i < NUM_CH; i++) {
+        frame->raw[i] = 100 + i * 250;
+    }
+}
+
+/**
+ * @brief Test the INFO packet layout
+ */
+ZTEST(stream_proto, test_info)
+{
+    struct stream_info info = { .resolution = 12, .ref_mv = 3300, .period_us = 1000 };
+    int len = stream_encode_info(&info, pkt, sizeof(pkt));
+
+    check_framing(len, STREAM_PKT_INFO);
+    zassert_equal(pkt[6], STREAM_PROTO_VERSION, "version");
+    zassert_equal(pkt[7], NUM_CH, "channel count");
+    zassert_equal(pkt[8], 12, "resolution");
+    zassert_equal(sys_get_le16(&pkt[10]), 3300, "ref_mv");
+    zassert_equal(sys_get_le32(&pkt[12]), 1000, "period_us");
+}
+
+/**
+ * @brief Test a whole FRAME packet carries the slot's packed codes
+ */
+ZTEST(stream_proto, test_frame_whole)
+{
+    struct adc_regs frame;
+    struct sample_ring_slot slot;
+    const uint8_t *v = &pkt[STREAM_HDR_SIZE + STREAM_FRAME_FIXED_SIZE];
+    uint16_t values[NUM_CH];
+    int len;
+
+    make_frame(&frame);
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, NULL, pkt, sizeof(pkt));
+
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & STREAM_FLAG_PACK12, SAMPLE_RING_PACK12 ? STREAM_FLAG_PACK12 : 0,
+                  "PACK12 flag follows the ring");
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, 0, "no DELTA flag without a reference");
+    zassert_equal(sys_get_le16(&pkt[4]),
+                  STREAM_FRAME_FIXED_SIZE + STREAM_VALUES_SIZE(SAMPLE_RING_PACK12) +
+                  STREAM_CH_TIME_SIZE,
+                  "payload size");
+    zassert_equal(sys_get_le32(&pkt[6]), frame.seq, "seq");
+    zassert_equal(sys_get_le64(&pkt[10]), 0x0102030405060708ULL, "timestamp");
+    zassert_equal(pkt[18], NUM_CH, "channel count");
+    zassert_mem_equal(v, slot.codes, sizeof(slot.codes), "codes copied as packed");
+
+    frame_unpack(v, NUM_CH, SAMPLE_RING_PACK12, values);
+    zassert_mem_equal(values, frame.raw, sizeof(values), "codes unpack to the originals");
+    zassert_equal(pkt[3] & STREAM_FLAG_SYNCED, 0, "local timestamp");
+
+    frame.synced = true;
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, NULL, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & STREAM_FLAG_SYNCED, STREAM_FLAG_SYNCED, "sync timestamp");
+}
+
+/**
+ * @brief Test DELTA frames decode against their predecessor
+ */
+ZTEST(stream_proto, test_frame_delta)
+{
+    struct stream_delta_ref ref = { .valid = false };
+    struct adc_regs frame;
+    struct sample_ring_slot slot;
+    const uint8_t *p = &pkt[STREAM_HDR_SIZE];
+    uint16_t prev[NUM_CH];
+    uint16_t values[NUM_CH];
+    uint64_t seq, ts_step;
+    int len, pos, seq_len;
+
+    make_frame(&frame);
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, 0, "first frame is whole");
+    zassert_true(ref.valid && ref.seq == frame.seq, "reference follows the frame");
+    memcpy(prev, frame.raw, sizeof(prev));
+
+    /* Next frame: every channel moves a little */
+    frame.seq++;
+    frame.timestamp_ns += 1000000;
+    for (int i = 0; i < NUM_CH; i++) {
+        frame.raw[i] += (i % 2 == 0) ? 3 : -5;
+    }
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, STREAM_FLAG_DELTA, "DELTA flag");
+    zassert_equal(ref.run, 1, "one DELTA frame in the run");
+
+    /* 4-byte seq, 3-byte time step, then one byte per channel */
+    seq_len = frame_varint_get(p, sys_get_le16(&pkt[4]), &seq);
+    zassert_equal(seq_len, 4, "seq size");
+    zassert_equal(seq, frame.seq, "seq");
+    pos = frame_varint_get(&p[seq_len], sys_get_le16(&pkt[4]) - seq_len, &ts_step);
+    zassert_equal(pos, 3, "time step size");
+    zassert_equal(frame_unzigzag(ts_step), 1000000, "time step");
+    pos += seq_len;
+    memcpy(values, prev, sizeof(values));
+    zassert_equal(frame_delta_decode(&p[pos], sys_get_le16(&pkt[4]) - pos, values, NUM_CH,
+                                     values), NUM_CH, "one byte per channel");
+    zassert_mem_equal(values, frame.raw, sizeof(values), "codes");
+    zassert_equal(sys_get_le16(&pkt[4]), pos + NUM_CH + STREAM_CH_TIME_SIZE, "payload size");
+
+    /* A gap in seq needs a whole frame */
+    frame.seq += 2;
+    sample_ring_pack(&frame, &slot);
+    stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, 0, "whole frame after a gap");
+    zassert_equal(ref.run, 0, "run restarts");
+
+    /* So does an invalidated reference */
+    frame.seq++;
+    sample_ring_pack(&frame, &slot);
+    ref.valid = false;
+    stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, 0, "whole frame after a reset");
+}
+
+/**
+ * @brief Test that a delta no shorter than the whole frame is sent whole
+ */
+ZTEST(stream_proto, test_frame_delta_fallback)
+{
+    struct stream_delta_ref ref = { .valid = false };
+    struct adc_regs frame;
+    struct sample_ring_slot slot;
+    uint8_t seq[FRAME_VARINT_MAX_SIZE];
+    size_t delta_len, whole_len = STREAM_FRAME_FIXED_SIZE + STREAM_VALUES_SIZE(SAMPLE_RING_PACK12);
+
+    make_frame(&frame);
+    /* seq, 10-byte time step, and every channel swings by at least 64 codes */
+    delta_len = frame_varint_put(frame.seq + 1, seq) + FRAME_VARINT_MAX_SIZE +
+                NUM_CH * (SAMPLE_RING_PACK12 ? 2 : 3);
+    sample_ring_pack(&frame, &slot);
+    stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+
+    frame.seq++;
+    frame.timestamp_ns += 1ULL << 62;
+    for (int i = 0; i < NUM_CH; i++) {
+        frame.raw[i] = SAMPLE_RING_PACK12 ? FRAME_PACK12_MAX : UINT16_MAX;
+    }
+    frame.raw[0] = 0;
+    sample_ring_pack(&frame, &slot);
+    stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, (delta_len < whole_len) ? STREAM_FLAG_DELTA : 0,
+                  "the shorter encoding is sent");
+    zassert_true(ref.valid && ref.seq == frame.seq, "still the reference");
+}
+
+/**
+ * @brief Test the EVENT packet layout
+ */
+ZTEST(stream_proto, test_event)
+{
+    int len = stream_encode_event(0xA0B0C0D0, 3, 1, 0x0ABC, pkt, sizeof(pkt));
+
+    check_framing(len, STREAM_PKT_EVENT);
+    zassert_equal(len, STREAM_EVENT_PKT_SIZE, "event packet size");
+    zassert_equal(sys_get_le32(&pkt[6]), 0xA0B0C0D0, "seq");
+    zassert_equal(pkt[10], 3, "channel");
+    zassert_equal(pkt[11], 1, "type");
+    zassert_equal(sys_get_le16(&pkt[12]), 0x0ABC, "raw");
+}
+
+/**
+ * @brief Test the CAPTURE_INFO and CAPTURE_DATA packet layouts
+ */
+ZTEST(stream_proto, test_capture)
+{
+    const struct stream_capture_info info = {
+        .ch = 2, .resolution = 12, .ref_mv = 3300,
+        .samples = 65536, .trigger_index = 1024, .interval_ns = 1250,
+    };
+    uint16_t raw[STREAM_CAPTURE_CHUNK];
+    int len;
+
+    len = stream_encode_capture_info(&info, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_CAPTURE_INFO);
+    zassert_equal(pkt[6], 2, "channel");
+    zassert_equal(pkt[7], 12, "resolution");
+    zassert_equal(sys_get_le16(&pkt[8]), 3300, "ref_mv");
+    zassert_equal(sys_get_le32(&pkt[10]), 65536, "samples");
+    zassert_equal(sys_get_le32(&pkt[14]), 1024, "trigger index");
+    zassert_equal(sys_get_le32(&pkt[18]), 1250, "interval");
+
+    for (int i = 0; i < STREAM_CAPTURE_CHUNK; i++) {
+        raw[i] = 0x0F00 + i;
+    }
+    len = stream_encode_capture_data(4096, raw, STREAM_CAPTURE_CHUNK, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_CAPTURE_DATA);
+    zassert_true(len <= STREAM_MAX_PKT_SIZE, "a full chunk fits the largest packet");
+    zassert_equal(sys_get_le32(&pkt[6]), 4096, "first index");
+    zassert_equal(sys_get_le16(&pkt[10]), 0x0F00, "first sample");
+    zassert_equal(sys_get_le16(&pkt[10 + 2 * (STREAM_CAPTURE_CHUNK - 1)]),
+                  0x0F00 + STREAM_CAPTURE_CHUNK - 1, "last sample");
+
+    zassert_equal(stream_encode_capture_data(0, raw, 0, pkt, sizeof(pkt)), -EINVAL,
+                  "empty chunk");
+    zassert_equal(stream_encode_capture_data(0, raw, STREAM_CAPTURE_CHUNK + 1, pkt,
+                                             sizeof(pkt)), -EINVAL, "oversized chunk");
+}
+
+/**
+ * @brief Test the STATS packet layout
+ */
+ZTEST(stream_proto, test_stats)
+{
+    struct chan_stats_snapshot snap = { .duration_ms = 1000 };
+    const uint8_t *c = &pkt[STREAM_HDR_SIZE + STREAM_STATS_FIXED_SIZE];
+    int len;
+
+    snap.ch[0] = (struct chan_stats){
+        .count = 100000, .min = 10, .max = 4000, .mean = 2048, .rms = 2300,
+    };
+
+    len = stream_encode_stats(&snap, pkt, sizeof(pkt));
+    check_framing(len, STREAM_PKT_STATS);
+    zassert_equal(len, STREAM_STATS_PKT_SIZE, "stats packet size");
+    zassert_true(len <= STREAM_MAX_PKT_SIZE, "stats fit the largest packet");
+    zassert_equal(sys_get_le32(&pkt[6]), 1000, "window length");
+    zassert_equal(pkt[10], NUM_CH, "channel count");
+    zassert_equal(sys_get_le32(&c[0]), 100000, "count");
+    zassert_equal(sys_get_le16(&c[4]), 10, "min");
+    zassert_equal(sys_get_le16(&c[6]), 4000, "max");
+    zassert_equal(sys_get_le16(&c[8]), 2048, "mean");
+    zassert_equal(sys_get_le16(&c[10]), 2300, "rms");
+    if (NUM_CH > 1) {
+        zassert_equal(sys_get_le32(&c[STREAM_STATS_CH_SIZE]), 0, "empty channel");
+    }
+}
+
+/**
+ * @brief Test the short-buffer error
+ */
+ZTEST(stream_proto, test_buffer_too_small)
+{
+    struct stream_delta_ref ref = { .valid = false };
+    struct adc_regs frame;
+    struct sample_ring_slot slot;
+
+    make_frame(&frame);
+    sample_ring_pack(&frame, &slot);
+    zassert_equal(stream_encode_frame(&slot, &ref, pkt, 8), -ENOMEM, "frame");
+    zassert_false(ref.valid, "reference untouched");
+    zassert_equal(stream_encode_drop(1, pkt, 8), -ENOMEM, "drop");
+    zassert_equal(stream_encode_event(1, 0, 1, 0, pkt, 8), -ENOMEM, "event");
+    zassert_equal(stream_encode_capture_data(0, frame.raw, 1, pkt, 8), -ENOMEM, "capture");
+    zassert_equal(stream_encode_stats(&(struct chan_stats_snapshot){ 0 }, pkt, 8), -ENOMEM,
+                  "stats");
+}
+
+#if defined(CONFIG_APP_CHANNEL_TIMESTAMPS)
+/**
+ * @brief Test the per-channel offsets after whole and DELTA frame values
+ */
+ZTEST(stream_proto, test_frame_ch_time)
+{
+    struct stream_delta_ref ref = { .valid = false };
+    struct adc_regs frame;
+    struct sample_ring_slot slot;
+    const uint8_t *p = &pkt[STREAM_HDR_SIZE];
+    uint16_t payload_len;
+    int len;
+
+    make_frame(&frame);
+    for (int i = 0; i < NUM_CH; i++) {
+        frame.ch_offset_ns[i] = 0x01000000 * i + 1500 * (i + 1);
+    }
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & STREAM_FLAG_CH_TIME, STREAM_FLAG_CH_TIME, "CH_TIME flag");
+    zassert_equal(pkt[3] & STREAM_FLAG_DELTA, 0, "first frame is whole");
+    payload_len = sys_get_le16(&pkt[4]);
+    zassert_equal(payload_len,
+                  STREAM_FRAME_FIXED_SIZE + STREAM_VALUES_SIZE(SAMPLE_RING_PACK12) +
+                  NUM_CH * 4, "offsets after the codes");
+    for (int i = 0; i < NUM_CH; i++) {
+        zassert_equal(sys_get_le32(&p[payload_len - NUM_CH * 4 + 4 * i]),
+                      frame.ch_offset_ns[i], "whole frame ch[%d] offset", i);
+    }
+
+    /* A DELTA frame still carries them in full, after the deltas */
+    frame.seq++;
+    frame.timestamp_ns += 1000000;
+    for (int i = 0; i < NUM_CH; i++) {
+        frame.raw[i]++;
+        frame.ch_offset_ns[i] += 7;
+    }
+    sample_ring_pack(&frame, &slot);
+    len = stream_encode_frame(&slot, &ref, pkt, sizeof(pkt));
+
+    check_framing(len, STREAM_PKT_FRAME);
+    zassert_equal(pkt[3] & (STREAM_FLAG_CH_TIME | STREAM_FLAG_DELTA),
+                  STREAM_FLAG_CH_TIME | STREAM_FLAG_DELTA, "DELTA frame with offsets");
+    payload_len = sys_get_le16(&pkt[4]);
+    zassert_equal(payload_len, 4 + 3 + NUM_CH + NUM_CH * 4, "seq, time step, deltas, offsets");
+    for (int i = 0; i < NUM_CH; i++) {
+        zassert_equal(sys_get_le32(&p[payload_len - NUM_CH * 4 + 4 * i]),
+                      frame.ch_offset_ns[i], "DELTA frame ch[%d] offset", i);
+    }
+}
+#endif
+
+ZTEST_SUITE(stream_proto, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for the multi-board sync time model (sync_model.c)
+ */
+
+#include <zephyr/ztest.h>
+#include <stdlib.h>
+#include "sync.h"
+
+#define PERIOD_MS 1000
+#define PERIOD_NS (PERIOD_MS * 1000000ULL)
+
+/* Local clock 50 ppm fast, booted 3.3 s before the first edge */
+#define RATE_PPB  50000
+#define BOOT_NS   3300000000ULL
+
+/* test_new_train tracks an edge after a missed one */
+BUILD_ASSERT(CONFIG_APP_SYNC_MAX_MISSED_EDGES >= 1, "missed edges must be tolerated");
+
+static struct sync_model model;
+
+/* Local time of common time t on the test board's clock */
+static uint64_t local_at(uint64_t common_ns)
+{
+    return BOOT_NS + common_ns + common_ns * RATE_PPB / 1000000000ULL;
+}
+
+static void feed_edges(uint32_t count)
+{
+    for (uint32_t n = 0; n < count; n++) {
+        zassert_not_equal(sync_model_edge(&model, local_at(n * PERIOD_NS)),
+                          SYNC_EDGE_IGNORED, "edge %u", n);
+    }
+}
+
+static void sync_model_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    sync_model_init(&model, PERIOD_MS);
+}
+
+/**
+ * @brief Test that two edges lock the model and common time follows them
+ */
+ZTEST(sync_model, test_lock)
+{
+    bool locked;
+    uint64_t t;
+
+    zassert_equal(sync_model_edge(&model, local_at(0)), SYNC_EDGE_NEW_TRAIN, "first edge");
+    t = sync_model_time(&model, local_at(PERIOD_NS / 2), &locked);
+    zassert_false(locked, "one edge gives no rate");
+    zassert_equal(t, local_at(PERIOD_NS / 2), "local time passes through");
+
+    zassert_equal(sync_model_edge(&model, local_at(PERIOD_NS)), SYNC_EDGE_TRACKED,
+                  "second edge");
+    zassert_within(model.rate_ppb, RATE_PPB, 1, "rate measured");
+
+    t = sync_model_time(&model, local_at(PERIOD_NS + PERIOD_NS / 4), &locked);
+    zassert_true(locked, "locked after two edges");
+    zassert_within(t, PERIOD_NS + PERIOD_NS / 4, 10, "common time between edges");
+
+    /* Frame stamped just before an edge the ISR already took */
+    t = sync_model_time(&model, local_at(PERIOD_NS) - 1000, &locked);
+    zassert_true(locked, "still locked");
+    zassert_within(t, PERIOD_NS - 1000, 10, "time before the last edge");
+}
+
+/**
+ * @brief Test that edge jitter stays within a few microseconds of common time
+ */
+ZTEST(sync_model, test_jitter)
+{
+    /* Interrupt latency spread of the edge stamps */
+    static const int32_t jitter_ns[] = { 800, -600, 1200, 0, -900, 400, -300, 1000 };
+    bool locked;
+
+    for (uint32_t n = 0; n < ARRAY_SIZE(jitter_ns); n++) {
+        (void)sync_model_edge(&model, local_at(n * PERIOD_NS) + jitter_ns[n]);
+    }
+
+    for (uint64_t frac = 0; frac < PERIOD_NS; frac += PERIOD_NS / 8) {
+        uint64_t common = 7 * PERIOD_NS + frac;
+        uint64_t t = sync_model_time(&model, local_at(common), &locked);
+
+        zassert_true(locked, "locked");
+        zassert_true(llabs((int64_t)(t - common)) < 5000, "error %lld ns at +%llu",
+                     (long long)(t - common), frac);
+    }
+    zassert_true(abs(model.phase_err_ns) < 5000, "phase error %d ns", model.phase_err_ns);
+}
+
+/**
+ * @brief Test that a bounce within half a period is ignored
+ */
+ZTEST(sync_model, test_bounce)
+{
+    feed_edges(3);
+
+    zassert_equal(sync_model_edge(&model, local_at(2 * PERIOD_NS) + 2000),
+                  SYNC_EDGE_IGNORED, "bounce");
+    zassert_equal(model.edge, 2, "edge count kept");
+    zassert_within(model.rate_ppb, RATE_PPB, 1, "rate kept");
+}
+
+/**
+ * @brief Test holdover expiry and the start of a new train after a gap
+ */
+ZTEST(sync_model, test_new_train)
+{
+    bool locked;
+    uint64_t t;
+
+    feed_edges(4);
+    zassert_equal(model.trains, 1, "one train");
+
+    (void)sync_model_time(&model, local_at(3 * PERIOD_NS + PERIOD_NS), &locked);
+    zassert_true(locked, "one missed edge is held over");
+    (void)sync_model_time(&model, local_at(3 * PERIOD_NS + 2 * PERIOD_NS), &locked);
+    zassert_false(locked, "unlocked after 1.5 periods without an edge");
+
+    /* Edge 4 never came; edge 5 continues the train */
+    zassert_equal(sync_model_edge(&model, local_at(5 * PERIOD_NS)), SYNC_EDGE_TRACKED,
+                  "edge after a missed one");
+    zassert_equal(model.trains, 1, "same train");
+    zassert_equal(model.edge, 5, "edge index counts the missed edge");
+    zassert_equal(model.missed, 1, "missed edge counted");
+    zassert_within(model.rate_ppb, RATE_PPB, 1, "rate over two periods");
+    t = sync_model_time(&model, local_at(5 * PERIOD_NS + PERIOD_NS / 2), &locked);
+    zassert_true(locked, "locked again");
+    zassert_within(t, 5 * PERIOD_NS + PERIOD_NS / 2, 10, "common time continues");
+
+    /* More missing edges than the bound is a stopped train */
+    zassert_equal(sync_model_edge(&model,
+                                  local_at((7 + CONFIG_APP_SYNC_MAX_MISSED_EDGES) * PERIOD_NS)),
+                  SYNC_EDGE_NEW_TRAIN, "edge after the gap");
+    zassert_equal(model.trains, 2, "second train");
+    zassert_equal(model.edge, 0, "edge index restarts");
+
+    zassert_equal(model.missed, 0, "missed count restarts");
+
+    zassert_equal(sync_model_edge(&model,
+                                  local_at((8 + CONFIG_APP_SYNC_MAX_MISSED_EDGES) * PERIOD_NS)),
+                  SYNC_EDGE_TRACKED, "second edge of the new train");
+    t = sync_model_time(&model,
+                        local_at((8 + CONFIG_APP_SYNC_MAX_MISSED_EDGES) * PERIOD_NS +
+                                 PERIOD_NS / 2), &locked);
+    zassert_true(locked, "locked again");
+    zassert_within(t, PERIOD_NS + PERIOD_NS / 2, 10, "common time restarted at 0");
+}
+
+/**
+ * @brief Test that a train restarted off the old grid is a new train
+ */
+ZTEST(sync_model, test_missed_off_grid)
+{
+    feed_edges(4);
+
+    /* Two periods and a third after edge 3: not where edge 5 belongs */
+    zassert_equal(sync_model_edge(&model, local_at(5 * PERIOD_NS + PERIOD_NS / 3)),
+                  SYNC_EDGE_NEW_TRAIN, "phase jump after a gap");
+    zassert_equal(model.trains, 2, "second train");
+    zassert_equal(model.edge, 0, "edge index restarts");
+
+    /* The longest gap the bound allows, on the grid, keeps the new train */
+    zassert_equal(sync_model_edge(&model, local_at(5 * PERIOD_NS + PERIOD_NS / 3 +
+                                                   PERIOD_NS)),
+                  SYNC_EDGE_TRACKED, "second edge");
+    zassert_equal(sync_model_edge(&model,
+                                  local_at((7 + CONFIG_APP_SYNC_MAX_MISSED_EDGES) * PERIOD_NS +
+                                           PERIOD_NS / 3)),
+                  SYNC_EDGE_TRACKED, "edge after the most missed edges");
+    zassert_equal(model.edge, 2 + CONFIG_APP_SYNC_MAX_MISSED_EDGES, "index advanced");
+    zassert_equal(model.missed, CONFIG_APP_SYNC_MAX_MISSED_EDGES, "missed edges");
+}
+
+ZTEST_SUITE(sync_model, NULL, NULL, sync_model_before, NULL, NULL);
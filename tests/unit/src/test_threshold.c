@@ -0,0 +1,301 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Unit tests for threshold rules (threshold.c)
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+#include "regs.h"
+#include "threshold.h"
+
+static uint32_t frame_seq;
+
+/* Evaluate one frame with channel 0 at @p mv (scale is 1 mV per code) */
+static void feed(int32_t mv)
+{
+    struct adc_regs frame = {0};
+
+    frame.raw[0] = (uint16_t)mv;
+    frame.seq = ++frame_seq;
+    threshold_evaluate(&frame);
+}
+
+static int next_event_type(void)
+{
+    struct threshold_event ev;
+
+    if (threshold_get_event(&ev, K_NO_WAIT) != 0) {
+        return 0;
+    }
+
+    zassert_equal(ev.ch, 0, "event should be for ch[0]");
+    zassert_equal(ev.seq, frame_seq, "event should carry the frame's seq");
+    return ev.type;
+}
+
+/* Test fixture - 4095 mV over 12 bits makes codes equal millivolts */
+static void threshold_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    regs_init();
+    regs_set_scale(0, 4095, 12);
+    threshold_init();
+    frame_seq = 0;
+}
+
+/**
+ * @brief Test rule validation
+ */
+ZTEST(threshold, test_invalid_rules)
+{
+    struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH | THRESHOLD_LOW,
+        .low_mv = 2000,
+        .high_mv = 1000,
+    };
+
+    zassert_equal(threshold_set_rule(0, &r), -EINVAL, "low must be below high");
+
+    r = (struct threshold_rule){ .flags = THRESHOLD_CHANGE, .deadband_mv = 0 };
+    zassert_equal(threshold_set_rule(0, &r), -EINVAL, "deadband must be positive");
+
+    r = (struct threshold_rule){ .flags = THRESHOLD_HIGH, .hysteresis_mv = -1 };
+    zassert_equal(threshold_set_rule(0, &r), -EINVAL, "negative hysteresis");
+
+    r = (struct threshold_rule){ .flags = THRESHOLD_HIGH, .high_mv = 100 };
+    zassert_equal(threshold_set_rule(NUM_CH, &r), -EINVAL, "bad channel");
+    zassert_ok(threshold_set_rule(0, &r), "valid rule");
+}
+
+/**
+ * @brief Test high alarm with hysteresis
+ */
+ZTEST(threshold, test_high_hysteresis)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH,
+        .high_mv = 2000,
+        .hysteresis_mv = 100,
+    };
+
+    zassert_ok(threshold_set_rule(0, &r));
+
+    feed(1900);
+    zassert_equal(next_event_type(), 0, "below threshold: no event");
+    zassert_equal(threshold_wait(BIT(0), K_NO_WAIT), 0, "no alarm yet");
+
+    feed(2001);
+    zassert_equal(next_event_type(), THRESHOLD_EV_HIGH, "crossing raises HIGH");
+    zassert_equal(threshold_wait(BIT(0), K_NO_WAIT), BIT(0), "alarm bit set");
+
+    feed(1950);
+    zassert_equal(next_event_type(), 0, "inside hysteresis: still in alarm");
+    zassert_equal(threshold_alarms(), BIT(0), "alarm held");
+
+    feed(1899);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CLEAR, "below band clears");
+    zassert_equal(threshold_alarms(), 0, "alarm cleared");
+}
+
+/**
+ * @brief Test a jump from above high to below low in one frame
+ */
+ZTEST(threshold, test_jump_across_band)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH | THRESHOLD_LOW,
+        .low_mv = 1000,
+        .high_mv = 2000,
+        .hysteresis_mv = 50,
+    };
+
+    zassert_ok(threshold_set_rule(0, &r));
+
+    feed(2500);
+    zassert_equal(next_event_type(), THRESHOLD_EV_HIGH);
+
+    feed(500);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CLEAR, "HIGH clears first");
+    zassert_equal(next_event_type(), THRESHOLD_EV_LOW, "then LOW is raised");
+    zassert_equal(threshold_alarms(), BIT(0), "still in alarm (low)");
+
+    feed(1040);
+    zassert_equal(next_event_type(), 0, "inside low hysteresis");
+    feed(1051);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CLEAR, "above low + hysteresis");
+}
+
+/**
+ * @brief Test deadband change events
+ */
+ZTEST(threshold, test_deadband)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_CHANGE,
+        .deadband_mv = 50,
+    };
+
+    zassert_ok(threshold_set_rule(0, &r));
+
+    feed(1000);
+    zassert_equal(next_event_type(), 0, "first frame sets the reference");
+    feed(1030);
+    zassert_equal(next_event_type(), 0, "inside deadband");
+    feed(1050);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CHANGE, "moved by deadband");
+    feed(1080);
+    zassert_equal(next_event_type(), 0, "reference moved to 1050");
+    feed(999);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CHANGE, "downward move");
+    zassert_equal(threshold_alarms(), 0, "change events never raise alarms");
+}
+
+/**
+ * @brief Test that a full queue drops and counts events
+ */
+ZTEST(threshold, test_queue_overflow)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_CHANGE,
+        .deadband_mv = 1,
+    };
+    struct threshold_event ev;
+    int queued = 0;
+
+    zassert_ok(threshold_set_rule(0, &r));
+
+    /* One CHANGE per frame after the priming frame */
+    for (int i = 0; i <= CONFIG_APP_THRESHOLD_QUEUE_DEPTH + 4; i++) {
+        feed(1000 + i * 10);
+    }
+
+    while (threshold_get_event(&ev, K_NO_WAIT) == 0) {
+        queued++;
+    }
+
+    zassert_equal(queued, CONFIG_APP_THRESHOLD_QUEUE_DEPTH, "queue should be full");
+    zassert_equal(threshold_events_dropped(), 4, "overflow should be counted");
+}
+
+/* Fake hardware monitor: records windows, reports a configurable quiet mask */
+static struct {
+    bool enabled[NUM_CH];
+    uint16_t low[NUM_CH];
+    uint16_t high[NUM_CH];
+    uint32_t quiet;
+} fake_hw;
+
+static int fake_set_window(unsigned int ch, bool enable, uint16_t low_raw, uint16_t high_raw)
+{
+    fake_hw.enabled[ch] = enable;
+    fake_hw.low[ch] = low_raw;
+    fake_hw.high[ch] = high_raw;
+    return 0;
+}
+
+static uint32_t fake_quiet(void)
+{
+    return fake_hw.quiet;
+}
+
+static const struct threshold_hw fake_hw_ops = {
+    .set_window = fake_set_window,
+    .quiet = fake_quiet,
+};
+
+/**
+ * @brief Test that windows are converted to the codes the rule fires on
+ */
+ZTEST(threshold, test_hw_window)
+{
+    struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH | THRESHOLD_LOW,
+        .low_mv = 1000,
+        .high_mv = 2000,
+    };
+
+    memset(&fake_hw, 0, sizeof(fake_hw));
+    threshold_set_hw(&fake_hw_ops);
+
+    zassert_ok(threshold_set_rule(0, &r));
+    zassert_true(fake_hw.enabled[0], "window armed");
+    zassert_equal(fake_hw.low[0], 1000, "1 mV per code: low maps 1:1");
+    zassert_equal(fake_hw.high[0], 2000, "1 mV per code: high maps 1:1");
+    zassert_equal(threshold_hw_covered(), BIT(0), "ch[0] hardware-checked");
+
+    /* Default 3300 mV / 12-bit scale on ch[1] */
+    zassert_ok(threshold_set_rule(1, &r));
+    zassert_true(regs_raw_to_mv(1, fake_hw.high[1]) <= 2000, "high code inside");
+    zassert_true(regs_raw_to_mv(1, fake_hw.high[1] + 1) > 2000, "next code alarms");
+    zassert_true(regs_raw_to_mv(1, fake_hw.low[1]) >= 1000, "low code inside");
+    zassert_true(regs_raw_to_mv(1, fake_hw.low[1] - 1) < 1000, "previous code alarms");
+
+    r.flags = 0;
+    zassert_ok(threshold_set_rule(0, &r));
+    zassert_false(fake_hw.enabled[0], "window disarmed with the rule");
+    zassert_equal(threshold_hw_covered(), BIT(1), "only ch[1] left");
+}
+
+/**
+ * @brief Test that a quiet hardware monitor skips the software check
+ */
+ZTEST(threshold, test_hw_quiet_skips)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH,
+        .high_mv = 2000,
+    };
+
+    memset(&fake_hw, 0, sizeof(fake_hw));
+    threshold_set_hw(&fake_hw_ops);
+    zassert_ok(threshold_set_rule(0, &r));
+
+    fake_hw.quiet = BIT(0);
+    feed(2500);
+    zassert_equal(next_event_type(), 0, "quiet monitor: software check skipped");
+
+    fake_hw.quiet = 0;
+    feed(2500);
+    zassert_equal(next_event_type(), THRESHOLD_EV_HIGH, "tripped monitor: rule fires");
+
+    /* In alarm, the clear condition is always checked in software */
+    fake_hw.quiet = BIT(0);
+    feed(1000);
+    zassert_equal(next_event_type(), THRESHOLD_EV_CLEAR, "clear needs no trip");
+}
+
+/**
+ * @brief Test that a resolution change re-derives the hardware window
+ */
+ZTEST(threshold, test_hw_rescale)
+{
+    const struct threshold_rule r = {
+        .flags = THRESHOLD_HIGH | THRESHOLD_LOW,
+        .low_mv = 1000,
+        .high_mv = 2000,
+    };
+
+    memset(&fake_hw, 0, sizeof(fake_hw));
+    threshold_set_hw(&fake_hw_ops);
+    zassert_ok(threshold_set_rule(0, &r));
+    zassert_equal(fake_hw.high[0], 2000, "1 mV per code at 12 bits");
+
+    /* Same reference at 10 bits: about 4 mV per code */
+    regs_set_scale(0, 4095, 10);
+    threshold_rescale();
+    zassert_true(fake_hw.enabled[0], "window still armed");
+    zassert_true(regs_raw_to_mv(0, fake_hw.high[0]) <= 2000, "high code inside");
+    zassert_true(regs_raw_to_mv(0, fake_hw.high[0] + 1) > 2000, "next code alarms");
+    zassert_true(regs_raw_to_mv(0, fake_hw.low[0]) >= 1000, "low code inside");
+    zassert_true(regs_raw_to_mv(0, fake_hw.low[0] - 1) < 1000, "previous code alarms");
+    zassert_false(fake_hw.enabled[1], "channels without a rule stay disarmed");
+}
+
+static void threshold_after(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    threshold_set_hw(NULL);
+}
+
+ZTEST_SUITE(threshold, NULL, NULL, threshold_before, threshold_after, NULL);
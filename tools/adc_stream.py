@@ -0,0 +1,530 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""
+Host reader for the ADC Sampler binary stream.
+
+Decodes the packets documented in app/src/stream_proto.h (protocol
+version 4) from the stream UART and collects frames into numpy arrays,
+optionally saved as Parquet (needs pyarrow) or .npz.
+
+Library use:
+
+    decoder = StreamDecoder()
+    recorder = FrameRecorder()
+    for pkt in decoder.feed(port.read(4096)):
+        if isinstance(pkt, Frame):
+            recorder.add(pkt)
+
+Command line (the shell port is optional; without it, start the stream
+with 'adcstream start' yourself):
+
+    python tools/adc_stream.py /dev/ttyUSB0 --shell /dev/ttyACM0 \\
+        --seconds 10 --out capture.parquet
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+import time
+from dataclasses import dataclass, field
+from typing import List, Optional
+
+SYNC = b"\xa5\x5a"
+PROTO_VERSION = 4
+
+HDR_SIZE = 6
+CRC_SIZE = 2
+
+# Packet types
+PKT_INFO = 0x01
+PKT_FRAME = 0x02
+PKT_DROP = 0x03
+PKT_EVENT = 0x04
+PKT_CAPTURE_INFO = 0x05
+PKT_CAPTURE_DATA = 0x06
+PKT_STATS = 0x07
+
+# Packet flags
+FLAG_PACK12 = 0x01
+FLAG_CH_TIME = 0x02
+FLAG_SYNCED = 0x04
+FLAG_DELTA = 0x08
+
+FRAME_FIXED_SIZE = 13
+CH_TIME_SIZE = 4
+CAPTURE_DATA_FIXED_SIZE = 4
+CAPTURE_CHUNK = 64
+STATS_FIXED_SIZE = 5
+STATS_CH_SIZE = 12
+
+# Longest payload the firmware sends, as STREAM_MAX_PKT_SIZE at the most
+# channels CONFIG_APP_NUM_CH allows (STATS, 197 bytes)
+MAX_CHANNELS = 16
+MAX_PAYLOAD = max(FRAME_FIXED_SIZE + MAX_CHANNELS * (2 + CH_TIME_SIZE),
+                  CAPTURE_DATA_FIXED_SIZE + CAPTURE_CHUNK * 2,
+                  STATS_FIXED_SIZE + MAX_CHANNELS * STATS_CH_SIZE)
+
+EVENT_TYPES = {1: "HIGH", 2: "LOW", 3: "CLEAR", 4: "CHANGE"}
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE, as crc16_itu_t(0xFFFF, ...) on the board."""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def unpack12(data: bytes, count: int) -> List[int]:
+    """Unpack STREAM_FLAG_PACK12 values: two per 3 bytes, odd tail in 2."""
+    values = []
+    pos = 0
+    while len(values) < count:
+        v0 = data[pos] | ((data[pos + 1] & 0x0F) << 8)
+        values.append(v0)
+        if len(values) < count:
+            values.append((data[pos + 1] >> 4) | (data[pos + 2] << 4))
+        pos += 3
+    return values
+
+
+def varint_get(data: bytes, pos: int):
+    """LEB128 varint at pos, frame_varint_get(); returns (value, next pos)."""
+    value = 0
+    for i in range(10):
+        if pos + i >= len(data):
+            break
+        value |= (data[pos + i] & 0x7F) << (7 * i)
+        if not data[pos + i] & 0x80:
+            return value, pos + i + 1
+    raise ProtocolError("truncated varint")
+
+
+def unzigzag(u: int) -> int:
+    """Inverse of frame_zigzag(): 0, 1, 2, 3 ... -> 0, -1, 1, -2 ..."""
+    return (u >> 1) ^ -(u & 1)
+
+
+def delta_decode(data: bytes, pos: int, prev: List[int]):
+    """Codes coded by frame_delta_encode(); returns (codes, next pos)."""
+    raw = []
+    for ref in prev:
+        u, pos = varint_get(data, pos)
+        value = ref + unzigzag(u)
+        if not 0 <= value <= 0xFFFF:
+            raise ProtocolError("delta out of range")
+        raw.append(value)
+    return raw, pos
+
+
+def values_size(count: int, pack12: bool) -> int:
+    """Bytes taken by count values, STREAM_VALUES_SIZE() on the board."""
+    return (count * 3 + 1) // 2 if pack12 else count * 2
+
+
+@dataclass
+class Info:
+    version: int
+    num_ch: int
+    resolution: int
+    ref_mv: int
+    period_us: int
+
+    def to_mv(self, raw: int) -> int:
+        """regs_raw_to_mv(): Q16 scale, rounded to nearest."""
+        if self.resolution == 0:
+            return raw
+        full_scale = (1 << self.resolution) - 1
+        mv_q16 = ((self.ref_mv << 16) + full_scale // 2) // full_scale
+        return (raw * mv_q16 + (1 << 15)) >> 16
+
+
+@dataclass
+class Frame:
+    seq: int
+    timestamp_ns: int
+    synced: bool
+    raw: List[int]
+    ch_offset_ns: Optional[List[int]] = None
+
+
+@dataclass
+class Drop:
+    total: int
+
+
+@dataclass
+class Event:
+    seq: int
+    ch: int
+    type: int
+    raw: int
+
+    @property
+    def type_name(self) -> str:
+        return EVENT_TYPES.get(self.type, str(self.type))
+
+
+@dataclass
+class CaptureInfo:
+    ch: int
+    resolution: int
+    ref_mv: int
+    samples: int
+    trigger_index: int
+    interval_ns: int
+
+
+@dataclass
+class CaptureData:
+    index: int
+    raw: List[int]
+
+
+@dataclass
+class ChanStats:
+    count: int
+    min: int
+    max: int
+    mean: int
+    rms: int
+
+
+@dataclass
+class Stats:
+    duration_ms: int
+    ch: List[ChanStats]
+
+
+class ProtocolError(ValueError):
+    """A packet passed its CRC but does not match the layout."""
+
+
+class MissingReference(ProtocolError):
+    """A DELTA frame arrived without the frame it is coded against."""
+
+
+def decode_packet(ptype: int, flags: int, payload: bytes, prev: Optional[Frame] = None):
+    """
+    Decode one CRC-checked payload; unknown types return None.
+
+    A FRAME with FLAG_DELTA needs prev, the FRAME packet decoded just
+    before it, to be its predecessor in seq.
+    """
+    if ptype == PKT_INFO:
+        version, num_ch, resolution, _, ref_mv, period_us = struct.unpack_from(
+            "<BBBBHI", payload)
+        return Info(version, num_ch, resolution, ref_mv, period_us)
+
+    if ptype == PKT_FRAME and flags & FLAG_DELTA:
+        if prev is None:
+            raise MissingReference("DELTA frame without its predecessor")
+        seq, pos = varint_get(payload, 0)
+        if seq != (prev.seq + 1) & 0xFFFFFFFF:
+            raise MissingReference(f"DELTA frame {seq} after frame {prev.seq}")
+        step, pos = varint_get(payload, pos)
+        timestamp_ns = (prev.timestamp_ns + unzigzag(step)) & 0xFFFFFFFFFFFFFFFF
+        raw, pos = delta_decode(payload, pos, prev.raw)
+        num_ch = len(raw)
+    elif ptype == PKT_FRAME:
+        seq, timestamp_ns, num_ch = struct.unpack_from("<IQB", payload)
+        pack12 = bool(flags & FLAG_PACK12)
+        pos = FRAME_FIXED_SIZE
+        size = values_size(num_ch, pack12)
+        if len(payload) < pos + size:
+            raise ProtocolError("short FRAME payload")
+        if pack12:
+            raw = unpack12(payload[pos:pos + size], num_ch)
+        else:
+            raw = list(struct.unpack_from(f"<{num_ch}H", payload, pos))
+        pos += size
+
+    if ptype == PKT_FRAME:
+        offsets = None
+        if flags & FLAG_CH_TIME:
+            offsets = list(struct.unpack_from(f"<{num_ch}I", payload, pos))
+        return Frame(seq, timestamp_ns, bool(flags & FLAG_SYNCED), raw, offsets)
+
+    if ptype == PKT_DROP:
+        return Drop(*struct.unpack_from("<I", payload))
+
+    if ptype == PKT_EVENT:
+        return Event(*struct.unpack_from("<IBBH", payload))
+
+    if ptype == PKT_CAPTURE_INFO:
+        return CaptureInfo(*struct.unpack_from("<BBHIII", payload))
+
+    if ptype == PKT_CAPTURE_DATA:
+        (index,) = struct.unpack_from("<I", payload)
+        count = (len(payload) - CAPTURE_DATA_FIXED_SIZE) // 2
+        return CaptureData(index, list(struct.unpack_from(f"<{count}H", payload,
+                                                          CAPTURE_DATA_FIXED_SIZE)))
+
+    if ptype == PKT_STATS:
+        duration_ms, num_ch = struct.unpack_from("<IB", payload)
+        chans = []
+        for i in range(num_ch):
+            off = STATS_FIXED_SIZE + i * STATS_CH_SIZE
+            chans.append(ChanStats(*struct.unpack_from("<IHHHH", payload, off)))
+        return Stats(duration_ms, chans)
+
+    return None
+
+
+@dataclass
+class DecoderStats:
+    packets: int = 0
+    crc_errors: int = 0
+    skipped_bytes: int = 0
+    unknown: int = 0
+    no_reference: int = 0  # DELTA frames skipped for a lost predecessor
+
+
+class StreamDecoder:
+    """
+    Incremental packet decoder.
+
+    Feed it whatever the port returns; it keeps partial packets between
+    calls and resynchronizes on the next A5 5A after a CRC error. Any
+    lost bytes may have held a frame, so DELTA frames after them are
+    skipped until the next whole frame.
+    """
+
+    def __init__(self):
+        self._buf = bytearray()
+        self._prev: Optional[Frame] = None
+        self.stats = DecoderStats()
+
+    def feed(self, data: bytes) -> List[object]:
+        """Append bytes and return the packets completed by them."""
+        self._buf += data
+        buf = self._buf
+        packets = []
+        pos = 0
+
+        while True:
+            start = buf.find(SYNC, pos)
+            if start < 0:
+                # Keep a trailing A5 that may start the next sync word
+                keep = 1 if pos < len(buf) and buf[-1] == SYNC[0] else 0
+                self._skip(len(buf) - pos - keep)
+                pos = len(buf) - keep
+                break
+            self._skip(start - pos)
+            pos = start
+
+            if len(buf) - pos < HDR_SIZE:
+                break
+            ptype, flags, length = struct.unpack_from("<BBH", buf, pos + 2)
+            if length > MAX_PAYLOAD:
+                self.stats.crc_errors += 1
+                self._prev = None
+                pos += 1
+                continue
+            end = pos + HDR_SIZE + length + CRC_SIZE
+            if len(buf) < end:
+                break
+
+            (crc,) = struct.unpack_from("<H", buf, end - CRC_SIZE)
+            if crc16(bytes(buf[pos + 2:end - CRC_SIZE])) != crc:
+                self.stats.crc_errors += 1
+                self._prev = None
+                pos += 1
+                continue
+
+            payload = bytes(buf[pos + HDR_SIZE:end - CRC_SIZE])
+            pos = end
+            self.stats.packets += 1
+            try:
+                pkt = decode_packet(ptype, flags, payload, self._prev)
+            except MissingReference:
+                self.stats.no_reference += 1
+                continue
+            except (struct.error, ProtocolError):
+                self.stats.crc_errors += 1
+                if ptype == PKT_FRAME:
+                    self._prev = None
+                continue
+            if pkt is None:
+                self.stats.unknown += 1
+                continue
+            if isinstance(pkt, Frame):
+                self._prev = pkt
+            packets.append(pkt)
+
+        del buf[:pos]
+        return packets
+
+    def _skip(self, count: int) -> None:
+        if count > 0:
+            self.stats.skipped_bytes += count
+            self._prev = None
+
+
+@dataclass
+class FrameRecorder:
+    """Collects Frame packets and reports sequence gaps."""
+
+    seq: List[int] = field(default_factory=list)
+    timestamp_ns: List[int] = field(default_factory=list)
+    synced: List[bool] = field(default_factory=list)
+    raw: List[List[int]] = field(default_factory=list)
+    ch_offset_ns: List[List[int]] = field(default_factory=list)
+    gaps: int = 0
+    missing: int = 0
+
+    def add(self, frame: Frame) -> None:
+        if self.seq and frame.seq != (self.seq[-1] + 1) & 0xFFFFFFFF:
+            self.gaps += 1
+            self.missing += (frame.seq - self.seq[-1] - 1) & 0xFFFFFFFF
+        self.seq.append(frame.seq)
+        self.timestamp_ns.append(frame.timestamp_ns)
+        self.synced.append(frame.synced)
+        self.raw.append(frame.raw)
+        if frame.ch_offset_ns is not None:
+            self.ch_offset_ns.append(frame.ch_offset_ns)
+
+    def __len__(self) -> int:
+        return len(self.seq)
+
+    def to_numpy(self) -> dict:
+        """Arrays keyed by column: raw is frames x channels."""
+        import numpy as np
+
+        arrays = {
+            "seq": np.asarray(self.seq, dtype=np.uint32),
+            "timestamp_ns": np.asarray(self.timestamp_ns, dtype=np.uint64),
+            "synced": np.asarray(self.synced, dtype=bool),
+            "raw": np.asarray(self.raw, dtype=np.uint16),
+        }
+        if self.ch_offset_ns and len(self.ch_offset_ns) == len(self.seq):
+            arrays["ch_offset_ns"] = np.asarray(self.ch_offset_ns, dtype=np.uint32)
+        return arrays
+
+    def save(self, path: str) -> None:
+        """Write .parquet (one column per channel) or .npz."""
+        arrays = self.to_numpy()
+        if path.endswith(".parquet"):
+            import pyarrow as pa
+            import pyarrow.parquet as pq
+
+            columns = {k: arrays[k] for k in ("seq", "timestamp_ns", "synced")}
+            for ch in range(arrays["raw"].shape[1] if len(self) else 0):
+                columns[f"ch{ch}"] = arrays["raw"][:, ch]
+            pq.write_table(pa.table(columns), path)
+        else:
+            import numpy as np
+
+            np.savez(path, **arrays)
+
+
+@dataclass
+class Capture:
+    """Packets and frame rate from one read session."""
+
+    recorder: FrameRecorder
+    decoder: DecoderStats
+    info: Optional[Info] = None
+    dropped: int = 0
+    events: List[Event] = field(default_factory=list)
+    stats: List[Stats] = field(default_factory=list)
+    elapsed_s: float = 0.0
+    first_frame_s: Optional[float] = None  # Host time the first frame arrived
+    last_frame_s: Optional[float] = None
+
+    @property
+    def frames_per_s(self) -> float:
+        """Delivered rate: frames over their arrival span on the host."""
+        n = len(self.recorder)
+        if n < 2 or self.last_frame_s <= self.first_frame_s:
+            return 0.0
+        return (n - 1) / (self.last_frame_s - self.first_frame_s)
+
+    @property
+    def board_frames_per_s(self) -> float:
+        """Sampled rate from the board's own frame timestamps."""
+        ts = self.recorder.timestamp_ns
+        if len(ts) < 2 or ts[-1] <= ts[0]:
+            return 0.0
+        return (len(ts) - 1) * 1e9 / (ts[-1] - ts[0])
+
+
+def read_stream(port, seconds: float, chunk: int = 4096) -> Capture:
+    """
+    Decode everything a serial-like port delivers for a while.
+
+    Args:
+        port: Object with read(n) returning bytes (pyserial Serial)
+        seconds: How long to read
+        chunk: Bytes per read call
+    """
+    decoder = StreamDecoder()
+    cap = Capture(FrameRecorder(), decoder.stats)
+    start = time.monotonic()
+
+    while time.monotonic() - start < seconds:
+        packets = decoder.feed(port.read(chunk))
+        now = time.monotonic()
+        for pkt in packets:
+            if isinstance(pkt, Frame):
+                cap.recorder.add(pkt)
+                if cap.first_frame_s is None:
+                    cap.first_frame_s = now
+                cap.last_frame_s = now
+            elif isinstance(pkt, Info):
+                cap.info = pkt
+            elif isinstance(pkt, Drop):
+                cap.dropped = pkt.total
+            elif isinstance(pkt, Event):
+                cap.events.append(pkt)
+            elif isinstance(pkt, Stats):
+                cap.stats.append(pkt)
+
+    cap.elapsed_s = time.monotonic() - start
+    return cap
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description="Record the ADC Sampler binary stream")
+    parser.add_argument("port", help="Stream UART (e.g. /dev/ttyUSB0)")
+    parser.add_argument("--baud", type=int, default=921600)
+    parser.add_argument("--shell", help="Shell UART; sends 'adcstream start' and 'stop'")
+    parser.add_argument("--shell-baud", type=int, default=115200)
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--out", help="Output file, .parquet or .npz")
+    args = parser.parse_args(argv)
+
+    import serial
+
+    shell = serial.Serial(args.shell, args.shell_baud, timeout=1) if args.shell else None
+    port = serial.Serial(args.port, args.baud, timeout=0.05)
+    port.reset_input_buffer()
+    try:
+        if shell:
+            shell.write(b"adcstream start\r\n")
+        cap = read_stream(port, args.seconds)
+    finally:
+        if shell:
+            shell.write(b"adcstream stop\r\n")
+            shell.close()
+        port.close()
+
+    rec = cap.recorder
+    print(f"frames:      {len(rec)} in {cap.elapsed_s:.1f} s "
+          f"({cap.frames_per_s:.1f} frames/s delivered, "
+          f"{cap.board_frames_per_s:.1f} by board time)")
+    print(f"seq gaps:    {rec.gaps} ({rec.missing} frames missing)")
+    print(f"board drops: {cap.dropped}")
+    print(f"crc errors:  {cap.decoder.crc_errors}, skipped bytes: {cap.decoder.skipped_bytes}, "
+          f"unreferenced deltas: {cap.decoder.no_reference}")
+    if cap.info:
+        print(f"info:        v{cap.info.version}, {cap.info.num_ch} ch, "
+              f"{cap.info.resolution} bit, {cap.info.ref_mv} mV, {cap.info.period_us} us")
+
+    if args.out:
+        rec.save(args.out)
+        print(f"saved:       {args.out}")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())